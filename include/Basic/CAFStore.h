@@ -1,6 +1,7 @@
 #ifndef CAF_CAF_STORE_H
 #define CAF_CAF_STORE_H
 
+#include "Infrastructure/AliasTable.h"
 #include "Infrastructure/Optional.h"
 #include "Infrastructure/Random.h"
 #include "Basic/Function.h"
@@ -18,6 +19,10 @@ namespace caf {
 /**
  * @brief CAF metadata store.
  *
+ * Thread safety: once the store has been loaded and its weights have been set, all const member
+ * functions can be called concurrently from multiple threads. `Load`, `LoadWeights` and
+ * `SetFunctionWeight` must not run concurrently with any other member function.
+ *
  */
 class CAFStore {
 public:
@@ -41,7 +46,14 @@ public:
      * The constructed entry does not contain any functions.
      *
      */
-    explicit Entry() = default;
+    explicit Entry()
+      : _func(),
+        _parent(nullptr),
+        _children(),
+        _descendents(),
+        _weight(1.0),
+        _sampler()
+    { }
 
     Entry(const Entry &) = delete;
     Entry(Entry &&) noexcept = default;
@@ -80,24 +92,39 @@ public:
       return _descendents.size();
     }
 
+    /**
+     * @brief Get the sampling weight of the function contained in this entry.
+     *
+     * @return double the sampling weight.
+     */
+    double GetWeight() const { return _weight; }
+
     /**
      * @brief Randomly select a descendent that contains a function.
      *
-     * The selected entry is guaranteed to contain a function.
+     * The selected entry is guaranteed to contain a function. Descendents are selected with
+     * probabilities proportional to their weights, in O(1) time.
      *
      * @param rnd the random number generator to use.
      * @return Entry* the selected descendent entry.
      */
     Entry* SelectDescendent(Random<>& rnd) const {
-      return rnd.Select(_descendents);
+      if (_sampler.empty()) {
+        // All descendents have the same weight.
+        return rnd.Select(_descendents);
+      }
+      return _descendents[_sampler.Sample(rnd)];
     }
 
     friend class CAFStore;
 
   private:
     Optional<Function> _func;
+    Entry* _parent;
     std::unordered_map<std::string, std::unique_ptr<Entry>> _children;
     std::vector<Entry *> _descendents;
+    double _weight;
+    AliasTable _sampler;
 
     bool HasChild(const std::string& name) const;
 
@@ -106,6 +133,13 @@ public:
     Entry* GetChild(const std::string& name) const;
 
     void AddDescendent(Entry* entry);
+
+    /**
+     * @brief Rebuild the alias table used for selecting descendents from the current weights of
+     * the descendents.
+     *
+     */
+    void RebuildSampler();
   }; // class Entry
 
   /**
@@ -170,6 +204,13 @@ public:
   /**
    * @brief Load data from the given JSON container.
    *
+   * The JSON container should be an array. Each element of the array describes an API function and
+   * is either the name of the function, or an object with the following fields:
+   * * `name`: the name of the function;
+   * * `length`: optional, the arity of the function;
+   * * `ctor`: optional, whether the function is likely a constructor;
+   * * `native`: optional, whether the function is implemented natively by the target.
+   *
    * @param json the JSON container.
    */
   void Load(const nlohmann::json& json);
@@ -191,6 +232,30 @@ public:
    */
   void AddFunction(Function func);
 
+  /**
+   * @brief Set the sampling weight of the API function with the given ID.
+   *
+   * Only the alias tables of the entries on the path from the root entry to the function's entry
+   * are rebuilt. Weights are relative: by default every function has a weight of 1, and a weight of
+   * 0 excludes the function from being selected unless all its siblings have zero weight as well.
+   *
+   * @param id ID of the function.
+   * @param weight the new weight, which should be non-negative.
+   */
+  void SetFunctionWeight(FunctionIdType id, double weight);
+
+  /**
+   * @brief Load sampling weights from the given JSON container.
+   *
+   * The JSON container should be an object that maps entry names to weights, e.g.
+   * `{ "fs": 4, "fs.readFileSync": 0.5 }`. A weight assigned to an entry applies to all functions
+   * under that entry; weights of deeper entries override weights of their ancestors. Affected alias
+   * tables are rebuilt only once after all weights are applied.
+   *
+   * @param json the JSON container.
+   */
+  void LoadWeights(const nlohmann::json& json);
+
   /**
    * @brief Get the API function with the given ID.
    *
@@ -265,6 +330,14 @@ private:
   std::unordered_map<FunctionIdType, Entry *> _funcIdToEntry;
 
   std::unique_ptr<Entry> CreateEntry();
+
+  /**
+   * @brief Find the entry with the given name.
+   *
+   * @param name the name of the entry, whose components are separated by dots.
+   * @return Entry* the entry. Returns nullptr if no such entry exists.
+   */
+  Entry* FindEntry(const std::string& name) const;
 }; // class CAFStore
 
 } // namespace caf
@@ -1,6 +1,9 @@
 #ifndef CAF_FUNCTION_H
 #define CAF_FUNCTION_H
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 namespace caf {
@@ -24,9 +27,15 @@ public:
    * @param name name of the function.
    */
   explicit Function(uint64_t id, std::string name)
-    : _id(id), _name(std::move(name))
+    : _id(id), _name(std::move(name)), _arity(UnknownArity), _ctor(false), _native(false)
   { }
 
+  /**
+   * @brief Value of the arity of functions whose arity is unknown.
+   *
+   */
+  constexpr static const size_t UnknownArity = std::numeric_limits<size_t>::max();
+
   Function(const Function &) = delete;
   Function(Function &&) noexcept = default;
 
@@ -47,9 +56,66 @@ public:
    */
   const std::string& name() const { return _name; }
 
+  /**
+   * @brief Determine whether the arity of this function is known.
+   *
+   * @return true if the arity of this function is known.
+   * @return false if the arity of this function is unknown.
+   */
+  bool HasArity() const { return _arity != UnknownArity; }
+
+  /**
+   * @brief Get the arity of this function, i.e. the number of formal parameters that the function
+   * declares. This is the `length` property of the function object in JavaScript.
+   *
+   * @return size_t the arity of this function, or `UnknownArity` if the arity is unknown.
+   */
+  size_t arity() const { return _arity; }
+
+  /**
+   * @brief Set the arity of this function.
+   *
+   * @param arity the arity of this function.
+   */
+  void SetArity(size_t arity) { _arity = arity; }
+
+  /**
+   * @brief Determine whether this function is likely a constructor.
+   *
+   * @return true if this function is likely a constructor.
+   * @return false if this function is likely not a constructor.
+   */
+  bool IsConstructor() const { return _ctor; }
+
+  /**
+   * @brief Set whether this function is likely a constructor.
+   *
+   * @param ctor whether this function is likely a constructor.
+   */
+  void SetConstructor(bool ctor) { _ctor = ctor; }
+
+  /**
+   * @brief Determine whether this function is implemented natively by the target rather than in
+   * JavaScript.
+   *
+   * @return true if this function is a native function.
+   * @return false if this function is implemented in JavaScript.
+   */
+  bool IsNative() const { return _native; }
+
+  /**
+   * @brief Set whether this function is implemented natively by the target.
+   *
+   * @param native whether this function is a native function.
+   */
+  void SetNative(bool native) { _native = native; }
+
 private:
   FunctionIdType _id;
   std::string _name;
+  size_t _arity;
+  bool _ctor;
+  bool _native;
 }; // class Function
 
 } // namespace caf
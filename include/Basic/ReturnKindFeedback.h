@@ -0,0 +1,246 @@
+#ifndef CAF_RETURN_KIND_FEEDBACK_H
+#define CAF_RETURN_KIND_FEEDBACK_H
+
+#include "Basic/Function.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Name of the environment variable holding the path to the return kind feedback file.
+ *
+ */
+#define CAF_FEEDBACK_FILE_ENV "CAF_FEEDBACK_FILE"
+
+namespace caf {
+
+/**
+ * @brief Dynamic kinds of the outcome of an API function call observed in the target.
+ *
+ */
+enum class ReturnKind : uint8_t {
+  Undefined,
+  Primitive,
+  Object,
+  Function,
+  Threw,
+
+  // Sentinel values. Do not record them.
+  Count,
+  Unknown = Count,
+}; // enum class ReturnKind
+
+/**
+ * @brief Per-function counters of the return kinds of API function calls, shared between the target
+ * and the fuzzer through a memory-mapped file.
+ *
+ * The target records the kind of the return value of every call it makes; the fuzzer reads the
+ * counters to bias placeholder values and `this` values towards calls that actually produce
+ * objects. Counters are updated with relaxed atomic operations so several target processes can share
+ * a single file. Readers may observe slightly stale counts, which is fine for sampling.
+ *
+ * Thread safety: all member functions can be called concurrently from multiple threads.
+ *
+ */
+class ReturnKindFeedback {
+public:
+  ReturnKindFeedback(const ReturnKindFeedback &) = delete;
+  ReturnKindFeedback(ReturnKindFeedback &&) = delete;
+
+  ReturnKindFeedback& operator=(const ReturnKindFeedback &) = delete;
+  ReturnKindFeedback& operator=(ReturnKindFeedback &&) = delete;
+
+  ~ReturnKindFeedback() {
+    munmap(_header, _mappedSize);
+  }
+
+  /**
+   * @brief Create a new zeroed feedback file at the given path, overwriting any existing file.
+   *
+   * @param path path to the feedback file.
+   * @param funcsCount the number of API functions. Function IDs should be less than this value.
+   * @return std::unique_ptr<ReturnKindFeedback> the feedback object, or nullptr on failure.
+   */
+  static std::unique_ptr<ReturnKindFeedback> Create(const char* path, size_t funcsCount) {
+    auto fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+      return nullptr;
+    }
+
+    auto size = GetMappedSize(funcsCount);
+    if (ftruncate(fd, static_cast<off_t>(size)) == -1) {
+      close(fd);
+      return nullptr;
+    }
+
+    auto feedback = Map(fd, size);
+    close(fd);
+    if (feedback) {
+      feedback->_header->Magic = Magic;
+      feedback->_header->FunctionsCount = static_cast<uint32_t>(funcsCount);
+    }
+    return feedback;
+  }
+
+  /**
+   * @brief Open an existing feedback file.
+   *
+   * @param path path to the feedback file.
+   * @return std::unique_ptr<ReturnKindFeedback> the feedback object, or nullptr on failure.
+   */
+  static std::unique_ptr<ReturnKindFeedback> Open(const char* path) {
+    auto fd = open(path, O_RDWR);
+    if (fd == -1) {
+      return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+      close(fd);
+      return nullptr;
+    }
+
+    auto feedback = Map(fd, static_cast<size_t>(st.st_size));
+    close(fd);
+    if (!feedback) {
+      return nullptr;
+    }
+
+    auto header = feedback->_header;
+    if (header->Magic != Magic ||
+        GetMappedSize(header->FunctionsCount) > feedback->_mappedSize) {
+      return nullptr;
+    }
+    return feedback;
+  }
+
+  /**
+   * @brief Open the feedback file specified by the `CAF_FEEDBACK_FILE` environment variable.
+   *
+   * @return std::unique_ptr<ReturnKindFeedback> the feedback object, or nullptr if the environment
+   * variable is not set or the file cannot be opened.
+   */
+  static std::unique_ptr<ReturnKindFeedback> OpenFromEnv() {
+    auto path = std::getenv(CAF_FEEDBACK_FILE_ENV);
+    if (!path) {
+      return nullptr;
+    }
+    return Open(path);
+  }
+
+  /**
+   * @brief Get the number of API functions covered by this feedback.
+   *
+   * @return size_t the number of API functions.
+   */
+  size_t GetFunctionsCount() const { return _header->FunctionsCount; }
+
+  /**
+   * @brief Record the return kind of a call to the given function. Calls to functions out of range
+   * are ignored.
+   *
+   * @param funcId ID of the callee function.
+   * @param kind the observed return kind.
+   */
+  void Record(FunctionIdType funcId, ReturnKind kind) {
+    if (funcId >= GetFunctionsCount() || kind >= ReturnKind::Count) {
+      return;
+    }
+
+    auto counter = GetCounter(funcId, kind);
+    // Stop counting before the counter wraps around, the ratios are all that matter.
+    if (__atomic_load_n(counter, __ATOMIC_RELAXED) < MaxCount) {
+      __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+    }
+  }
+
+  /**
+   * @brief Get the number of calls to the given function that produced the given return kind.
+   *
+   * @param funcId ID of the callee function.
+   * @param kind the return kind.
+   * @return uint32_t the number of calls.
+   */
+  uint32_t GetCount(FunctionIdType funcId, ReturnKind kind) const {
+    if (funcId >= GetFunctionsCount() || kind >= ReturnKind::Count) {
+      return 0;
+    }
+    return __atomic_load_n(GetCounter(funcId, kind), __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Get the number of recorded calls to the given function.
+   *
+   * @param funcId ID of the callee function.
+   * @return uint64_t the number of recorded calls.
+   */
+  uint64_t GetTotalCount(FunctionIdType funcId) const {
+    uint64_t total = 0;
+    for (size_t k = 0; k < KindsCount; ++k) {
+      total += GetCount(funcId, static_cast<ReturnKind>(k));
+    }
+    return total;
+  }
+
+  /**
+   * @brief Estimate the probability that a call to the given function produces an object or a
+   * function. Functions without recorded calls get an estimation of 0.5.
+   *
+   * @param funcId ID of the callee function.
+   * @return double the estimated probability.
+   */
+  double GetObjectRate(FunctionIdType funcId) const {
+    auto objects = static_cast<uint64_t>(GetCount(funcId, ReturnKind::Object)) +
+                   GetCount(funcId, ReturnKind::Function);
+    auto total = GetTotalCount(funcId);
+    // Laplace smoothing.
+    return static_cast<double>(objects + 1) / static_cast<double>(total + 2);
+  }
+
+private:
+  struct Header {
+    uint32_t Magic;
+    uint32_t FunctionsCount;
+  }; // struct Header
+
+  constexpr static const uint32_t Magic = 0x46524143; // "CARF"
+  constexpr static const uint32_t MaxCount = 0x7fffffff;
+  constexpr static const size_t KindsCount = static_cast<size_t>(ReturnKind::Count);
+
+  Header* _header;
+  uint32_t* _counters;
+  size_t _mappedSize;
+
+  explicit ReturnKindFeedback(void* base, size_t mappedSize)
+    : _header(reinterpret_cast<Header *>(base)),
+      _counters(reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(base) + sizeof(Header))),
+      _mappedSize(mappedSize)
+  { }
+
+  static size_t GetMappedSize(size_t funcsCount) {
+    return sizeof(Header) + funcsCount * KindsCount * sizeof(uint32_t);
+  }
+
+  static std::unique_ptr<ReturnKindFeedback> Map(int fd, size_t size) {
+    auto base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+      return nullptr;
+    }
+    return std::unique_ptr<ReturnKindFeedback>(new ReturnKindFeedback(base, size));
+  }
+
+  uint32_t* GetCounter(FunctionIdType funcId, ReturnKind kind) const {
+    return _counters + static_cast<size_t>(funcId) * KindsCount + static_cast<size_t>(kind);
+  }
+}; // class ReturnKindFeedback
+
+} // namespace caf
+
+#endif
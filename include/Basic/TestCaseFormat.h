@@ -0,0 +1,109 @@
+#ifndef CAF_TEST_CASE_FORMAT_H
+#define CAF_TEST_CASE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caf {
+
+/**
+ * @brief Versions of the test case binary format. See `docs/TestCaseBinaryFormat.txt` for details.
+ *
+ */
+enum class TestCaseFormatVersion : uint8_t {
+  /**
+   * @brief The original format without header, in which all integers are fixed-width.
+   *
+   */
+  V1 = 1,
+
+  /**
+   * @brief The compact format with a magic header, in which integers are LEB128 varints.
+   *
+   */
+  V2 = 2,
+}; // enum class TestCaseFormatVersion
+
+/**
+ * @brief The format version written by default.
+ *
+ */
+constexpr static const TestCaseFormatVersion LatestTestCaseFormatVersion = TestCaseFormatVersion::V2;
+
+/**
+ * @brief Size of the test case header in bytes. A v1 test case has no header, but its first field,
+ * the 4-byte root entry index, occupies the same bytes.
+ *
+ */
+constexpr static const size_t TestCaseHeaderSize = 4;
+
+/**
+ * @brief Write the header of the given format version into the given buffer.
+ *
+ * @param version the format version. Must not be `TestCaseFormatVersion::V1`.
+ * @param header the buffer to hold the header.
+ */
+inline void MakeTestCaseHeader(TestCaseFormatVersion version, uint8_t (&header)[TestCaseHeaderSize]) {
+  header[0] = 'C';
+  header[1] = 'A';
+  header[2] = 'F';
+  header[3] = static_cast<uint8_t>(version);
+}
+
+/**
+ * @brief Detect the format version of a test case from its first `TestCaseHeaderSize` bytes.
+ *
+ * @param header the first `TestCaseHeaderSize` bytes of the test case.
+ * @return TestCaseFormatVersion the detected format version. If the given bytes are not a valid
+ * header, the test case is considered in v1 format.
+ */
+inline TestCaseFormatVersion DetectTestCaseFormat(const uint8_t (&header)[TestCaseHeaderSize]) {
+  if (header[0] == 'C' && header[1] == 'A' && header[2] == 'F' &&
+      header[3] == static_cast<uint8_t>(TestCaseFormatVersion::V2)) {
+    return TestCaseFormatVersion::V2;
+  }
+  return TestCaseFormatVersion::V1;
+}
+
+/**
+ * @brief In the v2 format, the low bits of the tag byte of a value hold the value kind and the high
+ * bits hold a small payload, which is the value of boolean values.
+ *
+ */
+constexpr static const uint8_t ValueTagKindMask = 0x0F;
+constexpr static const unsigned ValueTagPayloadShift = 4;
+
+/**
+ * @brief Make a v2 value tag byte.
+ *
+ * @param kind the value kind.
+ * @param payload the small payload. Must fit in the high bits of the tag.
+ * @return uint8_t the tag byte.
+ */
+inline uint8_t MakeValueTag(uint8_t kind, uint8_t payload = 0) {
+  return static_cast<uint8_t>((kind & ValueTagKindMask) | (payload << ValueTagPayloadShift));
+}
+
+/**
+ * @brief Get the value kind in the given v2 value tag byte.
+ *
+ * @param tag the tag byte.
+ * @return uint8_t the value kind.
+ */
+inline uint8_t GetValueTagKind(uint8_t tag) {
+  return tag & ValueTagKindMask;
+}
+
+/**
+ * @brief Get the small payload in the given v2 value tag byte.
+ *
+ * @param tag the tag byte.
+ * @return uint8_t the small payload.
+ */
+inline uint8_t GetValueTagPayload(uint8_t tag) {
+  return tag >> ValueTagPayloadShift;
+}
+
+} // namespace caf
+
+#endif
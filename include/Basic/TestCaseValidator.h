@@ -0,0 +1,309 @@
+#ifndef CAF_TEST_CASE_VALIDATOR_H
+#define CAF_TEST_CASE_VALIDATOR_H
+
+#include "Infrastructure/BufferReader.h"
+#include "Infrastructure/Varint.h"
+#include "Basic/TestCaseFormat.h"
+#include "Basic/ValueKind.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace caf {
+
+/**
+ * @brief Errors found by TestCaseValidator.
+ *
+ */
+enum class TestCaseValidationError : uint8_t {
+  None,
+  Truncated,
+  BadValueKind,
+  BadBoolean,
+  BadConstructorFlag,
+  BadPlaceholderIndex,
+  IntegerOverflow,
+  TooDeep,
+}; // enum class TestCaseValidationError
+
+/**
+ * @brief Get a human readable message of the given validation error.
+ *
+ * @param error the validation error.
+ * @return const char* the message.
+ */
+inline const char* GetTestCaseValidationErrorMessage(TestCaseValidationError error) {
+  switch (error) {
+    case TestCaseValidationError::None: return "no error";
+    case TestCaseValidationError::Truncated: return "unexpected end of test case";
+    case TestCaseValidationError::BadValueKind: return "bad value kind";
+    case TestCaseValidationError::BadBoolean: return "bad boolean value";
+    case TestCaseValidationError::BadConstructorFlag: return "bad constructor call flag";
+    case TestCaseValidationError::BadPlaceholderIndex: return "placeholder index out of range";
+    case TestCaseValidationError::IntegerOverflow: return "integer out of range";
+    case TestCaseValidationError::TooDeep: return "arrays nested too deeply";
+    default: return "unknown error";
+  }
+}
+
+/**
+ * @brief Validate serialized test cases without deserializing them.
+ *
+ * The validator walks the serialized test case once, in O(size) time and without allocating memory
+ * unless function IDs are collected. It checks that all reads stay within the buffer, that value
+ * kinds, booleans and constructor call flags are well formed, that integers fit their fields, that
+ * placeholders only refer to values that precede them and do not refer to an array enclosing the
+ * placeholder, and that arrays are not nested more deeply than a limit. Test cases accepted by the
+ * validator can be deserialized and parsed without reading out of bounds or building cyclic values.
+ *
+ * Function IDs are not checked since the validator does not know the set of available functions.
+ *
+ */
+class TestCaseValidator {
+public:
+  /**
+   * @brief Default maximum nesting level of arrays, which is also the largest supported limit.
+   *
+   */
+  constexpr static const size_t DefaultMaxDepth = 32;
+
+  /**
+   * @brief Construct a new TestCaseValidator object.
+   *
+   * @param maxDepth maximum nesting level of arrays. Larger values are clamped to `DefaultMaxDepth`.
+   */
+  explicit TestCaseValidator(size_t maxDepth = DefaultMaxDepth)
+    : _maxDepth(maxDepth < DefaultMaxDepth ? maxDepth : DefaultMaxDepth),
+      _data(nullptr),
+      _reader(nullptr, 0),
+      _version(LatestTestCaseFormatVersion),
+      _indexesCount(0),
+      _funcIds(nullptr),
+      _openArrays(),
+      _error(TestCaseValidationError::None)
+  { }
+
+  /**
+   * @brief Validate the serialized test case at the beginning of the given buffer.
+   *
+   * @param data pointer to the buffer.
+   * @param size size of the buffer, in bytes.
+   * @param funcIds if not null, the IDs of the called functions and of the function values in the
+   * test case are appended to this vector, possibly with duplicates.
+   * @return true if the test case is valid.
+   * @return false if the test case is malformed.
+   */
+  bool Validate(const uint8_t* data, size_t size, std::vector<uint32_t>* funcIds = nullptr) {
+    _data = data;
+    _reader = BufferReader { data, size };
+    _indexesCount = 0;
+    _funcIds = funcIds;
+    _error = TestCaseValidationError::None;
+    ValidateTestCase();
+    if (_reader.fail() && _error == TestCaseValidationError::None) {
+      _error = TestCaseValidationError::Truncated;
+    }
+    return _error == TestCaseValidationError::None;
+  }
+
+  /**
+   * @brief Get the error found by the last validation.
+   *
+   * @return TestCaseValidationError the error.
+   */
+  TestCaseValidationError GetError() const { return _error; }
+
+  /**
+   * @brief Get the offset in the buffer at which the last validation stopped. If the test case is
+   * valid, this is the size of the test case.
+   *
+   * @return size_t the offset, in bytes.
+   */
+  size_t GetOffset() const { return static_cast<size_t>(_reader.position() - _data); }
+
+private:
+  size_t _maxDepth;
+  const uint8_t* _data; // The buffer being validated.
+  BufferReader _reader;
+  TestCaseFormatVersion _version;
+  uint64_t _indexesCount; // Number of array values and return values seen so far.
+  std::vector<uint32_t>* _funcIds; // Receives the function IDs seen, if not null.
+  std::array<uint64_t, DefaultMaxDepth> _openArrays; // Indexes of the enclosing arrays, by depth.
+  TestCaseValidationError _error;
+
+  bool Fail(TestCaseValidationError error) {
+    if (_error == TestCaseValidationError::None) {
+      _error = error;
+    }
+    return false;
+  }
+
+  bool ok() const { return _error == TestCaseValidationError::None && !_reader.fail(); }
+
+  bool ReadUInt(uint64_t max, uint64_t& value) {
+    if (_version == TestCaseFormatVersion::V1) {
+      value = _reader.ReadUnaligned<uint32_t>();
+    } else {
+      value = ReadVarint(_reader);
+    }
+    if (value > max) {
+      return Fail(TestCaseValidationError::IntegerOverflow);
+    }
+    return ok();
+  }
+
+  bool ReadCount(uint64_t& count) {
+    if (!ReadUInt(UINT32_MAX, count)) {
+      return false;
+    }
+    // Every counted item takes at least one byte, so larger counts must be truncated.
+    if (count > _reader.remaining()) {
+      return Fail(TestCaseValidationError::Truncated);
+    }
+    return true;
+  }
+
+  bool ReadFunctionId() {
+    uint64_t funcId;
+    if (!ReadUInt(UINT32_MAX, funcId)) {
+      return false;
+    }
+    if (_funcIds) {
+      _funcIds->push_back(static_cast<uint32_t>(funcId));
+    }
+    return true;
+  }
+
+  void ValidateTestCase() {
+    uint8_t header[TestCaseHeaderSize];
+    _reader.Read(header, sizeof(header));
+    _version = DetectTestCaseFormat(header);
+
+    uint64_t value;
+    if (_version != TestCaseFormatVersion::V1 && !ReadUInt(UINT32_MAX, value)) {
+      return;
+    }
+
+    uint64_t callsCount;
+    if (!ReadCount(callsCount)) {
+      return;
+    }
+    for (uint64_t i = 0; i < callsCount; ++i) {
+      if (!ValidateCall()) {
+        return;
+      }
+      ++_indexesCount;
+    }
+  }
+
+  bool ValidateCall() {
+    if (!ReadFunctionId() || !ValidateValue(0)) {
+      return false;
+    }
+
+    auto isCtor = _reader.ReadByte();
+    if (isCtor > 1) {
+      return Fail(TestCaseValidationError::BadConstructorFlag);
+    }
+
+    uint64_t argsCount;
+    if (!ReadCount(argsCount)) {
+      return false;
+    }
+    for (uint64_t i = 0; i < argsCount; ++i) {
+      if (!ValidateValue(0)) {
+        return false;
+      }
+    }
+    return ok();
+  }
+
+  bool ValidateValue(size_t depth) {
+    auto tag = _reader.ReadByte();
+    if (!ok()) {
+      return false;
+    }
+
+    if (_version != TestCaseFormatVersion::V1) {
+      auto payload = GetValueTagPayload(tag);
+      tag = GetValueTagKind(tag);
+      if (tag == static_cast<uint8_t>(ValueKind::Boolean)) {
+        return payload <= 1 ? true : Fail(TestCaseValidationError::BadBoolean);
+      }
+      if (payload) {
+        return Fail(TestCaseValidationError::BadValueKind);
+      }
+    }
+
+    if (tag >= ValueKindsCount) {
+      return Fail(TestCaseValidationError::BadValueKind);
+    }
+
+    uint64_t value;
+    switch (static_cast<ValueKind>(tag)) {
+      case ValueKind::Undefined:
+      case ValueKind::Null:
+        return true;
+      case ValueKind::Boolean:
+        return _reader.ReadByte() <= 1 ? ok() : Fail(TestCaseValidationError::BadBoolean);
+      case ValueKind::String: {
+        if (!ReadUInt(UINT32_MAX, value)) {
+          return false;
+        }
+        _reader.ReadBytes(static_cast<size_t>(value));
+        return ok();
+      }
+      case ValueKind::Function:
+        return ReadFunctionId();
+      case ValueKind::Integer:
+        if (_version == TestCaseFormatVersion::V1) {
+          _reader.ReadUnaligned<int32_t>();
+          return ok();
+        }
+        // Zig-zag encoded 32-bit integers fit in 32 bits.
+        return ReadUInt(UINT32_MAX, value);
+      case ValueKind::Float:
+        _reader.ReadUnaligned<double>();
+        return ok();
+      case ValueKind::Array: {
+        if (depth >= _maxDepth) {
+          return Fail(TestCaseValidationError::TooDeep);
+        }
+        uint64_t size;
+        if (!ReadCount(size)) {
+          return false;
+        }
+        _openArrays[depth] = _indexesCount++;
+        for (uint64_t i = 0; i < size; ++i) {
+          if (!ValidateValue(depth + 1)) {
+            return false;
+          }
+        }
+        return true;
+      }
+      case ValueKind::Placeholder:
+        if (!ReadUInt(UINT32_MAX, value)) {
+          return false;
+        }
+        if (value >= _indexesCount) {
+          return Fail(TestCaseValidationError::BadPlaceholderIndex);
+        }
+        // An array cannot contain itself.
+        for (size_t i = 0; i < depth; ++i) {
+          if (_openArrays[i] == value) {
+            return Fail(TestCaseValidationError::BadPlaceholderIndex);
+          }
+        }
+        return true;
+      default:
+        return Fail(TestCaseValidationError::BadValueKind);
+    }
+  }
+}; // class TestCaseValidator
+
+} // namespace caf
+
+#endif
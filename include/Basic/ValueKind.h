@@ -1,6 +1,7 @@
 #ifndef CAF_VALUE_KIND_H
 #define CAF_VALUE_KIND_H
 
+#include <cstddef>
 #include <cstdint>
 
 namespace caf {
@@ -29,6 +30,31 @@ enum class ValueKind : uint8_t {
 #undef DECL_ENUMERATOR
 }; // enum class ValueKind
 
+/**
+ * @brief The number of value kinds.
+ *
+ */
+constexpr static const size_t ValueKindsCount = 0
+#define COUNT_ENUMERATOR(name) + 1
+  CAF_VALUE_KIND_LIST(COUNT_ENUMERATOR)
+#undef COUNT_ENUMERATOR
+  ;
+
+/**
+ * @brief Get the name of the given value kind.
+ *
+ * @param kind the value kind.
+ * @return const char* the name of the value kind.
+ */
+inline const char* GetValueKindName(ValueKind kind) {
+  switch (kind) {
+#define DECL_CASE(name) case ValueKind::name: return #name;
+    CAF_VALUE_KIND_LIST(DECL_CASE)
+#undef DECL_CASE
+    default: return "Unknown";
+  }
+}
+
 } // namespace caf
 
 #endif
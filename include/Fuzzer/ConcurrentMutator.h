@@ -0,0 +1,129 @@
+#ifndef CAF_CONCURRENT_MUTATOR_H
+#define CAF_CONCURRENT_MUTATOR_H
+
+#include "Fuzzer/TestCaseMutator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace caf {
+
+class CAFStore;
+class ReturnKindFeedback;
+
+/**
+ * @brief Mutate serialized test cases on multiple worker threads.
+ *
+ * Each worker thread owns an ObjectPool, a Random and a TestCaseMutator; all workers share a single
+ * immutable CAFStore and, optionally, a ReturnKindFeedback. Every mutant is produced by an
+ * independent job whose random number generator is seeded from the job index, so the output only
+ * depends on the inputs and the seed and not on how jobs are scheduled on the workers.
+ *
+ * Thread safety: a ConcurrentMutator object itself is not thread-safe; `Mutate` should be called
+ * from one thread at a time. The CAF store must not be modified while `Mutate` is running.
+ *
+ */
+class ConcurrentMutator {
+public:
+  using Options = TestCaseMutator::Options;
+
+  /**
+   * @brief A serialized test case to mutate. The data is not copied.
+   *
+   */
+  struct Input {
+    const uint8_t* Data; // Pointer to the serialized test case.
+    size_t Size; // Size of the serialized test case, in bytes.
+  }; // struct Input
+
+  /**
+   * @brief Construct a new ConcurrentMutator object.
+   *
+   * @param store the CAF metadata store shared by all workers.
+   * @param threadsCount the number of worker threads. If this is 0, the number of hardware threads
+   * is used.
+   */
+  explicit ConcurrentMutator(const CAFStore& store, size_t threadsCount);
+
+  ConcurrentMutator(const ConcurrentMutator &) = delete;
+  ConcurrentMutator(ConcurrentMutator &&) = delete;
+
+  ~ConcurrentMutator();
+
+  /**
+   * @brief Get the options applied to the mutators of all workers.
+   *
+   * @return Options& the options.
+   */
+  Options& options() { return _opt; }
+
+  /**
+   * @brief Get the options applied to the mutators of all workers.
+   *
+   * @return const Options& the options.
+   */
+  const Options& options() const { return _opt; }
+
+  /**
+   * @brief Get the number of worker threads.
+   *
+   * @return size_t the number of worker threads.
+   */
+  size_t GetThreadsCount() const { return _workers.size(); }
+
+  /**
+   * @brief Set the return kind feedback shared by all workers.
+   *
+   * @param feedback the return kind feedback, or nullptr to disable feedback.
+   */
+  void SetFeedback(const ReturnKindFeedback* feedback);
+
+  /**
+   * @brief Enable or disable hash-consing in the object pools of all workers.
+   *
+   * @param enabled whether hash-consing should be enabled.
+   */
+  void SetHashConsingEnabled(bool enabled);
+
+  /**
+   * @brief Set the memory budget of the object pool of each worker.
+   *
+   * @param budget the memory budget in bytes, or 0 to remove the budget.
+   */
+  void SetPoolMemoryBudget(size_t budget);
+
+  /**
+   * @brief Mutate each of the given serialized test cases the given number of times.
+   *
+   * @param inputs the serialized test cases. Their data must stay valid until this function returns.
+   * @param mutantsCount the number of mutants to produce from each input.
+   * @param seed seed of the random number generators.
+   * @return std::vector<std::vector<uint8_t>> the serialized mutants. The j-th mutant of the i-th
+   * input is at index `i * mutantsCount + j`. Mutants of malformed inputs are empty.
+   */
+  std::vector<std::vector<uint8_t>> Mutate(
+      const std::vector<Input>& inputs, size_t mutantsCount, uint64_t seed);
+
+  /**
+   * @brief Mutate each of the given serialized test cases the given number of times.
+   *
+   * @param inputs the serialized test cases.
+   * @param mutantsCount the number of mutants to produce from each input.
+   * @param seed seed of the random number generators.
+   * @return std::vector<std::vector<uint8_t>> the serialized mutants, in the same order as above.
+   */
+  std::vector<std::vector<uint8_t>> Mutate(
+      const std::vector<std::vector<uint8_t>>& inputs, size_t mutantsCount, uint64_t seed);
+
+private:
+  class Worker;
+
+  Options _opt;
+  std::vector<std::unique_ptr<Worker>> _workers;
+}; // class ConcurrentMutator
+
+} // namespace caf
+
+#endif
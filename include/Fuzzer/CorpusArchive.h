@@ -0,0 +1,246 @@
+#ifndef CAF_CORPUS_ARCHIVE_H
+#define CAF_CORPUS_ARCHIVE_H
+
+#include "Infrastructure/StringView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace caf {
+
+class OutputStream;
+
+/**
+ * @brief A read-only corpus archive, which stores test cases as edit scripts against their parents.
+ *
+ * See `docs/CorpusArchiveFormat.txt` for the layout of archive files.
+ *
+ */
+class CorpusArchive {
+public:
+  /**
+   * @brief Value of the parent index of entries that are stored in full.
+   *
+   */
+  constexpr static const size_t NoParent = static_cast<size_t>(-1);
+
+  CorpusArchive(const CorpusArchive &) = delete;
+  CorpusArchive(CorpusArchive &&) noexcept = default;
+
+  CorpusArchive& operator=(const CorpusArchive &) = delete;
+  CorpusArchive& operator=(CorpusArchive &&) = default;
+
+  /**
+   * @brief Open the corpus archive at the given path.
+   *
+   * @param path path to the corpus archive file.
+   * @return std::unique_ptr<CorpusArchive> the corpus archive, or nullptr if the file cannot be read
+   * or is not a well-formed corpus archive.
+   */
+  static std::unique_ptr<CorpusArchive> Open(const char* path);
+
+  /**
+   * @brief Determine whether the file at the given path starts with the magic number of corpus
+   * archives.
+   *
+   * @param path path to the file.
+   * @return true if the file is a corpus archive.
+   * @return false if the file is not a corpus archive or cannot be read.
+   */
+  static bool IsCorpusArchive(const char* path);
+
+  /**
+   * @brief Get the number of entries in the archive.
+   *
+   * @return size_t the number of entries.
+   */
+  size_t size() const { return _entries.size(); }
+
+  /**
+   * @brief Get the name of the entry at the given index.
+   *
+   * @param index index of the entry.
+   * @return StringView the name of the entry.
+   */
+  StringView GetName(size_t index) const { return _entries[index].Name; }
+
+  /**
+   * @brief Get the index of the parent of the entry at the given index.
+   *
+   * @param index index of the entry.
+   * @return size_t index of the parent entry, or `NoParent` if the entry is stored in full.
+   */
+  size_t GetParent(size_t index) const { return _entries[index].Parent; }
+
+  /**
+   * @brief Get the size of the test case stored in the entry at the given index.
+   *
+   * @param index index of the entry.
+   * @return size_t the size of the reconstructed test case, in bytes.
+   */
+  size_t GetEntrySize(size_t index) const { return _entries[index].Size; }
+
+  /**
+   * @brief Reconstruct the test case stored in the entry at the given index.
+   *
+   * @param index index of the entry.
+   * @param out the buffer into which the serialized test case is written. Its previous content is
+   * discarded.
+   */
+  void Reconstruct(size_t index, std::vector<uint8_t>& out) const;
+
+private:
+  friend class CorpusArchiveWriter;
+
+  constexpr static const uint32_t Magic = 0x41464143; // "CAFA"
+  constexpr static const uint32_t Version = 1;
+  constexpr static const size_t HeaderSize = 8;
+
+  enum EditOp : uint8_t {
+    CopyOp = 0, // Copy a range of the parent.
+    InsertOp = 1, // Insert literal bytes.
+  }; // enum EditOp
+
+  struct Entry {
+    StringView Name;
+    size_t Parent; // Index of the parent entry, or NoParent.
+    size_t Size; // Size of the reconstructed test case.
+    size_t OpsCount; // Number of edit operations. Unused for entries stored in full.
+    const uint8_t* Payload; // Test case data or edit operations.
+    size_t PayloadSize;
+  }; // struct Entry
+
+  std::vector<uint8_t> _data;
+  std::vector<Entry> _entries;
+
+  explicit CorpusArchive(std::vector<uint8_t> data);
+
+  bool Parse();
+
+  bool ValidateEditScript(const Entry& entry) const;
+
+  static void ApplyEditScript(const Entry& entry, const std::vector<uint8_t>& parent,
+                              std::vector<uint8_t>& out);
+}; // class CorpusArchive
+
+/**
+ * @brief Build corpus archive files.
+ *
+ * Each added test case is stored either in full or as an edit script against an earlier entry. The
+ * parent of an entry named in AFL's convention (`id:NNNNNN,src:MMMMMM,...`) is the entry whose name
+ * starts with `id:MMMMMM`; the previous entry is also tried. The parent that gives the smallest
+ * encoding is used, unless storing the test case in full is smaller.
+ *
+ * Added test cases are not kept in memory: parents are reconstructed from the encoded entries when
+ * needed, except for the previous entry, whose data is cached.
+ *
+ */
+class CorpusArchiveWriter {
+public:
+  /**
+   * @brief Default maximum length of the parent chain of an entry.
+   *
+   */
+  constexpr static const size_t DefaultMaxChainDepth = 16;
+
+  /**
+   * @brief Construct a new CorpusArchiveWriter object.
+   *
+   * @param maxChainDepth maximum length of the parent chain of an entry. Longer chains save more
+   * space but take longer to reconstruct.
+   */
+  explicit CorpusArchiveWriter(size_t maxChainDepth = DefaultMaxChainDepth);
+
+  CorpusArchiveWriter(const CorpusArchiveWriter &) = delete;
+  CorpusArchiveWriter(CorpusArchiveWriter &&) noexcept = default;
+
+  /**
+   * @brief Use the entries of an existing archive as parents of the entries added later. The output
+   * of `Write` should be appended to the existing archive file.
+   *
+   * This function should be called before any entries are added. The archive must outlive the
+   * writer.
+   *
+   * @param archive the existing archive.
+   */
+  void AppendTo(const CorpusArchive& archive);
+
+  /**
+   * @brief Add an entry to the archive.
+   *
+   * @param name name of the entry.
+   * @param data pointer to the serialized test case.
+   * @param size size of the serialized test case, in bytes.
+   * @return true if the entry is added.
+   * @return false if the archive appended to already has an entry of the same name and content, in
+   * which case the entry is skipped.
+   */
+  bool AddEntry(StringView name, const uint8_t* data, size_t size);
+
+  /**
+   * @brief Get the number of entries added so far, excluding the entries of the archive appended to.
+   *
+   * @return size_t the number of entries.
+   */
+  size_t size() const { return _entries.size() - _baseCount; }
+
+  /**
+   * @brief Get the number of added entries that are stored as edit scripts.
+   *
+   * @return size_t the number of entries.
+   */
+  size_t GetDeltaEntriesCount() const { return _deltaCount; }
+
+  /**
+   * @brief Get the number of entries skipped because the archive appended to already has them.
+   *
+   * @return size_t the number of entries.
+   */
+  size_t GetSkippedEntriesCount() const { return _skippedCount; }
+
+  /**
+   * @brief Write the added entries to the given output stream. The archive header is written unless
+   * `AppendTo` has been called.
+   *
+   * @param out the output stream.
+   */
+  void Write(OutputStream& out) const;
+
+private:
+  struct Entry {
+    size_t Parent; // Index of the parent entry, or NoParent.
+    size_t Depth; // Length of the parent chain.
+    size_t Size; // Size of the test case.
+    size_t OpsCount; // Number of edit operations. Unused for entries stored in full.
+    size_t PayloadOffset; // Offset of the test case data or edit operations in `_output`.
+    size_t PayloadSize;
+  }; // struct Entry
+
+  size_t _maxChainDepth;
+  std::vector<Entry> _entries;
+  std::unordered_map<std::string, size_t> _aflIds; // AFL queue IDs to entry indexes.
+  std::unordered_map<std::string, size_t> _baseNames; // Names of base entries to entry indexes.
+  const CorpusArchive* _base; // The archive appended to, or nullptr.
+  size_t _baseCount; // Number of entries of the archive appended to.
+  size_t _deltaCount;
+  size_t _skippedCount;
+  size_t _previousIndex; // Index of the entry cached in `_previous`, or NoParent.
+  std::vector<uint8_t> _previous; // Data of the most recently added entry.
+  std::vector<uint8_t> _output; // Encoded added entries.
+  std::vector<uint8_t> _script; // Scratch buffer for edit scripts.
+
+  bool IsArchived(StringView name, const uint8_t* data, size_t size) const;
+
+  void Reconstruct(size_t index, std::vector<uint8_t>& out) const;
+
+  size_t EncodeEditScript(const std::vector<uint8_t>& parent, const uint8_t* data, size_t size,
+                          std::vector<uint8_t>& script) const;
+}; // class CorpusArchiveWriter
+
+} // namespace caf
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef CAF_CORPUS_PACK_H
+#define CAF_CORPUS_PACK_H
+
+#include "Infrastructure/StringView.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace caf {
+
+class OutputStream;
+
+/**
+ * @brief A read-only corpus pack file, which holds many serialized test cases in a single file.
+ *
+ * The pack file is memory-mapped, and the names and data of its entries point directly into the
+ * mapping. They stay valid for the lifetime of the CorpusPack object. See
+ * `docs/CorpusPackFormat.txt` for the layout of pack files.
+ *
+ */
+class CorpusPack {
+public:
+  /**
+   * @brief An entry in a corpus pack.
+   *
+   */
+  struct Entry {
+    StringView Name; // Name of the entry, usually the name of the file it was packed from.
+    const uint8_t* Data; // Pointer to the serialized test case.
+    size_t Size; // Size of the serialized test case, in bytes.
+  }; // struct Entry
+
+  CorpusPack(const CorpusPack &) = delete;
+  CorpusPack(CorpusPack &&) = delete;
+
+  CorpusPack& operator=(const CorpusPack &) = delete;
+  CorpusPack& operator=(CorpusPack &&) = delete;
+
+  ~CorpusPack();
+
+  /**
+   * @brief Open the corpus pack at the given path.
+   *
+   * @param path path to the corpus pack file.
+   * @return std::unique_ptr<CorpusPack> the corpus pack, or nullptr if the file cannot be opened or
+   * is not a well-formed corpus pack.
+   */
+  static std::unique_ptr<CorpusPack> Open(const char* path);
+
+  /**
+   * @brief Determine whether the file at the given path starts with the magic number of corpus
+   * packs.
+   *
+   * @param path path to the file.
+   * @return true if the file is a corpus pack.
+   * @return false if the file is not a corpus pack or cannot be read.
+   */
+  static bool IsCorpusPack(const char* path);
+
+  /**
+   * @brief Get the number of entries in the pack.
+   *
+   * @return size_t the number of entries.
+   */
+  size_t size() const { return _entriesCount; }
+
+  /**
+   * @brief Get the entry at the given index.
+   *
+   * @param index index of the entry.
+   * @return Entry the entry.
+   */
+  Entry GetEntry(size_t index) const;
+
+private:
+  friend class CorpusPackWriter;
+
+  struct Header {
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t EntriesCount;
+  }; // struct Header
+
+  struct IndexEntry {
+    uint64_t DataOffset;
+    uint64_t DataSize;
+    uint64_t NameOffset;
+    uint64_t NameSize;
+  }; // struct IndexEntry
+
+  constexpr static const uint32_t Magic = 0x50464143; // "CAFP"
+  constexpr static const uint32_t Version = 1;
+
+  const uint8_t* _base;
+  size_t _mappedSize;
+  const IndexEntry* _index;
+  size_t _entriesCount;
+
+  explicit CorpusPack(const uint8_t* base, size_t mappedSize);
+}; // class CorpusPack
+
+/**
+ * @brief Build corpus pack files.
+ *
+ */
+class CorpusPackWriter {
+public:
+  explicit CorpusPackWriter();
+
+  CorpusPackWriter(const CorpusPackWriter &) = delete;
+  CorpusPackWriter(CorpusPackWriter &&) noexcept = default;
+
+  /**
+   * @brief Add an entry to the pack.
+   *
+   * @param name name of the entry.
+   * @param data pointer to the serialized test case.
+   * @param size size of the serialized test case, in bytes.
+   */
+  void AddEntry(StringView name, const uint8_t* data, size_t size);
+
+  /**
+   * @brief Get the number of entries added so far.
+   *
+   * @return size_t the number of entries.
+   */
+  size_t size() const { return _entries.size(); }
+
+  /**
+   * @brief Write the pack to the given output stream.
+   *
+   * @param out the output stream.
+   */
+  void Write(OutputStream& out) const;
+
+private:
+  std::vector<CorpusPack::IndexEntry> _entries; // Offsets are relative to _names and _data.
+  std::string _names; // Concatenated names of all entries.
+  std::vector<uint8_t> _data; // Concatenated data of all entries.
+}; // class CorpusPackWriter
+
+} // namespace caf
+
+#endif
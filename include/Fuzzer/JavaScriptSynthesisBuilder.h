@@ -1,6 +1,7 @@
 #ifndef CAF_JAVASCRIPT_SYNTHESIS_BUILDER_H
 #define CAF_JAVASCRIPT_SYNTHESIS_BUILDER_H
 
+#include "Infrastructure/StringView.h"
 #include "Fuzzer/SynthesisBuilder.h"
 
 namespace caf {
@@ -52,7 +53,7 @@ protected:
       const std::string& receiverVarName,
       const std::vector<std::string>& argVarNames) override;
 
-  std::string EscapeString(const std::string& s) const;
+  std::string EscapeString(StringView s) const;
 
 private:
   const CAFStore& _store;
@@ -0,0 +1,78 @@
+#ifndef CAF_MUTATOR_STATISTICS_H
+#define CAF_MUTATOR_STATISTICS_H
+
+#include "Fuzzer/ObjectPool.h"
+
+#include "json/json.hpp"
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Name of the environment variable holding the path to the directory into which the AFL
+ * custom mutator writes its statistics files.
+ *
+ */
+#define CAF_MUTATOR_STATS_DIR_ENV "CAF_MUTATOR_STATS_DIR"
+
+/**
+ * @brief Name of the environment variable holding the memory budget of the object pool used by the
+ * AFL custom mutator, in megabytes.
+ *
+ */
+#define CAF_POOL_BUDGET_ENV "CAF_POOL_BUDGET"
+
+/**
+ * @brief Name of the environment variable holding the maximum number of times the AFL custom mutator
+ * mutates a test case again when the mutant duplicates a recently emitted test case. 0 disables
+ * duplicate suppression.
+ *
+ */
+#define CAF_DUPLICATE_RETRIES_ENV "CAF_DUPLICATE_RETRIES"
+
+namespace caf {
+
+/**
+ * @brief Statistics reported by the AFL custom mutator.
+ *
+ * Every mutator process periodically writes its statistics as a JSON file named
+ * `mutator-<pid>.json` in the directory specified by the `CAF_MUTATOR_STATS_DIR` environment
+ * variable. `caf stat` displays these files.
+ *
+ */
+struct MutatorStatistics {
+  explicit MutatorStatistics();
+
+  size_t MutationsCount; // Number of mutated test cases.
+  size_t SynthesisCount; // Number of synthesized test cases.
+  size_t RejectedCount; // Number of malformed test cases rejected by validation.
+  size_t DuplicatesCount; // Number of mutants discarded as duplicates of recent test cases.
+  ObjectPool::Statistics Pool; // Statistics of the object pool.
+
+  /**
+   * @brief Serialize this object to JSON form.
+   *
+   * @return nlohmann::json the JSON form.
+   */
+  nlohmann::json ToJson() const;
+
+  /**
+   * @brief Load the statistics from the given JSON form.
+   *
+   * @param json the JSON form.
+   * @return MutatorStatistics the statistics.
+   */
+  static MutatorStatistics FromJson(const nlohmann::json& json);
+
+  /**
+   * @brief Get the path to the statistics file of the current process in the given directory.
+   *
+   * @param dir path to the statistics directory.
+   * @return std::string path to the statistics file.
+   */
+  static std::string GetStatisticsFilePath(const std::string& dir);
+}; // struct MutatorStatistics
+
+} // namespace caf
+
+#endif
@@ -1,8 +1,10 @@
 #ifndef CAF_OBJECT_POOL_H
 #define CAF_OBJECT_POOL_H
 
+#include "Infrastructure/Arena.h"
 #include "Infrastructure/Memory.h"
 #include "Infrastructure/Random.h"
+#include "Infrastructure/StringView.h"
 #include "Basic/Function.h"
 #include "Fuzzer/Value.h"
 
@@ -13,14 +15,60 @@
 #include <unordered_map>
 #include <type_traits>
 
+/**
+ * @brief Name of the environment variable that enables hash-consing of arrays in the AFL custom
+ * mutator.
+ *
+ */
+#define CAF_HASH_CONSING_ENV "CAF_HASH_CONSING"
+
 namespace caf {
 
 /**
  * @brief Object pool is the owner of Value objects.
  *
+ * All values are allocated in arenas owned by the pool. Singleton values (the undefined value, the
+ * null value, boolean values, function values, placeholder values, NaN and infinities) live in a
+ * persistent arena, while all other values live in a transient arena that is released as a whole
+ * by `clear`.
+ *
+ * All strings are interned: the characters of every distinct string are stored exactly once in a
+ * dedicated string arena, and equal strings are always represented by the same StringValue object.
+ * Strings created by `GetOrCreateStringValueView` are interned as well but keep referring to
+ * characters owned by the caller.
+ *
+ * Arrays are mutable until they are frozen by `FreezeArray`. If hash-consing is enabled, frozen
+ * arrays are deduplicated by their structure so that structurally identical arrays are represented
+ * by the same ArrayValue object. Note that the target then receives a single shared array object
+ * wherever the shared ArrayValue is used, which is why hash-consing is disabled by default.
+ *
+ * The pool keeps track of the number of live values and the bytes they occupy, per value kind. A
+ * memory budget can be set on the pool; when the memory reserved by the pool exceeds the budget at
+ * the time the pool is cleared, all memory retained for reuse is returned to the system allocator.
+ *
+ * Thread safety: an object pool is not thread-safe, not even for lookups of singletons and interned
+ * values. Each thread should own its object pool, and values must not be shared between pools.
+ *
  */
 class ObjectPool {
 public:
+  /**
+   * @brief Memory statistics about an object pool.
+   *
+   */
+  struct Statistics {
+    explicit Statistics();
+
+    size_t ValuesCount[ValueKindsCount]; // Number of live values of each kind.
+    size_t ValueBytes[ValueKindsCount]; // Bytes occupied by live values of each kind.
+    size_t BytesAllocated; // Bytes allocated for transient values since the last clear.
+    size_t BytesReserved; // Bytes held by the pool, including memory retained for reuse.
+    size_t HighWaterMark; // Maximum value of BytesAllocated ever observed.
+    size_t MemoryBudget; // The memory budget, or 0 if there is no budget.
+    size_t ClearsCount; // Number of times the pool has been cleared.
+    size_t BudgetResetsCount; // Number of times the retained memory was released due to the budget.
+  }; // struct Statistics
+
   /**
    * @brief Construct a new ObjectPool object.
    *
@@ -44,10 +92,10 @@ public:
   template <typename T, typename ...Args>
   T* CreateValue(Args&&... args) {
     static_assert(std::is_base_of<Value, T>::value, "T does not derive from Value.");
-    auto value = caf::make_unique<T>(std::forward<Args>(args)...);
-    auto ret = value.get();
-    _values.push_back(std::move(value));
-    return ret;
+    auto value = _arena.Create<T>(std::forward<Args>(args)...);
+    _values.push_back(value);
+    CountValue(value->kind(), sizeof(T), false);
+    return value;
   }
 
   /**
@@ -83,10 +131,26 @@ public:
   /**
    * @brief Get or create a StringValue representing the given string.
    *
-   * @param s the C++ string.
+   * If the string has been interned since the last clear, the existing StringValue is returned.
+   * Otherwise the characters are copied into the string arena of the pool.
+   *
+   * @param s the string.
    * @return StringValue* the StringValue representing the given string.
    */
-  StringValue* GetOrCreateStringValue(std::string s);
+  StringValue* GetOrCreateStringValue(StringView s);
+
+  /**
+   * @brief Get or create a StringValue representing the given string without copying its
+   * characters.
+   *
+   * If the string has been interned since the last clear, the existing StringValue is returned.
+   * Otherwise the new StringValue refers to the given characters directly, so the characters must
+   * stay alive and unchanged until the next clear of the pool.
+   *
+   * @param s the string.
+   * @return StringValue* the StringValue representing the given string.
+   */
+  StringValue* GetOrCreateStringValueView(StringView s);
 
   /**
    * @brief Get or create an IntegerValue representing the given integer.
@@ -105,11 +169,40 @@ public:
   FloatValue* GetOrCreateFloatValue(double value);
 
   /**
-   * @brief Create an ArrayValue object representing an empty array.
+   * @brief Create an ArrayValue object representing an array of the given length. All elements are
+   * initialized to null and should be set by the caller.
    *
+   * @param size the number of elements in the array.
    * @return ArrayValue* the created array value object.
    */
-  ArrayValue* CreateArrayValue();
+  ArrayValue* CreateArrayValue(size_t size);
+
+  /**
+   * @brief Freeze the given array after all of its elements have been set.
+   *
+   * If hash-consing is enabled and a structurally identical frozen array exists in this pool, the
+   * existing array is returned and the given array should be discarded. Otherwise the given array is
+   * frozen and returned.
+   *
+   * @param array the array to freeze.
+   * @return ArrayValue* the frozen array that should be used in place of the given array.
+   */
+  ArrayValue* FreezeArray(ArrayValue* array);
+
+  /**
+   * @brief Determine whether hash-consing of frozen arrays is enabled.
+   *
+   * @return true if hash-consing is enabled.
+   * @return false if hash-consing is disabled.
+   */
+  bool IsHashConsingEnabled() const { return _hashConsing; }
+
+  /**
+   * @brief Enable or disable hash-consing of frozen arrays.
+   *
+   * @param enabled whether hash-consing should be enabled.
+   */
+  void SetHashConsingEnabled(bool enabled) { _hashConsing = enabled; }
 
   /**
    * @brief Get a PlaceholderValue representing the given index reference.
@@ -140,7 +233,7 @@ public:
    * @param index the index.
    * @return Value* the value at the given index.
    */
-  Value* GetValue(size_t index) const { return _values.at(index).get(); }
+  Value* GetValue(size_t index) const { return _values.at(index); }
 
   /**
    * @brief Randomly select a value from this object pool, using the given random number generator.
@@ -151,38 +244,170 @@ public:
    */
   template <typename T>
   Value* SelectValue(Random<T>& rnd) {
-    return rnd.Select(_values).get();
+    return rnd.Select(_values);
   }
 
   /**
    * @brief Clear this object pool.
    *
-   * This function will not delete the following values if they exist:
+   * All values allocated in the transient arena, including strings, integers, floats and arrays,
+   * are released in O(1) time. If `keepSingletons` is true, the following values survive if they
+   * exist:
    * * The undefined value;
    * * The null value;
+   * * The boolean values;
    * * The function values;
-   * * The string values whose value is bookkept in the internal string table;
-   * * The integer values whose value is bookkept in the internal integer table;
    * * The NaN value;
    * * The +inf and the -inf value;
    * * The placeholder values.
    *
+   * @param keepSingletons whether to keep the singleton values.
+   */
+  void clear(bool keepSingletons = true);
+
+  /**
+   * @brief Get the number of bytes allocated for values since the last clear.
+   *
+   * @return size_t the number of bytes allocated.
+   */
+  size_t GetBytesAllocated() const {
+    return _arena.GetBytesAllocated() + _stringArena.GetBytesAllocated();
+  }
+
+  /**
+   * @brief Get the number of bytes held by this pool, including memory retained for reuse after
+   * clear.
+   *
+   * @return size_t the number of bytes reserved.
+   */
+  size_t GetBytesReserved() const;
+
+  /**
+   * @brief Get the memory budget of this pool.
+   *
+   * @return size_t the memory budget in bytes, or 0 if there is no budget.
+   */
+  size_t GetMemoryBudget() const { return _budget; }
+
+  /**
+   * @brief Set the memory budget of this pool.
+   *
+   * The budget is checked whenever the pool is cleared, since values cannot be released while they
+   * are in use. If the pool reserves more memory than the budget, all memory retained for reuse is
+   * released and the string table is shrunk. Singletons are also dropped if they alone exceed the
+   * budget.
+   *
+   * @param budget the memory budget in bytes, or 0 to remove the budget.
+   */
+  void SetMemoryBudget(size_t budget) { _budget = budget; }
+
+  /**
+   * @brief Get the memory statistics of this pool.
+   *
+   * @return Statistics the memory statistics.
    */
-  void clear();
+  Statistics GetStatistics() const;
+
+  /**
+   * @brief Get the number of distinct strings interned since the last clear.
+   *
+   * @return size_t the number of interned strings.
+   */
+  size_t GetInternedStringsCount() const { return _strCount; }
 
 private:
-  std::vector<std::unique_ptr<Value>> _values;
-  std::unique_ptr<Value> _undef; // Undefined value
-  std::unique_ptr<Value> _null; // Null value
-  std::unordered_map<FunctionIdType, std::unique_ptr<FunctionValue>> _funcValues; // Function values
-  std::unique_ptr<BooleanValue> _bool[2]; // Boolean values
-  std::unordered_map<std::string, StringValue *> _strToValue;
+  Arena _arena; // Arena of transient values.
+  Arena _singletonArena; // Arena of singleton values.
+  Arena _stringArena; // Arena of the characters of interned strings.
+  std::vector<Value *> _values;
+  Value* _undef; // Undefined value
+  Value* _null; // Null value
+  std::unordered_map<FunctionIdType, FunctionValue *> _funcValues; // Function values
+  BooleanValue* _bool[2]; // Boolean values
+  std::vector<StringValue *> _strTable; // Open addressing hash table of interned strings.
+  std::vector<size_t> _strSlots; // Indexes of the occupied slots of _strTable.
+  size_t _strCount; // Number of strings in _strTable.
   std::unique_ptr<IntegerValue *[]> _intTable;
-  std::unique_ptr<FloatValue> _nan; // NaN value.
-  std::unique_ptr<FloatValue> _inf; // +infinity value.
-  std::unique_ptr<FloatValue> _negInf; // -infinity value.
-  std::vector<std::unique_ptr<ArrayValue>> _arrayValues;
-  std::vector<std::unique_ptr<PlaceholderValue>> _placeholderValues;
+  FloatValue* _nan; // NaN value.
+  FloatValue* _inf; // +infinity value.
+  FloatValue* _negInf; // -infinity value.
+  std::vector<PlaceholderValue *> _placeholderValues;
+  bool _hashConsing; // Whether hash-consing of frozen arrays is enabled.
+  std::unordered_multimap<size_t, ArrayValue *> _arrayTable; // Structural hash to frozen arrays.
+  size_t _counts[ValueKindsCount]; // Number of live transient values of each kind.
+  size_t _bytes[ValueKindsCount]; // Bytes of live transient values of each kind.
+  size_t _singletonCounts[ValueKindsCount]; // Number of singletons of each kind.
+  size_t _singletonBytes[ValueKindsCount]; // Bytes of singletons of each kind.
+  size_t _highWaterMark;
+  size_t _budget;
+  size_t _clearsCount;
+  size_t _budgetResetsCount;
+
+  /**
+   * @brief Account a newly created value in the statistics.
+   *
+   * @param kind kind of the value.
+   * @param bytes the number of bytes occupied by the value.
+   * @param singleton whether the value is a singleton.
+   */
+  void CountValue(ValueKind kind, size_t bytes, bool singleton) {
+    auto index = static_cast<size_t>(kind);
+    if (singleton) {
+      ++_singletonCounts[index];
+      _singletonBytes[index] += bytes;
+    } else {
+      ++_counts[index];
+      _bytes[index] += bytes;
+    }
+  }
+
+  /**
+   * @brief Drop all singleton values. The caller is responsible for resetting or releasing the
+   * singleton arena.
+   *
+   */
+  void ClearSingletons();
+
+  /**
+   * @brief Apply the memory budget. This function should be called right after the pool is
+   * cleared.
+   *
+   */
+  void ApplyMemoryBudget();
+
+  /**
+   * @brief Get or create a StringValue representing the given string.
+   *
+   * @param s the string.
+   * @param copy whether to copy the characters into the string arena.
+   * @return StringValue* the StringValue representing the given string.
+   */
+  StringValue* InternString(StringView s, bool copy);
+
+  /**
+   * @brief Find the slot in the string table that holds the given string, or the empty slot where
+   * the given string should be inserted.
+   *
+   * @param s the string.
+   * @param hash hash value of the string.
+   * @return StringValue*& the slot.
+   */
+  StringValue*& FindStringSlot(StringView s, size_t hash);
+
+  /**
+   * @brief Double the size of the string table.
+   *
+   */
+  void GrowStringTable();
+
+  template <typename T, typename ...Args>
+  T* GetOrCreateSingleton(T*& singleton, Args&&... args) {
+    if (!singleton) {
+      singleton = _singletonArena.Create<T>(std::forward<Args>(args)...);
+      CountValue(singleton->kind(), sizeof(T), true);
+    }
+    return singleton;
+  }
 }; // class ObjectPool
 
 } // namespace caf
@@ -0,0 +1,85 @@
+#ifndef CAF_TEST_CASE_CANONICALIZER_H
+#define CAF_TEST_CASE_CANONICALIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace caf {
+
+class FunctionCall;
+class ObjectPool;
+class TestCase;
+class Value;
+
+/**
+ * @brief Compute structural hashes and canonical forms of test cases.
+ *
+ * Two test cases have the same structural hash if they only differ in:
+ * * whether an array value is shared through a back-reference or appears as structurally identical
+ *   copies;
+ * * the order of function calls, as long as every function call still comes after the calls whose
+ *   return values it uses.
+ *
+ * The hash of a function call covers the function ID, the constructor flag, the `this` value and
+ * the arguments; a placeholder value is hashed as the hash of the function call it refers to. The
+ * hash of a test case is an order-independent combination of the hashes of its function calls.
+ *
+ * The canonical form of a test case orders function calls topologically by their dependencies,
+ * picking the function call with the smallest hash first among the function calls whose
+ * dependencies are already placed.
+ *
+ */
+class TestCaseCanonicalizer {
+public:
+  /**
+   * @brief Construct a new TestCaseCanonicalizer object.
+   *
+   */
+  explicit TestCaseCanonicalizer();
+
+  TestCaseCanonicalizer(const TestCaseCanonicalizer &) = delete;
+  TestCaseCanonicalizer(TestCaseCanonicalizer &&) noexcept = default;
+
+  /**
+   * @brief Compute the structural hash of the given test case.
+   *
+   * @param testCase the test case.
+   * @return uint64_t the structural hash.
+   */
+  uint64_t Hash(const TestCase& testCase);
+
+  /**
+   * @brief Reorder the function calls in the given test case into the canonical order, and rewrite
+   * placeholder values accordingly.
+   *
+   * @param testCase the test case.
+   * @param pool the object pool from which the values of the test case are allocated. Frozen arrays
+   * that contain placeholder values are copied into this pool.
+   */
+  void Canonicalize(TestCase& testCase, ObjectPool& pool);
+
+private:
+  std::vector<uint64_t> _callHashes; // Hashes of the function calls, indexed by function call index.
+  std::unordered_map<const Value *, uint64_t> _arrayHashes; // Memoized hashes of array values.
+  std::vector<std::vector<size_t>> _dependents; // Calls that use the return value of each call.
+  std::vector<size_t> _dependenciesCount; // Number of calls each call uses the return value of.
+  std::unordered_set<size_t> _dependencies; // Dependencies of the call being visited.
+  std::unordered_set<const Value *> _visitedArrays; // Arrays visited in the call being visited.
+
+  void HashCalls(const TestCase& testCase);
+
+  uint64_t HashCall(const FunctionCall& call, size_t callIndex);
+
+  uint64_t HashValue(const Value* value, size_t callIndex);
+
+  void CollectDependencies(const TestCase& testCase);
+
+  void CollectDependencies(const Value* value);
+}; // class TestCaseCanonicalizer
+
+} // namespace caf
+
+#endif
@@ -1,8 +1,13 @@
 #ifndef CAF_TEST_CASE_DESERIALIZER_H
 #define CAF_TEST_CASE_DESERIALIZER_H
 
+#include "Infrastructure/BufferReader.h"
+#include "Basic/TestCaseValidator.h"
 #include "Fuzzer/TestCase.h"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace caf {
 
 class InputStream;
@@ -13,6 +18,20 @@ class Value;
 /**
  * @brief Deserialize test cases frrom binary form.
  *
+ * Both the v1 and the v2 binary formats are accepted; the format of each test case is detected from
+ * its header.
+ *
+ * A deserializer constructed over a memory buffer runs in zero-copy mode: string values refer to
+ * the characters in the buffer instead of copies of them, and all fields are read with inlined
+ * loads. The buffer must then outlive the deserialized test cases, i.e. it must stay alive and
+ * unchanged until the object pool is cleared.
+ *
+ * In zero-copy mode, `TryDeserialize` validates each test case with a TestCaseValidator before
+ * deserializing it, so malformed inputs are rejected before any value is allocated.
+ *
+ * Thread safety: a deserializer is not thread-safe, but distinct deserializers reading from
+ * distinct streams into distinct object pools can run concurrently.
+ *
  */
 class TestCaseDeserializer {
 public:
@@ -23,40 +42,61 @@ public:
    * @param in the input stream.
    */
   explicit TestCaseDeserializer(ObjectPool& pool, InputStream& in)
-    : _pool(pool), _in(in)
+    : _pool(pool), _in(&in), _reader(nullptr, 0), _validator(), _error()
+  { }
+
+  /**
+   * @brief Construct a new TestCaseDeserializer object in zero-copy mode.
+   *
+   * @param pool the object pool.
+   * @param data pointer to the buffer containing serialized test cases. The buffer must stay alive
+   * and unchanged until the object pool is cleared.
+   * @param size size of the buffer, in bytes.
+   */
+  explicit TestCaseDeserializer(ObjectPool& pool, const uint8_t* data, size_t size)
+    : _pool(pool), _in(nullptr), _reader(data, size), _validator(), _error()
   { }
 
   TestCaseDeserializer(const TestCaseDeserializer &) = delete;
   TestCaseDeserializer(TestCaseDeserializer &&) noexcept = default;
 
   /**
-   * @brief Deserialize a test case from the underlying stream.
+   * @brief Deserialize a test case from the underlying stream or buffer.
    *
    * @return TestCase the test case deserialized.
    */
   TestCase Deserialize();
 
-private:
-  class DeserializationContext;
-
-  ObjectPool& _pool;
-  InputStream& _in;
-
   /**
-   * @brief Deserialize a function call from the underlying stream.
+   * @brief Validate the next test case in the underlying buffer and deserialize it if it is valid.
+   *
+   * This function can only be called in zero-copy mode. If the test case is malformed, nothing is
+   * consumed from the buffer and the error can be retrieved by `GetError`.
    *
-   * @param context the deserialization context.
-   * @return FunctionCall the deserialized function call.
+   * @param testCase the deserialized test case.
+   * @return true if the test case is valid and has been deserialized.
+   * @return false if the test case is malformed.
    */
-  FunctionCall DeserializeFunctionCall(DeserializationContext& context);
+  bool TryDeserialize(TestCase& testCase);
 
   /**
-   * @brief Deserialize a value from the underlying stream.
+   * @brief Get the error found by the last call to `TryDeserialize`.
    *
-   * @param context the deserialization context.
-   * @return Value* the deserialized value.
+   * @return TestCaseValidationError the error.
    */
-  Value* DeserializeValue(DeserializationContext& context);
+  TestCaseValidationError GetError() const { return _error; }
+
+private:
+  class DeserializationContext;
+
+  template <typename Reader>
+  class Decoder;
+
+  ObjectPool& _pool;
+  InputStream* _in; // The input stream, or nullptr in zero-copy mode.
+  BufferReader _reader; // Reader over the input buffer in zero-copy mode.
+  TestCaseValidator _validator;
+  TestCaseValidationError _error; // Error found by the last call to TryDeserialize.
 }; // class TestCaseDeserializer
 
 } // namespace caf
@@ -10,13 +10,19 @@
 namespace caf {
 
 class CAFStore;
+class Function;
 class ObjectPool;
+class ReturnKindFeedback;
 class TestCase;
 class FunctionCall;
 
 /**
  * @brief Generate new test cases and values.
  *
+ * Thread safety: a generator is not thread-safe, and neither are the object pool and the random
+ * number generator it uses. Each thread should own its generator, object pool and random number
+ * generator; the CAF store and the return kind feedback can be shared between threads.
+ *
  */
 class TestCaseGenerator {
 public:
@@ -51,7 +57,8 @@ public:
      *
      */
     explicit GeneratePlaceholderValueParams()
-      : _currCallIndex(0)
+      : _currCallIndex(0),
+        _testCase(nullptr)
     { }
 
     /**
@@ -60,7 +67,20 @@ public:
      * @param currCallIndex the current function call's index.
      */
     explicit GeneratePlaceholderValueParams(size_t currCallIndex)
-      : _currCallIndex(currCallIndex)
+      : _currCallIndex(currCallIndex),
+        _testCase(nullptr)
+    { }
+
+    /**
+     * @brief Construct a new GeneratePlaceholderValueParams object.
+     *
+     * @param currCallIndex the current function call's index.
+     * @param testCase the test case containing the function calls that placeholder values may
+     * reference to. It should contain at least `currCallIndex` function calls.
+     */
+    explicit GeneratePlaceholderValueParams(size_t currCallIndex, const TestCase* testCase)
+      : _currCallIndex(currCallIndex),
+        _testCase(testCase)
     { }
 
     /**
@@ -86,8 +106,25 @@ public:
      */
     void SetCurrentCallIndex(size_t index) { _currCallIndex = index; }
 
+    /**
+     * @brief Get the test case containing the function calls that placeholder values may reference
+     * to.
+     *
+     * @return const TestCase* the test case, or nullptr if it is not available.
+     */
+    const TestCase* GetTestCase() const { return _testCase; }
+
+    /**
+     * @brief Set the test case containing the function calls that placeholder values may reference
+     * to.
+     *
+     * @param testCase the test case.
+     */
+    void SetTestCase(const TestCase* testCase) { _testCase = testCase; }
+
   private:
     size_t _currCallIndex;
+    const TestCase* _testCase;
   };
 
   /**
@@ -97,11 +134,12 @@ public:
    * @param pool the object pool.
    * @param rnd the random number generator.
    */
-  explicit TestCaseGenerator(CAFStore& store, ObjectPool& pool, Random<>& rnd)
+  explicit TestCaseGenerator(const CAFStore& store, ObjectPool& pool, Random<>& rnd)
     : _store(store),
       _pool(pool),
       _rnd(rnd),
-      _opt()
+      _opt(),
+      _feedback(nullptr)
   { }
 
   TestCaseGenerator(const TestCaseGenerator &) = delete;
@@ -121,6 +159,14 @@ public:
    */
   const Options& options() const { return _opt; }
 
+  /**
+   * @brief Set the return kind feedback used to bias placeholder values and `this` values towards
+   * function calls that produce objects.
+   *
+   * @param feedback the return kind feedback. nullptr disables the feedback.
+   */
+  void SetFeedback(const ReturnKindFeedback* feedback) { _feedback = feedback; }
+
   /**
    * @brief Generate a new test case.
    *
@@ -143,9 +189,12 @@ public:
    * @param index the index of the function call to be generated.
    * @param rootEntryIndex the index of the root entry from which the callee function will be
    * selected.
+   * @param testCase the test case containing the function calls before the function call to be
+   * generated, if available.
    * @return FunctionCall the function call generated.
    */
-  FunctionCall GenerateFunctionCall(size_t index, size_t rootEntryIndex);
+  FunctionCall GenerateFunctionCall(
+      size_t index, size_t rootEntryIndex, const TestCase* testCase = nullptr);
 
   /**
    * @brief Generate a new value.
@@ -159,6 +208,17 @@ public:
     return GenerateValue(rootEntryIndex, params, 1);
   }
 
+  /**
+   * @brief Generate a value for the `this` object of a function call. The generated value prefers
+   * placeholders that reference to function calls producing objects.
+   *
+   * @param rootEntryIndex the index of the root entry from which callee functions of function
+   * values will be selected.
+   * @param params the parameters for generating placeholder values.
+   * @return Value* the value generated.
+   */
+  Value* GenerateThisValue(size_t rootEntryIndex, GeneratePlaceholderValueParams params);
+
   /**
    * @brief Generate a function value.
    *
@@ -176,18 +236,42 @@ public:
   char GenerateStringCharacter();
 
 private:
-  CAFStore& _store;
+  const CAFStore& _store;
   ObjectPool& _pool;
   Random<>& _rnd;
   Options _opt;
+  const ReturnKindFeedback* _feedback;
+
+  /**
+   * @brief Select a function under the given root entry, according to the weights of the functions.
+   *
+   * @param rootEntryIndex the index of the root entry from which the function will be selected.
+   * @return const Function& the selected function.
+   */
+  const Function& SelectFunction(size_t rootEntryIndex);
 
   /**
    * @brief Randomly generate a number indicating how many arguments should be generated for a
    * function call.
    *
+   * If the arity of the callee is known, the generated number concentrates around the arity.
+   * Otherwise the generated number is uniformly distributed in [0, MaxArguments].
+   *
+   * @param callee the callee function.
    * @return size_t the number of arguments to generate.
    */
-  size_t GenerateArgumentsCount();
+  size_t GenerateArgumentsCount(const Function& callee);
+
+  /**
+   * @brief Generate the index of the function call that a placeholder value references to.
+   *
+   * If return kind feedback is available, function calls whose callees are more likely to produce
+   * objects are more likely to be selected. Otherwise the index is selected uniformly.
+   *
+   * @param params the parameters for generating placeholder values.
+   * @return size_t the index of the referenced function call.
+   */
+  size_t GeneratePlaceholderIndex(const GeneratePlaceholderValueParams& params);
 
   /**
    * @brief Generate a ValueKind value.
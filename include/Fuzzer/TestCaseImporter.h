@@ -0,0 +1,83 @@
+#ifndef CAF_TEST_CASE_IMPORTER_H
+#define CAF_TEST_CASE_IMPORTER_H
+
+#include "Basic/Function.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace caf {
+
+class CAFStore;
+class ObjectPool;
+class TestCase;
+
+/**
+ * @brief Import straight-line JavaScript code as test cases.
+ *
+ * The importer understands a small subset of JavaScript. Every statement should have one of the
+ * following forms:
+ * * `[const|let|var] name = [new] callee(args...);`
+ * * `[new] callee(args...);`
+ * * `[const|let|var] name = require('module');`
+ * * `[const|let|var] name = dotted.name;`
+ *
+ * The callee is either a dotted name that resolves to an API function in the CAF metadata store, or
+ * a method call `x.method` on a variable `x` that holds the result of a previous call. Method calls
+ * are resolved to `<Ctor>.prototype.method` where `<Ctor>` is the callee that produced `x`, or to
+ * the only function in the store whose name ends with `.prototype.method`.
+ *
+ * Arguments can be number, string, boolean, `null` and `undefined` literals, array literals,
+ * variables holding results of previous calls, and dotted names of API functions.
+ *
+ * Unsupported statements are skipped.
+ *
+ */
+class TestCaseImporter {
+public:
+  /**
+   * @brief Construct a new TestCaseImporter object.
+   *
+   * @param store the CAF metadata store.
+   * @param pool the object pool in which the values of the imported test cases are allocated.
+   */
+  explicit TestCaseImporter(const CAFStore& store, ObjectPool& pool);
+
+  TestCaseImporter(const TestCaseImporter &) = delete;
+  TestCaseImporter(TestCaseImporter &&) noexcept = default;
+
+  /**
+   * @brief Import the given JavaScript code as a test case.
+   *
+   * @param code the JavaScript code.
+   * @return TestCase the imported test case. It is empty if no statements can be imported.
+   */
+  TestCase Import(const std::string& code);
+
+  /**
+   * @brief Get the number of statements that have been imported as function calls.
+   *
+   * @return size_t the number of imported statements.
+   */
+  size_t GetImportedCount() const { return _imported; }
+
+  /**
+   * @brief Get the number of statements that have been skipped because they are not supported.
+   *
+   * @return size_t the number of skipped statements.
+   */
+  size_t GetSkippedCount() const { return _skipped; }
+
+private:
+  const CAFStore& _store;
+  ObjectPool& _pool;
+  std::unordered_map<std::string, FunctionIdType> _funcIds; // Function name to function ID.
+  std::unordered_map<std::string, FunctionIdType> _methodIds; // Method name to function ID.
+  size_t _imported;
+  size_t _skipped;
+}; // class TestCaseImporter
+
+} // namespace caf
+
+#endif
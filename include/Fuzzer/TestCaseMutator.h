@@ -4,16 +4,23 @@
 #include "Infrastructure/Random.h"
 #include "Fuzzer/TestCaseGenerator.h"
 
+#include <string>
+
 namespace caf {
 
 class CAFStore;
 class ObjectPool;
+class ReturnKindFeedback;
 class TestCase;
 class Value;
 
 /**
  * @brief Test case mutator.
  *
+ * Thread safety: a mutator has the same thread safety contract as TestCaseGenerator. Test cases
+ * being mutated must be owned by the thread running the mutator. See ConcurrentMutator for a
+ * ready-made multi-threaded driver.
+ *
  */
 class TestCaseMutator {
 public:
@@ -25,12 +32,14 @@ public:
    * @param corpus the test case corpus.
    * @param rnd the random number generator.
    */
-  explicit TestCaseMutator(CAFStore& store, ObjectPool& pool, Random<>& rnd)
+  explicit TestCaseMutator(const CAFStore& store, ObjectPool& pool, Random<>& rnd)
     : _store(store),
       _pool(pool),
       _rnd(rnd),
       _gen { store, pool, rnd },
-      _lastMutator("")
+      _lastMutator(""),
+      _testCase(nullptr),
+      _stringBuffer()
   { }
 
   TestCaseMutator(const TestCaseMutator &) = delete;
@@ -50,6 +59,14 @@ public:
    */
   const Options& options() const { return _gen.options(); }
 
+  /**
+   * @brief Set the return kind feedback used to bias placeholder values and `this` values towards
+   * function calls that produce objects.
+   *
+   * @param feedback the return kind feedback. nullptr disables the feedback.
+   */
+  void SetFeedback(const ReturnKindFeedback* feedback) { _gen.SetFeedback(feedback); }
+
   /**
    * @brief Mutate the given test case.
    *
@@ -65,11 +82,24 @@ public:
   const char* GetLastMutatorName() const { return _lastMutator; }
 
 private:
-  CAFStore& _store;
+  const CAFStore& _store;
   ObjectPool& _pool;
   Random<>& _rnd;
   TestCaseGenerator _gen;
   const char* _lastMutator;
+  const TestCase* _testCase; // The test case being mutated.
+  std::string _stringBuffer; // Scratch buffer of the string mutators.
+
+  /**
+   * @brief Create parameters for generating placeholder values in the function call at the given
+   * index of the test case being mutated.
+   *
+   * @param callIndex the index of the function call.
+   * @return TestCaseGenerator::GeneratePlaceholderValueParams the parameters.
+   */
+  TestCaseGenerator::GeneratePlaceholderValueParams GetPlaceholderParams(size_t callIndex) const {
+    return TestCaseGenerator::GeneratePlaceholderValueParams { callIndex, _testCase };
+  }
 
   /**
    * @brief Mutate the given test case by adding a function call to the tail of the function call
@@ -144,6 +174,16 @@ private:
    */
   StringValue* MutateString(StringValue* value);
 
+  /**
+   * @brief Copy the characters of the given string value into the scratch buffer of the string
+   * mutators. The mutated string is interned into the object pool afterwards, so the string mutators
+   * do not allocate in steady state.
+   *
+   * @param value the string value.
+   * @return std::string& the scratch buffer.
+   */
+  std::string& LoadStringBuffer(const StringValue* value);
+
   /**
    * @brief Mutate the given string value by inserting a character into the string.
    *
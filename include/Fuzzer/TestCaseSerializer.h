@@ -1,6 +1,13 @@
 #ifndef CAF_TEST_CASE_SERIALIZER_H
 #define CAF_TEST_CASE_SERIALIZER_H
 
+#include "Basic/TestCaseFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 namespace caf {
 
 class OutputStream;
@@ -11,49 +18,83 @@ class Value;
 /**
  * @brief Serialize a test case into binary form.
  *
+ * Serialization takes two passes over the test case: the first pass computes the exact size of the
+ * serialized test case and the second pass writes it into a buffer of that size. The tables mapping
+ * values to their indexes are kept in the serializer and reused across test cases, so a serializer
+ * that is reused for many test cases does not allocate memory in steady state.
+ *
+ * Thread safety: a serializer is not thread-safe, but distinct serializers writing to distinct
+ * streams can run concurrently.
+ *
  */
 class TestCaseSerializer {
 public:
+  /**
+   * @brief Construct a new TestCaseSerializer object that serializes test cases into memory buffers.
+   *
+   * @param version the binary format version to write.
+   */
+  explicit TestCaseSerializer(TestCaseFormatVersion version = LatestTestCaseFormatVersion);
+
   /**
    * @brief Construct a new TestCaseSerializer object.
    *
-   * @param corpus the corpus containing test cases.
    * @param out the output stream.
+   * @param version the binary format version to write.
    */
-  explicit TestCaseSerializer(OutputStream& out)
-    : _out(out)
-  { }
+  explicit TestCaseSerializer(OutputStream& out,
+                              TestCaseFormatVersion version = LatestTestCaseFormatVersion);
 
   TestCaseSerializer(const TestCaseSerializer &) = delete;
-  TestCaseSerializer(TestCaseSerializer &&) noexcept = default;
+  TestCaseSerializer(TestCaseSerializer &&) noexcept;
+
+  ~TestCaseSerializer();
 
   /**
-   * @brief Serialize the given test case into binary form.
+   * @brief Serialize the given test case into binary form and write it to the output stream. The
+   * serialized test case is written to the stream with a single write.
+   *
+   * This function can only be called on serializers constructed with an output stream.
    *
    * @param testCase the test case to serialize.
    */
   void Serialize(const TestCase& testCase);
 
-private:
-  class SerializationContext;
-
-  OutputStream& _out;
+  /**
+   * @brief Serialize the given test case into binary form and append it to the given buffer.
+   *
+   * @param testCase the test case to serialize.
+   * @param buffer the buffer. Its size grows by exactly the size of the serialized test case.
+   */
+  void Serialize(const TestCase& testCase, std::vector<uint8_t>& buffer);
 
   /**
-   * @brief Serialize the given function call into binary form.
+   * @brief Serialize the given test case into binary form and write it to the given buffer.
    *
-   * @param call the function call to serialize.
-   * @param context the serialization context.
+   * @param testCase the test case to serialize.
+   * @param buffer the buffer. It must be able to hold at least `GetSerializedSize(testCase)` bytes.
+   * @return size_t the number of bytes written into the buffer.
    */
-  void Serialize(const FunctionCall& call, SerializationContext& context);
+  size_t Serialize(const TestCase& testCase, uint8_t* buffer);
 
   /**
-   * @brief Serialize the given value into binary form.
+   * @brief Get the exact size of the given test case in binary form.
    *
-   * @param value the value to serialize.
-   * @param context the serialization context.
+   * @param testCase the test case.
+   * @return size_t the size of the serialized test case, in bytes.
    */
-  void Serialize(const Value* value, SerializationContext& context);
+  size_t GetSerializedSize(const TestCase& testCase);
+
+private:
+  class SerializationContext;
+
+  template <typename Writer>
+  class Encoder;
+
+  OutputStream* _out;
+  TestCaseFormatVersion _version;
+  std::unique_ptr<SerializationContext> _context;
+  std::vector<uint8_t> _buffer; // Buffer of the serialized test case written to `_out`.
 }; // class TestCaseSerializer
 
 } // namespace caf
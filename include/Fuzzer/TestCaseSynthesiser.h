@@ -13,6 +13,9 @@ class TestCase;
 /**
  * @brief Synthesis test cases to equivalent JavaScript code.
  *
+ * Thread safety: a synthesiser and its synthesis builder are not thread-safe. Each thread should
+ * own its synthesiser and builder; the CAF store can be shared between threads.
+ *
  */
 class TestCaseSynthesiser {
 public:
@@ -2,20 +2,27 @@
 #define CAF_VALUE_H
 
 #include "Infrastructure/Casting.h"
+#include "Infrastructure/StringView.h"
 #include "Basic/Function.h"
 #include "Basic/ValueKind.h"
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
-#include <utility>
-#include <memory>
-#include <string>
-#include <vector>
 
 namespace caf {
 
 /**
  * @brief Represent a language specific value.
  *
+ * A value is a compact, non-virtual 16-byte cell. Scalar values (booleans, integers, floats,
+ * function IDs and placeholder indexes) are stored inline in the cell; strings and arrays store a
+ * pointer to their characters or elements together with their length. The subclasses of Value
+ * are thin typed views over the same cell and must not add data members.
+ *
+ * Values are allocated in the arenas of an ObjectPool and are never destroyed individually, so
+ * Value and all its subclasses must be trivially destructible.
+ *
  */
 class Value {
 public:
@@ -25,11 +32,13 @@ public:
    * @param kind kind of this value.
    */
   explicit Value(ValueKind kind)
-    : _kind(kind)
+    : _kind(kind),
+      _flags(0),
+      _reserved(0),
+      _size(0),
+      _payload()
   { }
 
-  virtual ~Value() = default;
-
   /**
    * @brief Get the kind of this value.
    *
@@ -49,8 +58,9 @@ public:
    *
    * @return bool the boolean value represented by this value.
    */
-  virtual bool GetBooleanValue() const {
-    assert(false && "The current value is not a boolean value.");
+  bool GetBooleanValue() const {
+    assert(IsBoolean() && "The current value is not a boolean value.");
+    return _payload.Boolean;
   }
 
   /**
@@ -60,8 +70,9 @@ public:
    *
    * @return int32_t the integer value represented by this value.
    */
-  virtual int32_t GetIntegerValue() const {
-    assert(false && "The current value is not an integer value.");
+  int32_t GetIntegerValue() const {
+    assert(IsInteger() && "The current value is not an integer value.");
+    return _payload.Integer;
   }
 
   /**
@@ -71,8 +82,9 @@ public:
    *
    * @return double the boolean value represented by this value.
    */
-  virtual double GetFloatValue() const {
-    assert(false && "The current value is not a floating point value.");
+  double GetFloatValue() const {
+    assert(IsFloat() && "The current value is not a floating point value.");
+    return _payload.Float;
   }
 
   /**
@@ -80,10 +92,11 @@ public:
    *
    * This function will trigger an assertion failure if this value is not a string value.
    *
-   * @return const std::string& the string value represented by this value.
+   * @return StringView the string value represented by this value.
    */
-  virtual const std::string& GetStringValue() const {
-    assert(false && "The current value is not a string value.");
+  StringView GetStringValue() const {
+    assert(IsString() && "The current value is not a string value.");
+    return StringView { _payload.String, _size };
   }
 
   /**
@@ -93,8 +106,9 @@ public:
    *
    * @return FunctionIdType the function ID.
    */
-  virtual FunctionIdType GetFunctionId() const {
-    assert(false && "The current value is not a function value.");
+  FunctionIdType GetFunctionId() const {
+    assert(IsFunction() && "The current value is not a function value.");
+    return _payload.FunctionId;
   }
 
   /**
@@ -104,8 +118,9 @@ public:
    *
    * @return size_t the reference index represented by this value.
    */
-  virtual size_t GetPlaceholderIndex() const {
-    assert(false && "The current value is not a placeholder value.");
+  size_t GetPlaceholderIndex() const {
+    assert(IsPlaceholder() && "The current value is not a placeholder value.");
+    return _payload.PlaceholderIndex;
   }
 
   /**
@@ -115,10 +130,43 @@ public:
    */
   static Value CreateUndefinedValue() { return Value { ValueKind::Undefined }; }
 
-private:
+  static bool classof(const Value *) { return true; }
+
+protected:
+  /**
+   * @brief Payload of a value cell. Which member is active is determined by the kind of the value.
+   *
+   */
+  union Payload {
+    bool Boolean;
+    int32_t Integer;
+    double Float;
+    FunctionIdType FunctionId;
+    size_t PlaceholderIndex;
+    const char* String; // Characters of a string; the length is stored in `_size`.
+    Value** Elements; // Elements of an array; the length is stored in `_size`.
+    uint64_t Bits;
+
+    Payload() : Bits(0) { }
+  }; // union Payload
+
+  /**
+   * @brief Bits in `_flags`.
+   *
+   */
+  enum Flags : uint8_t {
+    FrozenFlag = 1, // The value is immutable.
+  }; // enum Flags
+
   ValueKind _kind;
+  uint8_t _flags;
+  uint16_t _reserved;
+  uint32_t _size; // Length of a string or an array.
+  Payload _payload;
 }; // class Value
 
+static_assert(sizeof(Value) == 16, "Value should be a 16-byte cell.");
+
 /**
  * @brief A language specific boolean value.
  *
@@ -131,23 +179,19 @@ public:
    * @param value the boolean value.
    */
   explicit BooleanValue(bool value)
-    : Value { ValueKind::Boolean },
-      _value(value)
-  { }
+    : Value { ValueKind::Boolean }
+  {
+    _payload.Boolean = value;
+  }
 
   /**
    * @brief Get the boolean value.
    *
    * @return bool the boolean value.
    */
-  bool value() const { return _value; }
-
-  bool GetBooleanValue() const override {
-    return value();
-  }
+  bool value() const { return _payload.Boolean; }
 
-private:
-  bool _value;
+  static bool classof(const Value* value) { return value->IsBoolean(); }
 }; // class BooleanValue
 
 /**
@@ -159,33 +203,33 @@ public:
   /**
    * @brief Construct a new StringValue object.
    *
-   * @param str the string value.
+   * @param data pointer to the characters of the string. The characters should outlive this
+   * object; they are usually allocated in the same arena as this object.
+   * @param length the number of characters in the string.
    */
-  explicit StringValue(std::string str)
-    : Value { ValueKind::String },
-      _value(std::move(str))
-  { }
+  explicit StringValue(const char* data, size_t length)
+    : Value { ValueKind::String }
+  {
+    assert(length <= UINT32_MAX && "The string is too long.");
+    _size = static_cast<uint32_t>(length);
+    _payload.String = data;
+  }
 
   /**
    * @brief Get the string value.
    *
-   * @return const std::string& the string value.
+   * @return StringView the string value.
    */
-  const std::string& value() const { return _value; }
+  StringView value() const { return StringView { _payload.String, _size }; }
 
   /**
    * @brief Get the length of the string.
    *
    * @return size_t length of the string.
    */
-  size_t length() const { return _value.length(); }
-
-  const std::string& GetStringValue() const override {
-    return value();
-  }
+  size_t length() const { return _size; }
 
-private:
-  std::string _value;
+  static bool classof(const Value* value) { return value->IsString(); }
 }; // class StringValue
 
 /**
@@ -200,23 +244,19 @@ public:
    * @param funcId the function ID.
    */
   explicit FunctionValue(FunctionIdType funcId)
-    : Value { ValueKind::Function },
-      _funcId(funcId)
-  { }
+    : Value { ValueKind::Function }
+  {
+    _payload.FunctionId = funcId;
+  }
 
   /**
    * @brief Get the function ID.
    *
    * @return FunctionIdType the function ID.
    */
-  FunctionIdType funcId() const { return _funcId; }
-
-  FunctionIdType GetFunctionId() const override {
-    return _funcId;
-  }
+  FunctionIdType funcId() const { return _payload.FunctionId; }
 
-private:
-  FunctionIdType _funcId;
+  static bool classof(const Value* value) { return value->IsFunction(); }
 }; // class FunctionValue
 
 /**
@@ -233,23 +273,19 @@ public:
    * @param value the integer value.
    */
   explicit IntegerValue(int32_t value)
-    : Value { ValueKind::Integer },
-      _value(value)
-  { }
+    : Value { ValueKind::Integer }
+  {
+    _payload.Integer = value;
+  }
 
   /**
    * @brief Get the integer value.
    *
    * @return int32_t the integer value.
    */
-  int32_t value() const { return _value; }
+  int32_t value() const { return _payload.Integer; }
 
-  int32_t GetIntegerValue() const override {
-    return value();
-  }
-
-private:
-  int32_t _value;
+  static bool classof(const Value* value) { return value->IsInteger(); }
 }; // class IntegerValue
 
 /**
@@ -264,98 +300,106 @@ public:
    * @param value the value.
    */
   explicit FloatValue(double value)
-    : Value { ValueKind::Float },
-      _value(value)
-  { }
+    : Value { ValueKind::Float }
+  {
+    _payload.Float = value;
+  }
 
   /**
    * @brief Get the floating point value.
    *
    * @return double the floating point value.
    */
-  double value() const { return _value; }
+  double value() const { return _payload.Float; }
 
-  double GetFloatValue() const override {
-    return value();
-  }
-
-private:
-  double _value;
+  static bool classof(const Value* value) { return value->IsFloat(); }
 }; // class FloatValue
 
 /**
  * @brief A language specific array value.
  *
+ * The elements of an array are stored in a contiguous span of value pointers. The length of an
+ * array is fixed when the array is created.
+ *
  */
 class ArrayValue : public Value {
 public:
-  using Iterator = typename std::vector<Value *>::iterator;
-  using ConstIterator = typename std::vector<Value *>::const_iterator;
+  using Iterator = Value **;
+  using ConstIterator = Value * const *;
 
   /**
    * @brief Construct a new ArrayValue object.
    *
+   * @param elements storage of the elements. The storage should hold `size` elements and outlive
+   * this object; it is usually allocated in the same arena as this object.
+   * @param size the number of elements in the array.
    */
-  explicit ArrayValue()
+  explicit ArrayValue(Value** elements, size_t size)
     : Value { ValueKind::Array }
-  { }
+  {
+    assert(size <= UINT32_MAX && "The array is too long.");
+    _size = static_cast<uint32_t>(size);
+    _payload.Elements = elements;
+  }
 
   /**
    * @brief Get the number of elements in this array.
    *
    * @return size_t the number of elements in this array.
    */
-  size_t size() const { return _elements.size(); }
+  size_t size() const { return _size; }
 
   /**
-   * @brief Reserve a capacity of at least size elements.
+   * @brief Get the element at the given index.
    *
-   * @param size the minimum capacity.
+   * @param index the index.
+   * @return Value* the element at the given index.
    */
-  void reserve(size_t size) {
-    _elements.reserve(size);
+  Value* GetElement(size_t index) const {
+    assert(index < _size && "index is out of range.");
+    return _payload.Elements[index];
   }
 
   /**
-   * @brief Add a value to the back of the array.
+   * @brief Set the element at the given index. The array should not be frozen.
    *
-   * @param value the value to be added.
+   * @param index the index.
+   * @param value the new value.
    */
-  void Push(Value* value) {
-    _elements.push_back(std::move(value));
+  void SetElement(size_t index, Value* value) {
+    assert(!frozen() && "The array is frozen.");
+    assert(index < _size && "index is out of range.");
+    _payload.Elements[index] = value;
   }
 
   /**
-   * @brief Get the element at the given index.
+   * @brief Determine whether this array is frozen. The elements of a frozen array cannot be changed
+   * since the array may be shared by multiple owners.
    *
-   * @param index the index.
-   * @return Value* the element at the given index.
+   * @return true if this array is frozen.
+   * @return false if this array is not frozen.
    */
-  Value* GetElement(size_t index) const { return _elements.at(index); }
+  bool frozen() const { return _flags & FrozenFlag; }
 
   /**
-   * @brief Set the element at the given index.
+   * @brief Freeze this array. Use ObjectPool::FreezeArray instead of calling this function directly
+   * so that the array can be shared.
    *
-   * @param index the index.
-   * @param value the new value.
    */
-  void SetElement(size_t index, Value* value) {
-    _elements.at(index) = std::move(value);
-  }
+  void Freeze() { _flags |= FrozenFlag; }
 
-  const Value* operator[](size_t index) const { return _elements.at(index); }
+  const Value* operator[](size_t index) const { return GetElement(index); }
 
-  Iterator begin() { return _elements.begin(); }
+  Iterator begin() { return _payload.Elements; }
 
-  Iterator end() { return _elements.end(); }
+  Iterator end() { return _payload.Elements + _size; }
 
-  ConstIterator begin() const { return _elements.begin(); }
+  ConstIterator begin() const { return _payload.Elements; }
 
-  ConstIterator end() const { return _elements.end(); }
+  ConstIterator end() const { return _payload.Elements + _size; }
 
-private:
-  std::vector<Value*> _elements;
-};
+  static bool classof(const Value* value) { return value->IsArray(); }
+}; // class ArrayValue
 
 /**
  * @brief A placeholder value is not a language specific value. Instead it is used by CAF to
@@ -370,25 +414,32 @@ public:
    * @param index the index of the function call.
    */
   explicit PlaceholderValue(size_t index)
-    : Value { ValueKind::Placeholder },
-      _index(index)
-  { }
+    : Value { ValueKind::Placeholder }
+  {
+    _payload.PlaceholderIndex = index;
+  }
 
   /**
    * @brief Get the index of the function call.
    *
    * @return size_t index of the function call.
    */
-  size_t index() const { return _index; }
+  size_t index() const { return _payload.PlaceholderIndex; }
 
-  size_t GetPlaceholderIndex() const override {
-    return _index;
-  }
-
-private:
-  size_t _index;
+  static bool classof(const Value* value) { return value->IsPlaceholder(); }
 }; // class PlaceholderValue
 
+#define CHECK_VALUE_CELL_SIZE(k) \
+    static_assert(sizeof(k##Value) == sizeof(Value), #k "Value should not add data members.");
+CHECK_VALUE_CELL_SIZE(Boolean)
+CHECK_VALUE_CELL_SIZE(String)
+CHECK_VALUE_CELL_SIZE(Function)
+CHECK_VALUE_CELL_SIZE(Integer)
+CHECK_VALUE_CELL_SIZE(Float)
+CHECK_VALUE_CELL_SIZE(Array)
+CHECK_VALUE_CELL_SIZE(Placeholder)
+#undef CHECK_VALUE_CELL_SIZE
+
 } // namespace caf
 
 #endif
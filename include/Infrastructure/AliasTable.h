@@ -0,0 +1,166 @@
+#ifndef CAF_ALIAS_TABLE_H
+#define CAF_ALIAS_TABLE_H
+
+#include "Infrastructure/Random.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace caf {
+
+/**
+ * @brief Sample indexes from a discrete weighted distribution in O(1) time, using the alias method
+ * described by Walker and refined by Vose.
+ *
+ * Building the table takes O(n) time where n is the number of weights. The table is immutable
+ * once built so concurrent calls to `Sample` are safe.
+ *
+ */
+class AliasTable {
+public:
+  /**
+   * @brief Construct a new empty AliasTable object.
+   *
+   */
+  explicit AliasTable()
+    : _prob(),
+      _alias()
+  { }
+
+  /**
+   * @brief Construct a new AliasTable object over the given weights.
+   *
+   * @param weights the weights.
+   */
+  explicit AliasTable(const std::vector<double>& weights)
+    : _prob(),
+      _alias()
+  {
+    Build(weights);
+  }
+
+  /**
+   * @brief Determine whether this table is empty.
+   *
+   * @return true if this table is empty.
+   * @return false if this table is not empty.
+   */
+  bool empty() const { return _prob.empty(); }
+
+  /**
+   * @brief Get the number of indexes this table samples from.
+   *
+   * @return size_t the number of indexes.
+   */
+  size_t size() const { return _prob.size(); }
+
+  /**
+   * @brief Clear this table.
+   *
+   */
+  void clear() {
+    _prob.clear();
+    _alias.clear();
+  }
+
+  /**
+   * @brief Rebuild this table over the given weights.
+   *
+   * All weights should be non-negative. If all weights are zero, then the built table samples
+   * uniformly.
+   *
+   * @param weights the weights.
+   */
+  void Build(const std::vector<double>& weights) {
+    auto n = weights.size();
+    _prob.assign(n, 1.0);
+    _alias.resize(n);
+    if (n == 0) {
+      return;
+    }
+
+    double total = 0;
+    for (auto w : weights) {
+      assert(w >= 0 && "Weights cannot be negative.");
+      total += w;
+    }
+
+    if (total <= 0) {
+      // Sample uniformly.
+      for (size_t i = 0; i < n; ++i) {
+        _alias[i] = static_cast<uint32_t>(i);
+      }
+      return;
+    }
+
+    std::vector<double> scaled;
+    scaled.reserve(n);
+    for (auto w : weights) {
+      scaled.push_back(w * n / total);
+    }
+
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (size_t i = 0; i < n; ++i) {
+      if (scaled[i] < 1.0) {
+        small.push_back(static_cast<uint32_t>(i));
+      } else {
+        large.push_back(static_cast<uint32_t>(i));
+      }
+    }
+
+    while (!small.empty() && !large.empty()) {
+      auto s = small.back();
+      small.pop_back();
+      auto l = large.back();
+
+      _prob[s] = scaled[s];
+      _alias[s] = l;
+
+      scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+      if (scaled[l] < 1.0) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+
+    // Whatever remains has a probability of 1 up to rounding errors.
+    for (auto i : large) {
+      _prob[i] = 1.0;
+      _alias[i] = i;
+    }
+    for (auto i : small) {
+      _prob[i] = 1.0;
+      _alias[i] = i;
+    }
+  }
+
+  /**
+   * @brief Sample an index from this table.
+   *
+   * The behavior is undefined if this table is empty.
+   *
+   * @tparam RNG type of the random bits generator used by the random number generator.
+   * @param rnd the random number generator.
+   * @return size_t the sampled index.
+   */
+  template <typename RNG>
+  size_t Sample(Random<RNG>& rnd) const {
+    assert(!empty() && "Cannot sample from an empty alias table.");
+    auto column = rnd.template Next<size_t>(0, _prob.size() - 1);
+    if (rnd.template Next<double>() < _prob[column]) {
+      return column;
+    }
+    return _alias[column];
+  }
+
+private:
+  std::vector<double> _prob;
+  std::vector<uint32_t> _alias;
+}; // class AliasTable
+
+} // namespace caf
+
+#endif
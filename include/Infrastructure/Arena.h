@@ -0,0 +1,229 @@
+#ifndef CAF_ARENA_H
+#define CAF_ARENA_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace caf {
+
+/**
+ * @brief A bump pointer allocator.
+ *
+ * Memory is carved out of large chunks allocated from the system allocator. Individual objects are
+ * never freed; instead the whole arena is reset at once by `reset`, which takes O(1) time with
+ * respect to the number of allocated objects. Destructors of objects allocated in the arena are
+ * never run, thus only trivially destructible objects can be created in the arena.
+ *
+ */
+class Arena {
+public:
+  /**
+   * @brief Default size of the first chunk, in bytes.
+   *
+   */
+  constexpr static const size_t DefaultChunkSize = 64 * 1024;
+
+  /**
+   * @brief Construct a new Arena object.
+   *
+   * @param chunkSize size of the first chunk, in bytes. Later chunks double in size until they reach
+   * `MaxChunkSize`.
+   */
+  explicit Arena(size_t chunkSize = DefaultChunkSize)
+    : _chunks(),
+      _curr(nullptr),
+      _end(nullptr),
+      _initialChunkSize(chunkSize),
+      _nextChunkSize(chunkSize),
+      _bytesAllocated(0)
+  { }
+
+  Arena(const Arena &) = delete;
+  Arena(Arena &&) noexcept = default;
+
+  Arena& operator=(const Arena &) = delete;
+  Arena& operator=(Arena &&) = default;
+
+  /**
+   * @brief Allocate a block of uninitialized memory.
+   *
+   * @param size size of the memory block, in bytes.
+   * @param align alignment of the memory block. Must be a power of 2.
+   * @return void* pointer to the allocated memory block.
+   */
+  void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    assert((align & (align - 1)) == 0 && "align must be a power of 2.");
+    auto p = AlignUp(_curr, align);
+    if (!_curr || p + size > _end) {
+      NewChunk(size + align);
+      p = AlignUp(_curr, align);
+    }
+
+    _curr = p + size;
+    _bytesAllocated += size;
+    return p;
+  }
+
+  /**
+   * @brief Create an object of type T in the arena.
+   *
+   * @tparam T type of the object. It must be trivially destructible since its destructor will never
+   * be called.
+   * @tparam Args types of arguments to the constructor of T.
+   * @param args arguments to the constructor of T.
+   * @return T* pointer to the created object.
+   */
+  template <typename T, typename ...Args>
+  T* Create(Args&&... args) {
+    static_assert(std::is_trivially_destructible<T>::value,
+        "Objects allocated in arenas must be trivially destructible.");
+    auto memory = Allocate(sizeof(T), alignof(T));
+    return new (memory) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Allocate an uninitialized array of objects of type T in the arena.
+   *
+   * @tparam T type of the array elements. It must be trivially destructible.
+   * @param count the number of elements.
+   * @return T* pointer to the first element of the array.
+   */
+  template <typename T>
+  T* AllocateArray(size_t count) {
+    static_assert(std::is_trivially_destructible<T>::value,
+        "Objects allocated in arenas must be trivially destructible.");
+    if (count == 0) {
+      return nullptr;
+    }
+    return static_cast<T *>(Allocate(sizeof(T) * count, alignof(T)));
+  }
+
+  /**
+   * @brief Copy the given characters into the arena. The copied characters are followed by a null
+   * terminator.
+   *
+   * @param s pointer to the first character.
+   * @param length the number of characters.
+   * @return char* pointer to the copied characters.
+   */
+  char* CopyString(const char* s, size_t length) {
+    auto buffer = static_cast<char *>(Allocate(length + 1, 1));
+    if (length) {
+      std::memcpy(buffer, s, length);
+    }
+    buffer[length] = 0;
+    return buffer;
+  }
+
+  /**
+   * @brief Release all memory allocated in this arena.
+   *
+   * The largest chunk is retained for later allocations so that an arena that is reset
+   * repeatedly does not go back to the system allocator. All other chunks are released.
+   *
+   */
+  void reset() {
+    _bytesAllocated = 0;
+    if (_chunks.empty()) {
+      return;
+    }
+
+    auto largest = std::max_element(_chunks.begin(), _chunks.end(),
+        [] (const Chunk& lhs, const Chunk& rhs) { return lhs.Size < rhs.Size; });
+    if (largest != _chunks.begin()) {
+      std::swap(*largest, _chunks.front());
+    }
+    _chunks.erase(_chunks.begin() + 1, _chunks.end());
+
+    auto& chunk = _chunks.front();
+    _curr = chunk.Memory.get();
+    _end = _curr + chunk.Size;
+    _nextChunkSize = ClampChunkSize(std::max(_initialChunkSize, chunk.Size * 2));
+  }
+
+  /**
+   * @brief Release all memory allocated in this arena and return all chunks to the system allocator.
+   *
+   */
+  void release() {
+    _chunks.clear();
+    _curr = nullptr;
+    _end = nullptr;
+    _nextChunkSize = _initialChunkSize;
+    _bytesAllocated = 0;
+  }
+
+  /**
+   * @brief Get the number of bytes allocated from this arena since the last reset.
+   *
+   * @return size_t the number of bytes allocated.
+   */
+  size_t GetBytesAllocated() const { return _bytesAllocated; }
+
+  /**
+   * @brief Get the number of bytes reserved by this arena from the system allocator.
+   *
+   * @return size_t the number of bytes reserved.
+   */
+  size_t GetBytesReserved() const {
+    size_t total = 0;
+    for (const auto& chunk : _chunks) {
+      total += chunk.Size;
+    }
+    return total;
+  }
+
+private:
+  /**
+   * @brief Maximum size of automatically sized chunks, in bytes.
+   *
+   */
+  constexpr static const size_t MaxChunkSize = 16 * 1024 * 1024;
+
+  struct Chunk {
+    explicit Chunk(size_t size)
+      : Memory(new uint8_t[size]), Size(size)
+    { }
+
+    std::unique_ptr<uint8_t[]> Memory;
+    size_t Size;
+  }; // struct Chunk
+
+  std::vector<Chunk> _chunks;
+  uint8_t* _curr;
+  uint8_t* _end;
+  size_t _initialChunkSize;
+  size_t _nextChunkSize;
+  size_t _bytesAllocated;
+
+  static size_t ClampChunkSize(size_t size) {
+    // Do not use std::min here since it would odr-use MaxChunkSize.
+    return size < MaxChunkSize ? size : MaxChunkSize;
+  }
+
+  static uint8_t* AlignUp(uint8_t* p, size_t align) {
+    auto addr = reinterpret_cast<uintptr_t>(p);
+    return reinterpret_cast<uint8_t *>((addr + align - 1) & ~(static_cast<uintptr_t>(align) - 1));
+  }
+
+  void NewChunk(size_t minSize) {
+    auto size = std::max(_nextChunkSize, minSize);
+    _chunks.emplace_back(size);
+    _curr = _chunks.back().Memory.get();
+    _end = _curr + size;
+    _nextChunkSize = ClampChunkSize(_nextChunkSize * 2);
+  }
+}; // class Arena
+
+} // namespace caf
+
+#endif
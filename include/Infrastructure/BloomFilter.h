@@ -0,0 +1,123 @@
+#ifndef CAF_BLOOM_FILTER_H
+#define CAF_BLOOM_FILTER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace caf {
+
+/**
+ * @brief A Bloom filter over 64-bit hash values that remembers recently inserted values.
+ *
+ * The filter keeps two generations of bits. Values are inserted into the current generation and
+ * looked up in both generations. When the current generation holds `capacity` values, it becomes the
+ * previous generation and a new, empty generation is started. Thus the filter remembers at least the
+ * last `capacity` inserted values, and the false positive rate stays bounded no matter how many
+ * values are inserted in total.
+ *
+ * The inserted values should already be well-distributed hash values; the bit positions are derived
+ * from them by double hashing.
+ *
+ */
+class BloomFilter {
+public:
+  /**
+   * @brief Construct a new BloomFilter object.
+   *
+   * @param bitsCount the number of bits in each generation. Must be a power of 2.
+   * @param hashesCount the number of bits set for each value.
+   * @param capacity the number of values inserted into a generation before it is retired.
+   */
+  explicit BloomFilter(size_t bitsCount, size_t hashesCount, size_t capacity)
+    : _current(bitsCount / 64),
+      _previous(bitsCount / 64),
+      _mask(bitsCount - 1),
+      _hashesCount(hashesCount),
+      _capacity(capacity),
+      _size(0)
+  {
+    assert(bitsCount >= 64 && (bitsCount & (bitsCount - 1)) == 0 &&
+           "bitsCount must be a power of 2 that is not less than 64.");
+    assert(hashesCount > 0 && "hashesCount must be positive.");
+  }
+
+  BloomFilter(const BloomFilter &) = delete;
+  BloomFilter(BloomFilter &&) noexcept = default;
+
+  BloomFilter& operator=(const BloomFilter &) = delete;
+  BloomFilter& operator=(BloomFilter &&) = default;
+
+  /**
+   * @brief Insert the given hash value into the filter.
+   *
+   * @param hash the hash value.
+   */
+  void Insert(uint64_t hash) {
+    if (_size == _capacity) {
+      std::swap(_current, _previous);
+      std::fill(_current.begin(), _current.end(), 0);
+      _size = 0;
+    }
+
+    auto step = GetStep(hash);
+    for (size_t i = 0; i < _hashesCount; ++i, hash += step) {
+      auto bit = hash & _mask;
+      _current[bit / 64] |= static_cast<uint64_t>(1) << (bit % 64);
+    }
+    ++_size;
+  }
+
+  /**
+   * @brief Determine whether the given hash value may have been inserted recently.
+   *
+   * @param hash the hash value.
+   * @return true if the hash value may have been inserted. This can be a false positive.
+   * @return false if the hash value has definitely not been inserted since the previous generation
+   * started.
+   */
+  bool MayContain(uint64_t hash) const {
+    return Test(_current, hash) || Test(_previous, hash);
+  }
+
+  /**
+   * @brief Remove all values from the filter.
+   *
+   */
+  void clear() {
+    std::fill(_current.begin(), _current.end(), 0);
+    std::fill(_previous.begin(), _previous.end(), 0);
+    _size = 0;
+  }
+
+private:
+  std::vector<uint64_t> _current;
+  std::vector<uint64_t> _previous;
+  uint64_t _mask;
+  size_t _hashesCount;
+  size_t _capacity;
+  size_t _size; // Number of values inserted into the current generation.
+
+  static uint64_t GetStep(uint64_t hash) {
+    // An odd step visits distinct bits for up to `bitsCount` probes.
+    return ((hash >> 32) | (hash << 32)) | 1;
+  }
+
+  bool Test(const std::vector<uint64_t>& bits, uint64_t hash) const {
+    auto step = GetStep(hash);
+    for (size_t i = 0; i < _hashesCount; ++i, hash += step) {
+      auto bit = hash & _mask;
+      if (!(bits[bit / 64] & (static_cast<uint64_t>(1) << (bit % 64)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+}; // class BloomFilter
+
+} // namespace caf
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef CAF_BUFFER_READER_H
+#define CAF_BUFFER_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace caf {
+
+/**
+ * @brief A non-virtual reader over a byte buffer.
+ *
+ * Unlike MemoryInputStream, all functions of BufferReader can be inlined and `ReadBytes` returns a
+ * pointer into the underlying buffer instead of copying. Reads past the end of the buffer yield zero
+ * bytes and put the reader into the failed state.
+ *
+ */
+class BufferReader {
+public:
+  /**
+   * @brief Construct a new BufferReader object.
+   *
+   * @param data pointer to the underlying buffer.
+   * @param size size of the underlying buffer, in bytes.
+   */
+  explicit BufferReader(const uint8_t* data, size_t size)
+    : _ptr(data), _end(data + size), _lastReadSize(0), _fail(false)
+  { }
+
+  /**
+   * @brief Determine whether any read has run past the end of the buffer.
+   *
+   * @return true if any read has run past the end of the buffer.
+   * @return false if all reads are satisfied by the buffer.
+   */
+  bool fail() const { return _fail; }
+
+  /**
+   * @brief Get the number of bytes that have not been read yet.
+   *
+   * @return size_t the number of remaining bytes.
+   */
+  size_t remaining() const { return static_cast<size_t>(_end - _ptr); }
+
+  /**
+   * @brief Get a pointer to the first byte that has not been read yet.
+   *
+   * @return const uint8_t* pointer to the first unread byte.
+   */
+  const uint8_t* position() const { return _ptr; }
+
+  /**
+   * @brief Read a single byte.
+   *
+   * @return uint8_t the byte read, or 0 if the end of the buffer is reached.
+   */
+  uint8_t ReadByte() {
+    if (_ptr == _end) {
+      _fail = true;
+      return 0;
+    }
+    return *_ptr++;
+  }
+
+  /**
+   * @brief Copy raw bytes out of the buffer. Bytes past the end of the buffer are zero-filled.
+   *
+   * @param buffer pointer to the buffer to hold the data read.
+   * @param size the number of bytes to read.
+   */
+  void Read(void* buffer, size_t size) {
+    auto available = ReadBytes(size);
+    std::memcpy(buffer, available, _lastReadSize);
+    if (_lastReadSize < size) {
+      std::memset(static_cast<uint8_t *>(buffer) + _lastReadSize, 0, size - _lastReadSize);
+    }
+  }
+
+  /**
+   * @brief Read a trivially copyable object with an unaligned load.
+   *
+   * @tparam T type of the object.
+   * @return T the object read.
+   */
+  template <typename T>
+  T ReadUnaligned() {
+    static_assert(std::is_trivially_copyable<T>::value, "T is not trivially copyable.");
+    T value;
+    if (remaining() >= sizeof(T)) {
+      std::memcpy(&value, _ptr, sizeof(T));
+      _ptr += sizeof(T);
+    } else {
+      Read(&value, sizeof(T));
+    }
+    return value;
+  }
+
+  /**
+   * @brief Skip the given number of bytes and return a pointer to them without copying.
+   *
+   * If fewer bytes remain, all remaining bytes are skipped and the reader is put into the failed
+   * state; use `GetLastReadSize` to get the number of bytes actually available.
+   *
+   * @param size the number of bytes to read.
+   * @return const uint8_t* pointer to the bytes in the underlying buffer.
+   */
+  const uint8_t* ReadBytes(size_t size) {
+    auto p = _ptr;
+    if (size > remaining()) {
+      _fail = true;
+      size = remaining();
+    }
+    _ptr += size;
+    _lastReadSize = size;
+    return p;
+  }
+
+  /**
+   * @brief Get the number of bytes actually returned by the last call to `ReadBytes`.
+   *
+   * @return size_t the number of bytes.
+   */
+  size_t GetLastReadSize() const { return _lastReadSize; }
+
+private:
+  const uint8_t* _ptr;
+  const uint8_t* _end;
+  size_t _lastReadSize;
+  bool _fail;
+}; // class BufferReader
+
+} // namespace caf
+
+#endif
@@ -39,86 +39,89 @@ struct propergate_cv<const volatile From, To> {
 };
 
 /**
- * @brief Perform pointer-based runtime type cast downwards.
+ * @brief Determine whether the type of the given object derives from the specified type.
  *
- * @tparam To the target type.
- * @tparam From the source type.
- * @param from the source pointer.
- * @return propergate_cv<From, To>::Type* the output pointer. If `From` cannot be casted to `To`,
- * this function will trigger an assertion failure.
+ * The runtime type check is performed by the static `classof` member function of `To`, which
+ * accepts a pointer to `From` and returns whether the pointed-to object is an instance of `To`. This
+ * follows the convention of LLVM-style RTTI and does not require the types to be polymorphic.
+ *
+ * @tparam To the specified type to be checked against.
+ * @tparam From the static type of the object pointed to by the given pointer. `From` should be a
+ * base class of `To`.
+ * @param from the pointer.
+ * @return true if the object's type derives from type `To`.
+ * @return false if the object's type does not derive from type `To`.
  */
 template <typename To, typename From>
-inline auto dyn_cast(From* from) -> typename propergate_cv<From, To>::Type * {
+inline bool is_a(From* from) {
   // Check that To derives from From.
   static_assert(std::is_base_of<From, To>::value, "To does not derive from From.");
 
 #ifdef CAF_LLVM
-  return llvm::cast<To>(from);
+  return llvm::isa<To>(from);
 #else
-  auto ret = dynamic_cast<typename propergate_cv<From, To>::Type *>(from);
-  assert(ret && "Cannot cast from From to To.");
-  return ret;
+  return To::classof(from);
 #endif
 }
 
+/**
+ * @brief Determine whether the type of the given object derives from the specified type.
+ *
+ * @tparam To the specified type to be checked against.
+ * @tparam From the static type of the object pointed to by the given pointer. `From` should be a
+ * base class of `To`.
+ * @param from the pointer.
+ * @return true if the object's type derives from type `To`.
+ * @return false if the object's type does not derive from type `To`.
+ */
+template <typename To, typename From>
+inline bool is_a(From& from) {
+  return is_a<To>(&from);
+}
+
 /**
  * @brief Perform pointer-based runtime type cast downwards.
  *
- * @tparam To the target type.
+ * @tparam To the target type. It should provide a static `classof` member function, see `is_a`.
  * @tparam From the source type.
  * @param from the source pointer.
  * @return propergate_cv<From, To>::Type* the output pointer. If `From` cannot be casted to `To`,
- * the behavior is not defined.
+ * this function will trigger an assertion failure.
  */
 template <typename To, typename From>
-inline auto dyn_cast(From& from) -> typename propergate_cv<From, To>::Type & {
+inline auto dyn_cast(From* from) -> typename propergate_cv<From, To>::Type * {
   // Check that To derives from From.
   static_assert(std::is_base_of<From, To>::value, "To does not derive from From.");
 
 #ifdef CAF_LLVM
   return llvm::cast<To>(from);
 #else
-  return dynamic_cast<typename propergate_cv<From, To>::Type &>(from);
+  assert(is_a<To>(from) && "Cannot cast from From to To.");
+  return static_cast<typename propergate_cv<From, To>::Type *>(from);
 #endif
 }
 
 /**
- * @brief Determine whether the type of the given object derives from the specified type.
+ * @brief Perform pointer-based runtime type cast downwards.
  *
- * @tparam To the specified type to be checked against.
- * @tparam From the static type of the object pointed to by the given pointer. `From` should be a
- * base class of `To`.
- * @param from the pointer.
- * @return true if the object's type derives from type `To`.
- * @return false if the object's type does not derive from type `To`.
+ * @tparam To the target type.
+ * @tparam From the source type.
+ * @param from the source pointer.
+ * @return propergate_cv<From, To>::Type& the output reference. If `From` cannot be casted to `To`,
+ * this function will trigger an assertion failure.
  */
 template <typename To, typename From>
-inline bool is_a(From* from) {
+inline auto dyn_cast(From& from) -> typename propergate_cv<From, To>::Type & {
   // Check that To derives from From.
   static_assert(std::is_base_of<From, To>::value, "To does not derive from From.");
 
 #ifdef CAF_LLVM
-  return llvm::isa<To>(from);
+  return llvm::cast<To>(from);
 #else
-  return static_cast<bool>(dyn_cast<To>(from));
+  return *dyn_cast<To>(&from);
 #endif
 }
 
-/**
- * @brief Determine whether the type of the given object derives from the specified type.
- *
- * @tparam To the specified type to be checked against.
- * @tparam From the static type of the object pointed to by the given pointer. `From` should be a
- * base class of `To`.
- * @param from the pointer.
- * @return true if the object's type derives from type `To`.
- * @return false if the object's type does not derive from type `To`.
- */
-template <typename To, typename From>
-inline bool is_a(From& from) {
-  return is_a<To>(&from);
-}
-
 template <size_t OutputSize, bool IsSigned>
 struct MakeIntegralType { }; // struct MakeIntegralType
 
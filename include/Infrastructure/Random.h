@@ -13,6 +13,9 @@ namespace caf {
 /**
  * @brief Generate random number sequence.
  *
+ * Thread safety: a random number generator is not thread-safe. Each thread should own its random
+ * number generator, seeded differently.
+ *
  * @tparam std::default_random_engine the type of the underlying random number generator.
  */
 template <typename RNG = std::default_random_engine>
@@ -126,6 +126,9 @@ private:
  * @brief An input stream interface around a byte buffer. All data read from this stream will be
  * read from the underlying buffer.
  *
+ * Reads past the end of the buffer zero-fill the bytes that are not available and put the stream
+ * into the failed state.
+ *
  */
 class MemoryInputStream : public InputStream {
 public:
@@ -136,22 +139,35 @@ public:
    * @param size size of the underlying buffer, in bytes.
    */
   explicit MemoryInputStream(const uint8_t* ptr, size_t size)
-    : _ptr(ptr), _end(ptr + size)
+    : _ptr(ptr), _end(ptr + size), _fail(false)
   { }
 
   void Read(void *buffer, size_t size) override {
     auto availableSize = static_cast<size_t>(_end - _ptr);
     if (size > availableSize) {
+      std::memset(static_cast<uint8_t *>(buffer) + availableSize, 0, size - availableSize);
       size = availableSize;
+      _fail = true;
     }
 
-    std::memcpy(buffer, _ptr, size);
-    _ptr += size;
+    if (size) {
+      std::memcpy(buffer, _ptr, size);
+      _ptr += size;
+    }
   }
 
+  /**
+   * @brief Determine whether any read has run past the end of the buffer.
+   *
+   * @return true if any read has run past the end of the buffer.
+   * @return false if all reads are satisfied by the buffer.
+   */
+  bool fail() const { return _fail; }
+
 private:
   const uint8_t* _ptr;
   const uint8_t* _end;
+  bool _fail;
 }; // class MemoryInputStream
 
 /**
@@ -0,0 +1,125 @@
+#ifndef CAF_STRING_VIEW_H
+#define CAF_STRING_VIEW_H
+
+#include "Infrastructure/Hash.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace caf {
+
+/**
+ * @brief A non-owning reference to a sequence of characters.
+ *
+ * This is a minimal replacement of C++17's `std::string_view`.
+ *
+ */
+class StringView {
+public:
+  using const_iterator = const char *;
+
+  /**
+   * @brief Construct a new empty StringView object.
+   *
+   */
+  StringView()
+    : _data(""), _length(0)
+  { }
+
+  /**
+   * @brief Construct a new StringView object.
+   *
+   * @param data pointer to the first character.
+   * @param length the number of characters.
+   */
+  StringView(const char* data, size_t length)
+    : _data(data), _length(length)
+  { }
+
+  /**
+   * @brief Construct a new StringView object referencing a null-terminated string.
+   *
+   * @param s the null-terminated string.
+   */
+  StringView(const char* s)
+    : _data(s), _length(std::strlen(s))
+  { }
+
+  /**
+   * @brief Construct a new StringView object referencing the content of a std::string.
+   *
+   * @param s the string.
+   */
+  StringView(const std::string& s)
+    : _data(s.data()), _length(s.length())
+  { }
+
+  const char* data() const { return _data; }
+
+  size_t size() const { return _length; }
+
+  size_t length() const { return _length; }
+
+  bool empty() const { return _length == 0; }
+
+  char operator[](size_t index) const {
+    assert(index < _length && "index is out of range.");
+    return _data[index];
+  }
+
+  const_iterator begin() const { return _data; }
+
+  const_iterator end() const { return _data + _length; }
+
+  /**
+   * @brief Copy the referenced characters into a std::string.
+   *
+   * @return std::string the copied string.
+   */
+  std::string str() const { return std::string(_data, _length); }
+
+  bool operator==(const StringView& rhs) const {
+    return _length == rhs._length && (_length == 0 || std::memcmp(_data, rhs._data, _length) == 0);
+  }
+
+  bool operator!=(const StringView& rhs) const { return !(*this == rhs); }
+
+private:
+  const char* _data;
+  size_t _length;
+}; // class StringView
+
+inline bool operator==(const std::string& lhs, const StringView& rhs) {
+  return StringView { lhs } == rhs;
+}
+
+inline bool operator==(const char* lhs, const StringView& rhs) {
+  return StringView { lhs } == rhs;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const StringView& s) {
+  return os.write(s.data(), static_cast<std::streamsize>(s.length()));
+}
+
+template <>
+struct Hasher<StringView> {
+  size_t operator()(const StringView& s) const {
+    // FNV-1a.
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (auto ch : s) {
+      hash ^= static_cast<uint8_t>(ch);
+      hash *= 0x100000001b3ULL;
+    }
+    return static_cast<size_t>(hash);
+  }
+}; // struct Hasher<StringView>
+
+} // namespace caf
+
+#endif
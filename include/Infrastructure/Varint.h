@@ -0,0 +1,108 @@
+#ifndef CAF_VARINT_H
+#define CAF_VARINT_H
+
+#include "Infrastructure/Stream.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace caf {
+
+/**
+ * @brief Maximum number of bytes in the LEB128 encoding of a 64-bit unsigned integer.
+ *
+ */
+constexpr static const size_t MaxVarintSize = 10;
+
+/**
+ * @brief Get the number of bytes in the LEB128 encoding of the given unsigned integer.
+ *
+ * @param value the unsigned integer.
+ * @return size_t the number of bytes in the encoding.
+ */
+inline size_t GetVarintSize(uint64_t value) {
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+/**
+ * @brief Encode the given unsigned integer into the given buffer in LEB128 encoding.
+ *
+ * @param value the unsigned integer.
+ * @param buffer the buffer. It should be able to hold at least `MaxVarintSize` bytes.
+ * @return size_t the number of bytes written into the buffer.
+ */
+inline size_t EncodeVarint(uint64_t value, uint8_t* buffer) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+/**
+ * @brief Write the given unsigned integer into the given output stream in LEB128 encoding.
+ *
+ * @param out the output stream.
+ * @param value the unsigned integer.
+ */
+inline void WriteVarint(OutputStream& out, uint64_t value) {
+  uint8_t buffer[MaxVarintSize];
+  auto size = EncodeVarint(value, buffer);
+  out.Write(buffer, size);
+}
+
+/**
+ * @brief Read an unsigned integer in LEB128 encoding from the given input.
+ *
+ * At most `MaxVarintSize` bytes are consumed from the input; excess bits of overlong encodings are
+ * discarded.
+ *
+ * @tparam Input type of the input. It should provide a `uint8_t ReadByte()` member function, e.g.
+ * InputStream and BufferReader.
+ * @param in the input.
+ * @return uint64_t the unsigned integer read.
+ */
+template <typename Input>
+uint64_t ReadVarint(Input& in) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < MaxVarintSize; ++i) {
+    auto b = in.ReadByte();
+    value |= static_cast<uint64_t>(b & 0x7F) << (7 * i);
+    if (!(b & 0x80)) {
+      break;
+    }
+  }
+  return value;
+}
+
+/**
+ * @brief Map the given signed integer to an unsigned integer such that integers with small absolute
+ * values are mapped to small unsigned integers.
+ *
+ * @param value the signed integer.
+ * @return uint64_t the zig-zag encoded integer.
+ */
+inline uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Inverse of `ZigZagEncode`.
+ *
+ * @param value the zig-zag encoded integer.
+ * @return int64_t the signed integer.
+ */
+inline int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // namespace caf
+
+#endif
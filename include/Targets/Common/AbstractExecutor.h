@@ -1,7 +1,10 @@
 #ifndef CAF_ABSTRACT_EXECUTOR_H
 #define CAF_ABSTRACT_EXECUTOR_H
 
+#include "Basic/ReturnKindFeedback.h"
+
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 namespace caf {
@@ -34,18 +37,98 @@ public:
   virtual ValueType Invoke(
       ValueType function, ValueType receiver, bool isCtorCall, std::vector<ValueType>& args) = 0;
 
+  /**
+   * @brief Classify the given value returned by an API function call into a ReturnKind.
+   *
+   * The default implementation returns `ReturnKind::Unknown`, which disables return kind feedback
+   * for the target.
+   *
+   * @param value the value to classify.
+   * @return ReturnKind the return kind of the value.
+   */
+  virtual ReturnKind ClassifyValue(ValueType value) const { return ReturnKind::Unknown; }
+
+  /**
+   * @brief Run the given function, which parses and executes a single test case, in a fresh
+   * target-specific scope.
+   *
+   * In persistent mode many test cases are executed in the same process, one call to this function
+   * per test case. Implementations should release all target values created by `body` and undo
+   * per-test-case changes to the target state after `body` returns. The default implementation
+   * just calls `body`.
+   *
+   * @param body the function that parses and executes the test case.
+   */
+  virtual void RunInTestCaseScope(const std::function<void()>& body) { body(); }
+
+  /**
+   * @brief Called before the API function with the given ID is invoked by `Invoke`.
+   *
+   * Implementations may start a time budget for the call here. The default implementation does
+   * nothing.
+   *
+   * @param funcId ID of the function about to be called.
+   */
+  virtual void BeginCall(uint32_t funcId) { }
+
+  /**
+   * @brief Called after `Invoke` returns. Implementations that enforce a time budget should call
+   * `SetLastCallTimedOut` here. The default implementation does nothing.
+   *
+   */
+  virtual void EndCall() { }
+
+  /**
+   * @brief Determine whether the last API function call made by `Invoke` threw an exception.
+   *
+   * @return true if the last API function call threw an exception.
+   * @return false if the last API function call returned normally.
+   */
+  bool LastCallThrew() const { return _lastCallThrew; }
+
+  /**
+   * @brief Determine whether the last API function call was terminated because it ran out of its
+   * time budget.
+   *
+   * @return true if the last API function call timed out.
+   * @return false if the last API function call finished in time.
+   */
+  bool LastCallTimedOut() const { return _lastCallTimedOut; }
+
 protected:
   /**
    * @brief Construct a new AbstractExecutor object.
    *
    */
-  explicit AbstractExecutor() = default;
+  explicit AbstractExecutor()
+    : _lastCallThrew(false),
+      _lastCallTimedOut(false)
+  { }
 
   AbstractExecutor(const AbstractExecutor<TargetTraits> &) = delete;
   AbstractExecutor(AbstractExecutor<TargetTraits> &&) noexcept = default;
 
   AbstractExecutor<TargetTraits>& operator=(const AbstractExecutor<TargetTraits> &) = delete;
   AbstractExecutor<TargetTraits>& operator=(AbstractExecutor<TargetTraits> &&) = default;
+
+  /**
+   * @brief Set whether the last API function call threw an exception. Implementations of `Invoke`
+   * should call this function before returning.
+   *
+   * @param threw whether the last API function call threw an exception.
+   */
+  void SetLastCallThrew(bool threw) { _lastCallThrew = threw; }
+
+  /**
+   * @brief Set whether the last API function call timed out.
+   *
+   * @param timedOut whether the last API function call timed out.
+   */
+  void SetLastCallTimedOut(bool timedOut) { _lastCallTimedOut = timedOut; }
+
+private:
+  bool _lastCallThrew;
+  bool _lastCallTimedOut;
 }; // class AbstractExecutor
 
 } // namespace caf
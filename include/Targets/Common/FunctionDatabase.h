@@ -8,15 +8,41 @@
 #include "Targets/Common/PropertyResolver.h"
 
 #include <cassert>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace caf {
 
+/**
+ * @brief When the functions added by `FunctionDatabase::Populate` are resolved.
+ *
+ */
+enum class FunctionResolution : uint8_t {
+  // All functions are resolved by `Populate`.
+  Eager,
+
+  // Each function is resolved by the first `GetFunction` call that asks for it.
+  Lazy,
+
+  // Like Lazy, but the target also resolves the functions referenced by each test case before
+  // running it, outside the executor's per-test-case scope. Targets whose function objects are
+  // handles bound to that scope, e.g. V8, should use this mode instead of Lazy.
+  Prefetch,
+}; // enum class FunctionResolution
+
 /**
  * @brief Provide a mapping from function ID to function objects.
  *
+ * Functions are resolved by walking a trie of property names, which shares the resolution of common
+ * name prefixes. The resolved function objects are stored in a dense table indexed by function ID,
+ * so `GetFunction` is a bounds check and an array access once the function is resolved. Functions
+ * can be declared without being resolved; they are then resolved on first use and memoized. After
+ * `Freeze` is called the trie is released and no more functions can be added.
+ *
  * @tparam TargetTraits the trait type describing target's type system.
  */
 template <typename TargetTraits>
@@ -34,7 +60,10 @@ public:
     : _resolver(resolver),
       _global(global),
       _root(caf::make_unique<TrieNode>(global)),
-      _funcIdToNode()
+      _funcs(),
+      _names(),
+      _resolution(FunctionResolution::Eager),
+      _component()
   { }
 
   FunctionDatabase(const FunctionDatabase<TargetTraits> &) = delete;
@@ -50,40 +79,125 @@ public:
    * @param name name of the function.
    */
   void AddFunction(uint32_t funcId, const std::string& name) {
+    assert(_root && "Cannot add functions to a frozen function database.");
+
     auto node = GetNode(name);
     if (!node) {
       PRINT_ERR_AND_EXIT_FMT("funcdb: Cannot find function \"%s\"\n", name.c_str());
     }
 
-    _funcIdToNode[funcId] = node;
+    auto& entry = GetEntry(funcId);
+    entry.Value = node->value();
+    entry.State = EntryState::Resolved;
+  }
+
+  /**
+   * @brief Associate the given function ID with the function whose name is `name`, without resolving
+   * the function until it is first requested.
+   *
+   * @param funcId the function ID.
+   * @param name name of the function.
+   */
+  void DeclareFunction(uint32_t funcId, const std::string& name) {
+    assert(_root && "Cannot add functions to a frozen function database.");
+
+    GetEntry(funcId).State = EntryState::Unresolved;
+    if (funcId >= _names.size()) {
+      _names.resize(static_cast<size_t>(funcId) + 1);
+    }
+    _names[funcId] = name;
   }
 
   /**
    * @brief Add all functions contained in the given CAF metadata database to this function
-   * database.
+   * database. With eager resolution the database is frozen afterwards.
    *
    * @param store the CAF metadata store.
+   * @param resolution when the functions are resolved.
    */
-  void Populate(const CAFStore& store) {
+  void Populate(const CAFStore& store,
+                FunctionResolution resolution = FunctionResolution::Eager) {
+    _resolution = resolution;
+    _funcs.reserve(store.GetFunctionsCount());
     for (const auto& fn : store) {
-      AddFunction(fn.id(), fn.name());
+      if (resolution == FunctionResolution::Eager) {
+        AddFunction(fn.id(), fn.name());
+      } else {
+        DeclareFunction(fn.id(), fn.name());
+      }
+    }
+
+    if (resolution == FunctionResolution::Eager) {
+      Freeze();
     }
   }
 
   /**
-   * @brief Get the function with the given function ID.
+   * @brief Get when the functions added by `Populate` are resolved.
+   *
+   * @return FunctionResolution the resolution mode.
+   */
+  FunctionResolution resolution() const { return _resolution; }
+
+  /**
+   * @brief Resolve all declared functions and release the resolution trie. No more functions can be
+   * added afterwards.
+   *
+   */
+  void Freeze() {
+    for (uint32_t funcId = 0; funcId < _funcs.size(); ++funcId) {
+      if (_funcs[funcId].State == EntryState::Unresolved) {
+        Resolve(funcId);
+      }
+    }
+
+    _root.reset();
+    _funcs.shrink_to_fit();
+    std::vector<std::string>().swap(_names);
+  }
+
+  /**
+   * @brief Resolve the given functions if they have been declared but not resolved yet.
+   *
+   * @param funcIds the function IDs. Unknown IDs and duplicates are ignored.
+   */
+  void Prefetch(const std::vector<uint32_t>& funcIds) {
+    for (auto funcId : funcIds) {
+      if (funcId < _funcs.size() && _funcs[funcId].State == EntryState::Unresolved) {
+        Resolve(funcId);
+      }
+    }
+  }
+
+  /**
+   * @brief Determine whether a function with the given function ID exists. Declared functions exist
+   * even if they have not been resolved yet.
+   *
+   * @param funcId the function ID.
+   * @return true if the function exists.
+   * @return false if the function does not exist.
+   */
+  bool HasFunction(uint32_t funcId) const {
+    return funcId < _funcs.size() && _funcs[funcId].State != EntryState::Absent;
+  }
+
+  /**
+   * @brief Get the function with the given function ID, resolving it first if it has been declared
+   * but not resolved yet.
    *
    * @param funcId the function ID.
    * @return Optional<ValueType> the function object.
    */
-  Optional<ValueType> GetFunction(uint32_t funcId) const {
-    auto i = _funcIdToNode.find(funcId);
-    if (i == _funcIdToNode.end()) {
+  Optional<ValueType> GetFunction(uint32_t funcId) {
+    if (!HasFunction(funcId)) {
       return Optional<ValueType> { };
     }
 
-    auto node = i->second;
-    return Optional<ValueType> { node->value() };
+    auto& entry = _funcs[funcId];
+    if (entry.State == EntryState::Unresolved) {
+      Resolve(funcId);
+    }
+    return Optional<ValueType> { entry.Value };
   }
 
 private:
@@ -125,12 +239,49 @@ private:
     std::unordered_map<std::string, std::unique_ptr<TrieNode>> _children;
   };
 
+  enum class EntryState : uint8_t {
+    Absent,
+    Unresolved,
+    Resolved,
+  }; // enum class EntryState
+
+  struct FunctionEntry {
+    ValueType Value;
+    EntryState State;
+
+    FunctionEntry()
+      : Value(), State(EntryState::Absent)
+    { }
+  }; // struct FunctionEntry
+
   PropertyResolver<TargetTraits>& _resolver;
   ValueType _global;
-  std::unique_ptr<TrieNode> _root;
-  std::unordered_map<uint32_t, TrieNode *> _funcIdToNode;
+  std::unique_ptr<TrieNode> _root; // Released by Freeze.
+  std::vector<FunctionEntry> _funcs; // Indexed by function ID.
+  std::vector<std::string> _names; // Names of unresolved functions, indexed by function ID.
+  FunctionResolution _resolution;
+  std::string _component; // Scratch buffer for name components.
+
+  FunctionEntry& GetEntry(uint32_t funcId) {
+    if (funcId >= _funcs.size()) {
+      _funcs.resize(static_cast<size_t>(funcId) + 1);
+    }
+    return _funcs[funcId];
+  }
+
+  void Resolve(uint32_t funcId) {
+    auto& name = _names[funcId];
+    auto node = GetNode(name);
+    if (!node) {
+      PRINT_ERR_AND_EXIT_FMT("funcdb: Cannot find function \"%s\"\n", name.c_str());
+    }
+
+    _funcs[funcId].Value = node->value();
+    _funcs[funcId].State = EntryState::Resolved;
+    std::string().swap(name);
+  }
 
-  TrieNode* GetNode(const std::string& name) const {
+  TrieNode* GetNode(const std::string& name) {
     auto ptr = _root.get();
     size_t start = 0;
     while (start < name.length()) {
@@ -138,7 +289,8 @@ private:
       if (sepPos == std::string::npos) {
         sepPos = name.length();
       }
-      auto component = name.substr(start, sepPos - start);
+      _component.assign(name, start, sepPos - start);
+      const auto& component = _component;
       start = sepPos + 1;
 
       if (!ptr->HasChild(component)) {
@@ -1,6 +1,10 @@
 #ifndef CAF_ABSTRACT_TARGET_H
 #define CAF_ABSTRACT_TARGET_H
 
+#include "Infrastructure/BufferReader.h"
+#include "Infrastructure/Memory.h"
+#include "Basic/ReturnKindFeedback.h"
+#include "Basic/TestCaseValidator.h"
 #include "Targets/Common/ValueFactory.h"
 #include "Targets/Common/AbstractExecutor.h"
 #include "Targets/Common/FunctionDatabase.h"
@@ -8,15 +12,41 @@
 #include "Targets/Common/TestCaseParser.h"
 
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * @brief Name of the environment variable holding the number of test cases a target process runs in
+ * persistent mode before it exits. Persistent mode is disabled if the variable is not set.
+ *
+ */
+#define CAF_PERSISTENT_ITERATIONS_ENV "CAF_PERSISTENT_ITERATIONS"
+
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+// Defined by `__AFL_FUZZ_INIT()`, which must appear at global scope in exactly one translation unit
+// of the target.
+extern unsigned int* __afl_fuzz_len;
+extern unsigned char* __afl_fuzz_ptr;
+extern unsigned char* __afl_fuzz_alt_ptr;
+#endif
 
 namespace caf {
 
 /**
  * @brief Represent a target.
  *
+ * Thread safety: a target and all its components are bound to the thread that created it. At most
+ * one target instance can exist in each thread at any time, and `GetSingleton` returns the target
+ * instance of the calling thread. Threads running different targets, for example one engine
+ * instance per thread, do not share any state through this class.
+ *
  * @tparam TargetTraits trait type describing the target's type system.
  */
 template <typename TargetTraits>
@@ -38,7 +68,11 @@ public:
     : _factory(std::move(factory)),
       _executor(std::move(executor)),
       _resolver(std::move(resolver)),
-      _funcs(caf::make_unique<FunctionDatabase<TargetTraits>>(*_resolver, global))
+      _funcs(caf::make_unique<FunctionDatabase<TargetTraits>>(*_resolver, global)),
+      _feedback(ReturnKindFeedback::OpenFromEnv()),
+      _validator(),
+      _prefetchFuncIds(),
+      _input()
   {
     assert(_factory && "factory cannot be null.");
     assert(_executor && "executor cannot be null.");
@@ -47,6 +81,18 @@ public:
     Singleton = this;
   }
 
+  Target(const Target &) = delete;
+  Target(Target &&) = delete;
+
+  Target& operator=(const Target &) = delete;
+  Target& operator=(Target &&) = delete;
+
+  ~Target() {
+    if (Singleton == this) {
+      Singleton = nullptr;
+    }
+  }
+
   /**
    * @brief Get the target-specific factory.
    *
@@ -75,21 +121,116 @@ public:
    */
   FunctionDatabase<TargetTraits>& functions() const { return *_funcs; }
 
+  /**
+   * @brief Get the return kind feedback opened from the `CAF_FEEDBACK_FILE` environment variable.
+   *
+   * @return ReturnKindFeedback* the return kind feedback, or nullptr if feedback is disabled.
+   */
+  ReturnKindFeedback* feedback() const { return _feedback.get(); }
+
   /**
    * @brief Run the target.
    *
+   * If the `CAF_PERSISTENT_ITERATIONS` environment variable is set, the target runs in persistent
+   * mode for that many test cases; see `RunPersistent`. Otherwise a single test case is read from
+   * the standard input.
+   *
    */
   void Run() {
-    StlInputStream input { std::cin };
-    TestCaseParser<TargetTraits> parser { *this, input };
-    parser.ParseAndRun();
+    auto iterations = std::getenv(CAF_PERSISTENT_ITERATIONS_ENV);
+    if (iterations) {
+      RunPersistent(static_cast<size_t>(std::strtoull(iterations, nullptr, 10)));
+      return;
+    }
+
+    // The test case is kept alive as long as the target so strings can refer to it.
+    ReadStandardInput(_input);
+    RunTestCase(_input.data(), _input.size(), true);
+  }
+
+  /**
+   * @brief Run the target on many test cases in a single process.
+   *
+   * When the target is built with AFL++'s compiler wrappers and `__AFL_FUZZ_INIT()` is in effect,
+   * each iteration of `__AFL_LOOP` parses the test case directly from AFL++'s shared memory test case
+   * buffer. When only `__AFL_LOOP` is available, each iteration reads a whole test case from the
+   * standard input.
+   *
+   * Otherwise the standard input is a stream of test cases, each preceded by its size as a 32-bit
+   * little endian integer.
+   *
+   * Each test case runs in its own executor scope, see `AbstractExecutor::RunInTestCaseScope`.
+   *
+   * @param iterations the maximum number of test cases to run.
+   */
+  void RunPersistent(size_t iterations) {
+#if defined(__AFL_FUZZ_TESTCASE_LEN)
+    auto buffer = __AFL_FUZZ_TESTCASE_BUF;
+    while (__AFL_LOOP(static_cast<unsigned int>(iterations))) {
+      auto size = static_cast<size_t>(__AFL_FUZZ_TESTCASE_LEN);
+      RunTestCase(buffer, size);
+    }
+#elif defined(__AFL_LOOP)
+    std::vector<uint8_t> testCase;
+    while (__AFL_LOOP(static_cast<unsigned int>(iterations))) {
+      ReadStandardInput(testCase);
+      RunTestCase(testCase.data(), testCase.size());
+    }
+#else
+    std::vector<uint8_t> testCase;
+    size_t size;
+    for (size_t i = 0; i < iterations && ReadTestCaseSize(size); ++i) {
+      testCase.resize(size);
+      if (!std::cin.read(reinterpret_cast<char *>(testCase.data()), size)) {
+        std::fprintf(stderr, "target: truncated test case\n");
+        break;
+      }
+
+      RunTestCase(testCase.data(), testCase.size());
+    }
+#endif
+  }
+
+  /**
+   * @brief Run the target on the given serialized test case.
+   *
+   * The test case is validated as a whole before any function is called. Malformed test cases are
+   * rejected without being executed. If the function database uses `FunctionResolution::Prefetch`,
+   * the functions referenced by the test case are resolved before the executor's test case scope is
+   * entered.
+   *
+   * @param data pointer to the serialized test case.
+   * @param size size of the serialized test case, in bytes.
+   * @param stableInput whether the serialized test case stays alive and unchanged as long as the
+   * target. If so, strings in the test case may be created without copying them.
+   */
+  void RunTestCase(const uint8_t* data, size_t size, bool stableInput = false) {
+    auto prefetch = _funcs->resolution() == FunctionResolution::Prefetch;
+    _prefetchFuncIds.clear();
+
+    if (!_validator.Validate(data, size, prefetch ? &_prefetchFuncIds : nullptr)) {
+      std::fprintf(stderr, "target: malformed test case at offset %zu: %s\n",
+                   _validator.GetOffset(),
+                   GetTestCaseValidationErrorMessage(_validator.GetError()));
+      return;
+    }
+
+    if (prefetch) {
+      _funcs->Prefetch(_prefetchFuncIds);
+    }
+
+    _executor->RunInTestCaseScope([this, data, size, stableInput] {
+      BufferReader input { data, size };
+      TestCaseParser<TargetTraits> parser { *this, input, stableInput };
+      parser.ParseAndRun();
+    });
   }
 
   /**
-   * @brief Get the singleton instance.
+   * @brief Get the singleton instance of the calling thread.
    *
    * @return Target<TargetTraits>* the singleton instance. Returns nullptr if no instances have
-   * been created yet.
+   * been created in the calling thread yet.
    */
   static Target<TargetTraits>* GetSingleton() { return Singleton; }
 
@@ -98,12 +239,50 @@ private:
   std::unique_ptr<AbstractExecutor<TargetTraits>> _executor;
   std::unique_ptr<PropertyResolver<TargetTraits>> _resolver;
   std::unique_ptr<FunctionDatabase<TargetTraits>> _funcs;
+  std::unique_ptr<ReturnKindFeedback> _feedback;
+  TestCaseValidator _validator; // Reused across test cases.
+  std::vector<uint32_t> _prefetchFuncIds; // Function IDs referenced by the current test case.
+  std::vector<uint8_t> _input; // The test case read by a non-persistent run.
+
+  static thread_local Target<TargetTraits>* Singleton;
+
+  /**
+   * @brief Read the whole standard input into the given buffer with bulk reads.
+   *
+   * @param out the buffer into which the data is written. Its previous content is discarded.
+   */
+  static void ReadStandardInput(std::vector<uint8_t>& out) {
+    out.clear();
+    uint8_t buffer[4096];
+    ssize_t size;
+    while ((size = read(STDIN_FILENO, buffer, sizeof(buffer))) > 0) {
+      out.insert(out.end(), buffer, buffer + size);
+    }
+  }
+
+  /**
+   * @brief Read a 32-bit little endian test case size from the standard input.
+   *
+   * @param size receives the size of the test case.
+   * @return true if the size is read.
+   * @return false if the standard input is exhausted.
+   */
+  static bool ReadTestCaseSize(size_t& size) {
+    uint8_t prefix[4];
+    if (!std::cin.read(reinterpret_cast<char *>(prefix), sizeof(prefix))) {
+      return false;
+    }
 
-  static Target<TargetTraits>* Singleton;
+    size = static_cast<size_t>(prefix[0]) |
+           (static_cast<size_t>(prefix[1]) << 8) |
+           (static_cast<size_t>(prefix[2]) << 16) |
+           (static_cast<size_t>(prefix[3]) << 24);
+    return true;
+  }
 }; // class Target
 
 template <typename TargetTraits>
-Target<TargetTraits>* Target<TargetTraits>::Singleton = nullptr;
+thread_local Target<TargetTraits>* Target<TargetTraits>::Singleton = nullptr;
 
 } // namespace caf
 
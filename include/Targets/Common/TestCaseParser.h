@@ -1,17 +1,17 @@
 #ifndef CAF_TEST_CASE_PARSER_H
 #define CAF_TEST_CASE_PARSER_H
 
+#include "Infrastructure/BufferReader.h"
 #include "Infrastructure/Casting.h"
 #include "Infrastructure/Intrinsic.h"
-#include "Infrastructure/Memory.h"
-#include "Infrastructure/Stream.h"
+#include "Infrastructure/Varint.h"
+#include "Basic/TestCaseFormat.h"
 #include "Targets/Common/Diagnostics.h"
 
 #include <cassert>
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
-#include <memory>
 #include <vector>
 #include <type_traits>
 
@@ -23,9 +23,17 @@ class Target;
 /**
  * @brief Parse test cases and execute them.
  *
+ * Both the v1 and the v2 binary formats are accepted; the format of each test case is detected from
+ * its header.
+ *
+ * The parser reads the test case through a non-virtual cursor over the serialized test case held in
+ * memory, so every field read can be inlined. String payloads are passed to the value factory as
+ * pointers into the serialized test case without being copied.
+ *
  * @tparam TargetTraits target trait type describing the target's type system.
+ * @tparam Input type of the cursor. It should provide the member functions of BufferReader.
  */
-template <typename TargetTraits>
+template <typename TargetTraits, typename Input = BufferReader>
 class TestCaseParser {
 public:
   using ValueType = typename TargetTraits::ValueType;
@@ -34,22 +42,33 @@ public:
    * @brief Construct a new TestCaseParser object.
    *
    * @param target the target.
-   * @param in the input stream from which the test cases will be read.
+   * @param in the cursor from which the test cases will be read.
+   * @param stableInput whether the buffer underlying the cursor stays alive and unchanged for as
+   * long as the target runs. If so, strings are created with `ValueFactory::CreateStringView`.
    */
-  explicit TestCaseParser(Target<TargetTraits>& target, InputStream& in)
-    : _target(target), _in(in)
+  explicit TestCaseParser(Target<TargetTraits>& target, Input& in, bool stableInput = false)
+    : _target(target), _in(in), _version(LatestTestCaseFormatVersion), _stableInput(stableInput)
   { }
 
   TestCaseParser(const TestCaseParser &) = delete;
   TestCaseParser(TestCaseParser &&) noexcept = default;
 
   /**
-   * @brief Parse and run a test case from the underlying stream.
+   * @brief Parse and run a test case from the underlying cursor.
    *
    */
   void ParseAndRun() {
     _pool.clear();
-    auto callsCount = ReadInt<size_t, 4>();
+
+    uint8_t header[TestCaseHeaderSize];
+    _in.Read(header, sizeof(header));
+    _version = DetectTestCaseFormat(header);
+    if (_version != TestCaseFormatVersion::V1) {
+      // The header is the root entry index in the v1 format, otherwise skip the root entry index.
+      ReadUInt();
+    }
+
+    auto callsCount = static_cast<size_t>(ReadUInt());
     while (callsCount--) {
       ParseCall();
     }
@@ -57,7 +76,9 @@ public:
 
 private:
   Target<TargetTraits>& _target;
-  InputStream& _in;
+  Input& _in;
+  TestCaseFormatVersion _version; // Format version of the test case being parsed.
+  bool _stableInput; // Whether strings may refer to the input buffer.
 
   std::vector<ValueType> _pool;
 
@@ -67,21 +88,20 @@ private:
     constexpr const bool IsSigned = std::is_signed<Integer>::value;
     using RawType = typename caf::MakeIntegralType<IntSize, IsSigned>::Type;
 
-    uint8_t buffer[IntSize];
-    _in.Read(buffer, IntSize);
-    auto raw = *reinterpret_cast<RawType *>(buffer);
+    return static_cast<Integer>(_in.template ReadUnaligned<RawType>());
+  }
 
-    return static_cast<Integer>(raw);
+  uint64_t ReadUInt() {
+    if (_version == TestCaseFormatVersion::V1) {
+      return ReadInt<uint32_t, 4>();
+    }
+    return ReadVarint(_in);
   }
 
   template <typename Literal>
   Literal ReadLiteral() {
     static_assert(std::is_literal_type<Literal>::value, "Literal is not a literal type.");
-
-    uint8_t buffer[sizeof(Literal)];
-    _in.Read(buffer, sizeof(Literal));
-
-    return *reinterpret_cast<Literal *>(buffer);
+    return _in.template ReadUnaligned<Literal>();
   }
 
   /**
@@ -89,11 +109,11 @@ private:
    *
    */
   void ParseCall() {
-    auto funcId = ReadInt<uint32_t, 4>();
+    auto funcId = static_cast<uint32_t>(ReadUInt());
     auto thisValue = ParseValue();
     auto isCtorCall = ReadInt<uint8_t, 1>();
 
-    auto argsCount = ReadInt<size_t, 4>();
+    auto argsCount = static_cast<size_t>(ReadUInt());
     std::vector<ValueType> args;
     args.reserve(argsCount);
 
@@ -106,8 +126,22 @@ private:
       PRINT_ERR_AND_EXIT_FMT("parser: Cannot find function #%u\n", funcId);
     }
 
-    auto ret = _target.executor().Invoke(function.take(), thisValue, isCtorCall, args);
+    auto& executor = _target.executor();
+    executor.BeginCall(funcId);
+    auto ret = executor.Invoke(function.take(), thisValue, isCtorCall, args);
+    executor.EndCall();
     _pool.push_back(ret);
+
+    if (executor.LastCallTimedOut()) {
+      std::fprintf(stderr, "parser: Function #%u timed out\n", funcId);
+    }
+
+    auto feedback = _target.feedback();
+    if (feedback) {
+      auto failed = executor.LastCallThrew() || executor.LastCallTimedOut();
+      auto kind = failed ? ReturnKind::Threw : executor.ClassifyValue(ret);
+      feedback->Record(funcId, kind);
+    }
   }
 
   /**
@@ -128,7 +162,15 @@ private:
       VK_PLACEHOLDER,
     };
 
-    auto kind = static_cast<ValueKind>(ReadInt<uint8_t, 1>());
+    auto tag = ReadInt<uint8_t, 1>();
+    if (_version != TestCaseFormatVersion::V1) {
+      if (GetValueTagKind(tag) == VK_BOOLEAN) {
+        return _target.factory().CreateBoolean(GetValueTagPayload(tag) != 0);
+      }
+      tag = GetValueTagKind(tag);
+    }
+
+    auto kind = static_cast<ValueKind>(tag);
     switch (kind) {
       case VK_UNDEFINED:
         return _target.factory().CreateUndefined();
@@ -160,20 +202,26 @@ private:
   }
 
   typename TargetTraits::StringType ParseStringValue() {
-    auto size = ReadInt<size_t, 4>();
-    auto buffer = caf::make_unique<uint8_t[]>(size);
-    _in.Read(buffer.get(), size);
-
-    return _target.factory().CreateString(buffer.get(), size);
+    auto size = static_cast<size_t>(ReadUInt());
+    auto data = _in.ReadBytes(size);
+    if (_stableInput) {
+      return _target.factory().CreateStringView(data, _in.GetLastReadSize());
+    }
+    return _target.factory().CreateString(data, _in.GetLastReadSize());
   }
 
   typename TargetTraits::FunctionType ParseFunctionValue() {
-    auto funcId = ReadInt<uint32_t, 4>();
+    auto funcId = static_cast<uint32_t>(ReadUInt());
     return _target.factory().CreateFunction(funcId);
   }
 
   typename TargetTraits::IntegerType ParseIntegerValue() {
-    auto value = ReadInt<int32_t, 4>();
+    int32_t value;
+    if (_version == TestCaseFormatVersion::V1) {
+      value = ReadInt<int32_t, 4>();
+    } else {
+      value = static_cast<int32_t>(ZigZagDecode(ReadVarint(_in)));
+    }
     return _target.factory().CreateInteger(value);
   }
 
@@ -183,7 +231,7 @@ private:
   }
 
   typename TargetTraits::ArrayType ParseArrayValue() {
-    auto size = ReadInt<size_t, 4>();
+    auto size = static_cast<size_t>(ReadUInt());
     auto arrayBuilder = _target.factory().StartBuildArray(size);
     _pool.push_back(arrayBuilder.GetValue());
     for (size_t i = 0; i < size; ++i) {
@@ -194,7 +242,7 @@ private:
   }
 
   typename TargetTraits::ValueType ParsePlaceholderValue() {
-    auto index = ReadInt<size_t, 4>();
+    auto index = static_cast<size_t>(ReadUInt());
     return _pool.at(index);
   }
 }; // class TestCaseParser
@@ -1,6 +1,7 @@
 #ifndef CAF_VALUE_FACTORY_H
 #define CAF_VALUE_FACTORY_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -60,6 +61,19 @@ public:
    */
   virtual StringType CreateString(const uint8_t* buffer, size_t size) = 0;
 
+  /**
+   * @brief Create a target-specific string object that may refer to the given buffer instead of
+   * copying it. The default implementation copies the buffer through `CreateString`.
+   *
+   * @param buffer pointer to the first byte of the buffer containing the string data. The buffer
+   * must stay alive and unchanged for as long as the target may use the created string.
+   * @param size size of the string buffer.
+   * @return StringType the created string object.
+   */
+  virtual StringType CreateStringView(const uint8_t* buffer, size_t size) {
+    return CreateString(buffer, size);
+  }
+
   /**
    * @brief Create a target-specific integer object.
    *
@@ -1,13 +1,28 @@
 #ifndef CAF_V8_EXECUTOR_H
 #define CAF_V8_EXECUTOR_H
 
+#include "Infrastructure/Memory.h"
 #include "Targets/Common/AbstractExecutor.h"
 #include "Targets/V8/V8Traits.h"
+#include "Targets/V8/V8Watchdog.h"
 
 #include "v8.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @brief Name of the environment variable holding the time budget of a single API function call, in
+ * milliseconds. Calls are not timed out if the variable is not set or is 0.
+ *
+ */
+#define CAF_CALL_TIMEOUT_ENV "CAF_CALL_TIMEOUT_MS"
 
 namespace caf {
 
@@ -26,19 +41,157 @@ public:
    */
   explicit V8Executor(
       v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Value> callbackData)
-    : _isolate(isolate), _context(context), _callbackData(callbackData)
-  { }
+    : _isolate(isolate),
+      _context(context),
+      _callbackData(callbackData),
+      _globalNames(),
+      _globalNamesRecorded(false),
+      _watchdog(),
+      _timedOutCallsCount(0)
+  {
+    auto timeout = std::getenv(CAF_CALL_TIMEOUT_ENV);
+    if (timeout) {
+      SetCallTimeout(std::chrono::milliseconds { std::strtoull(timeout, nullptr, 10) });
+    }
+  }
+
+  /**
+   * @brief Set the time budget of a single API function call. Calls running longer are terminated
+   * with `v8::Isolate::TerminateExecution` and execution continues with the next call.
+   *
+   * @param timeout the time budget. A zero budget disables timeouts.
+   */
+  void SetCallTimeout(std::chrono::milliseconds timeout) {
+    _watchdog.reset();
+    if (timeout.count() > 0) {
+      _watchdog = caf::make_unique<V8Watchdog>(_isolate, timeout);
+    }
+  }
+
+  void BeginCall(uint32_t funcId) override {
+    if (_watchdog) {
+      _watchdog->Arm();
+    }
+  }
+
+  void EndCall() override {
+    auto timedOut = _watchdog && _watchdog->Disarm();
+    SetLastCallTimedOut(timedOut);
+    if (timedOut) {
+      ++_timedOutCallsCount;
+    }
+  }
+
+  /**
+   * @brief Get the number of API function calls that have been terminated for running out of their
+   * time budget.
+   *
+   * @return size_t the number of timed out calls.
+   */
+  size_t GetTimedOutCallsCount() const { return _timedOutCallsCount; }
 
+  /**
+   * @brief Call the given function in a `v8::TryCatch`. Exceptions thrown by the call, including
+   * terminations by the watchdog, are caught and reported through `LastCallThrew`.
+   *
+   * @param function the function to call.
+   * @param receiver the receiver.
+   * @param isCtorCall whether this function call should be made as a constructor call.
+   * @param args the arguments to the function.
+   * @return typename V8Traits::ValueType the return value of the call, or `undefined` if the call
+   * threw.
+   */
   typename V8Traits::ValueType Invoke(
       v8::Local<v8::Value> function,
       typename V8Traits::ValueType receiver,
       bool isCtorCall,
-      std::vector<typename V8Traits::ValueType>& args) override;
+      std::vector<typename V8Traits::ValueType>& args) override {
+    if (function.IsEmpty() || !function->IsFunction()) {
+      SetLastCallThrew(true);
+      return v8::Undefined(_isolate);
+    }
+
+    v8::TryCatch tryCatch { _isolate };
+    auto callee = function.As<v8::Function>();
+    auto argc = static_cast<int>(args.size());
+    v8::Local<v8::Value> ret;
+    if (isCtorCall) {
+      ret = callee->NewInstance(_context, argc, args.data()).FromMaybe(v8::Local<v8::Object>());
+    } else {
+      ret = callee->Call(_context, receiver, argc, args.data()).FromMaybe(v8::Local<v8::Value>());
+    }
+
+    auto threw = ret.IsEmpty() || tryCatch.HasCaught();
+    SetLastCallThrew(threw);
+    if (threw) {
+      return v8::Undefined(_isolate);
+    }
+    return ret;
+  }
+
+  ReturnKind ClassifyValue(typename V8Traits::ValueType value) const override {
+    if (value.IsEmpty() || value->IsUndefined()) {
+      return ReturnKind::Undefined;
+    }
+    if (value->IsFunction()) {
+      return ReturnKind::Function;
+    }
+    if (value->IsObject()) {
+      return ReturnKind::Object;
+    }
+    return ReturnKind::Primitive;
+  }
+
+  /**
+   * @brief Run the given function in a handle scope, so that all handles created by the test case
+   * are released when it returns. Global properties added by the test case are deleted afterwards.
+   *
+   * @param body the function that parses and executes the test case.
+   */
+  void RunInTestCaseScope(const std::function<void()>& body) override {
+    v8::HandleScope handleScope { _isolate };
+    if (!_globalNamesRecorded) {
+      ForEachGlobalProperty([this] (const std::string& name, v8::Local<v8::Value>) {
+        _globalNames.insert(name);
+      });
+      _globalNamesRecorded = true;
+    }
+
+    body();
+
+    auto global = _context->Global();
+    ForEachGlobalProperty([this, &global] (const std::string& name, v8::Local<v8::Value> key) {
+      if (!_globalNames.count(name)) {
+        global->Delete(_context, key).FromMaybe(false);
+      }
+    });
+  }
 
 private:
   v8::Isolate* _isolate;
   v8::Local<v8::Context> _context;
   v8::Local<v8::Value> _callbackData;
+  std::unordered_set<std::string> _globalNames; // Names of the global properties before any test case.
+  bool _globalNamesRecorded;
+  std::unique_ptr<V8Watchdog> _watchdog; // Null if calls are not timed out.
+  size_t _timedOutCallsCount;
+
+  template <typename Callback>
+  void ForEachGlobalProperty(Callback callback) {
+    v8::Local<v8::Array> keys;
+    if (!_context->Global()->GetOwnPropertyNames(_context).ToLocal(&keys)) {
+      return;
+    }
+
+    for (uint32_t i = 0; i < keys->Length(); ++i) {
+      v8::Local<v8::Value> key;
+      if (!keys->Get(_context, i).ToLocal(&key)) {
+        continue;
+      }
+      v8::String::Utf8Value name { _isolate, key };
+      callback(std::string { *name, static_cast<size_t>(name.length()) }, key);
+    }
+  }
 }; // class V8Executor
 
 } // namespace caf
@@ -8,6 +8,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace caf {
 
@@ -17,18 +18,28 @@ namespace caf {
  */
 class V8ValueFactory : public ValueFactory<V8Traits> {
 public:
+  /**
+   * @brief Default minimum size of strings created as external strings by `CreateStringView`.
+   *
+   */
+  constexpr static const size_t DefaultExternalStringThreshold = 4096;
+
   /**
    * @brief Construct a new V8ValueFactory object.
    *
    * @param isolate the V8 isolate instance.
    * @param context the context.
    * @param callbackData the embedder's data for callback functions.
+   * @param externalStringThreshold minimum size of strings created as external strings by
+   * `CreateStringView`. Smaller strings are copied into the V8 heap.
    */
   explicit V8ValueFactory(
-      v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Value> callbackData)
+      v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Value> callbackData,
+      size_t externalStringThreshold = DefaultExternalStringThreshold)
     : _isolate(isolate),
       _context(context),
-      _callbackData(callbackData)
+      _callbackData(callbackData),
+      _externalStringThreshold(externalStringThreshold)
   { }
 
   typename V8Traits::UndefinedType CreateUndefined() override;
@@ -41,6 +52,33 @@ public:
 
   typename V8Traits::StringType CreateString(const uint8_t* buffer, size_t size) override;
 
+  /**
+   * @brief Create an external one-byte string backed by the given buffer, if the string is at least
+   * as large as the threshold and is pure ASCII. Otherwise the buffer is copied by `CreateString`.
+   *
+   * Non-ASCII strings are always copied since V8 reads one-byte strings as Latin-1, which would not
+   * match the result of `CreateString`.
+   *
+   * @param buffer pointer to the string data. The buffer must outlive the created string.
+   * @param size size of the string data, in bytes.
+   * @return typename V8Traits::StringType the created string.
+   */
+  typename V8Traits::StringType CreateStringView(const uint8_t* buffer, size_t size) override {
+    if (size < _externalStringThreshold || size > static_cast<size_t>(v8::String::kMaxLength) ||
+        !IsASCII(buffer, size)) {
+      return CreateString(buffer, size);
+    }
+
+    std::unique_ptr<ExternalStringResource> resource { new ExternalStringResource(buffer, size) };
+    v8::Local<v8::String> str;
+    if (!v8::String::NewExternalOneByte(_isolate, resource.get()).ToLocal(&str)) {
+      return CreateString(buffer, size);
+    }
+    // V8 owns the resource from here on and disposes it when the string is collected.
+    resource.release();
+    return str;
+  }
+
   typename V8Traits::IntegerType CreateInteger(int32_t value) override;
 
   typename V8Traits::FloatType CreateFloat(double value) override;
@@ -51,6 +89,34 @@ private:
   v8::Isolate* _isolate;
   v8::Local<v8::Context> _context;
   v8::Local<v8::Value> _callbackData;
+  size_t _externalStringThreshold;
+
+  /**
+   * @brief A one-byte external string resource referring to a buffer it does not own.
+   *
+   */
+  class ExternalStringResource : public v8::String::ExternalOneByteStringResource {
+  public:
+    explicit ExternalStringResource(const uint8_t* data, size_t length)
+      : _data(reinterpret_cast<const char *>(data)), _length(length)
+    { }
+
+    const char* data() const override { return _data; }
+
+    size_t length() const override { return _length; }
+
+  private:
+    const char* _data;
+    size_t _length;
+  }; // class ExternalStringResource
+
+  static bool IsASCII(const uint8_t* buffer, size_t size) {
+    uint8_t bits = 0;
+    for (size_t i = 0; i < size; ++i) {
+      bits |= buffer[i];
+    }
+    return !(bits & 0x80);
+  }
 }; // class V8ValueFactory
 
 } // namespace caf
@@ -0,0 +1,131 @@
+#ifndef CAF_V8_WATCHDOG_H
+#define CAF_V8_WATCHDOG_H
+
+#include "v8.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace caf {
+
+/**
+ * @brief Terminate JavaScript execution in an isolate when a single API function call runs longer
+ * than a time budget.
+ *
+ * A single background thread serves all calls. `Arm` starts the budget of a call and `Disarm` ends
+ * it; if the budget runs out in between, the thread calls `v8::Isolate::TerminateExecution`. Arming
+ * only wakes the thread when it is idle, so back-to-back calls cost a mutex lock and no context
+ * switches.
+ *
+ * Thread safety: `Arm` and `Disarm` should be called from the thread that runs the isolate.
+ *
+ */
+class V8Watchdog {
+public:
+  /**
+   * @brief Construct a new V8Watchdog object and start its thread.
+   *
+   * @param isolate the isolate whose execution is terminated.
+   * @param budget the maximum duration of a single call.
+   */
+  explicit V8Watchdog(v8::Isolate* isolate, std::chrono::milliseconds budget)
+    : _isolate(isolate),
+      _budget(budget),
+      _mutex(),
+      _cond(),
+      _deadline(),
+      _armed(false),
+      _fired(false),
+      _idle(false),
+      _stop(false),
+      _thread()
+  {
+    _thread = std::thread { [this] { Run(); } };
+  }
+
+  V8Watchdog(const V8Watchdog &) = delete;
+  V8Watchdog(V8Watchdog &&) = delete;
+
+  V8Watchdog& operator=(const V8Watchdog &) = delete;
+  V8Watchdog& operator=(V8Watchdog &&) = delete;
+
+  ~V8Watchdog() {
+    {
+      std::lock_guard<std::mutex> lock { _mutex };
+      _stop = true;
+    }
+    _cond.notify_one();
+    _thread.join();
+  }
+
+  /**
+   * @brief Start the budget of a call.
+   *
+   */
+  void Arm() {
+    std::lock_guard<std::mutex> lock { _mutex };
+    _deadline = std::chrono::steady_clock::now() + _budget;
+    _armed = true;
+    _fired = false;
+    if (_idle) {
+      _cond.notify_one();
+    }
+  }
+
+  /**
+   * @brief End the budget of the current call. If the watchdog has fired, the pending termination is
+   * cancelled so the isolate can run JavaScript again.
+   *
+   * @return true if the call ran out of its budget and its execution was terminated.
+   * @return false if the call finished within its budget.
+   */
+  bool Disarm() {
+    std::lock_guard<std::mutex> lock { _mutex };
+    auto fired = _fired;
+    _armed = false;
+    _fired = false;
+    if (fired) {
+      _isolate->CancelTerminateExecution();
+    }
+    return fired;
+  }
+
+private:
+  v8::Isolate* _isolate;
+  std::chrono::milliseconds _budget;
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::chrono::steady_clock::time_point _deadline;
+  bool _armed;
+  bool _fired;
+  bool _idle; // Whether the thread waits without a deadline.
+  bool _stop;
+  std::thread _thread;
+
+  void Run() {
+    std::unique_lock<std::mutex> lock { _mutex };
+    while (!_stop) {
+      if (!_armed) {
+        _idle = true;
+        _cond.wait(lock);
+        _idle = false;
+        continue;
+      }
+
+      // Arm may move the deadline while we wait, so check it again after waking up.
+      auto deadline = _deadline;
+      _cond.wait_until(lock, deadline);
+      if (_armed && !_fired && std::chrono::steady_clock::now() >= _deadline) {
+        _isolate->TerminateExecution();
+        _fired = true;
+        _armed = false;
+      }
+    }
+  }
+}; // class V8Watchdog
+
+} // namespace caf
+
+#endif
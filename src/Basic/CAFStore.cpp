@@ -1,6 +1,8 @@
 #include "Infrastructure/Memory.h"
 #include "Basic/CAFStore.h"
 
+#include <algorithm>
+#include <unordered_set>
 #include <utility>
 
 namespace caf {
@@ -10,6 +12,7 @@ bool CAFStore::Entry::HasChild(const std::string& name) const {
 }
 
 void CAFStore::Entry::AddChild(const std::string& name, std::unique_ptr<Entry> entry) {
+  entry->_parent = this;
   _children.emplace(name, std::move(entry));
 }
 
@@ -23,6 +26,25 @@ CAFStore::Entry* CAFStore::Entry::GetChild(const std::string& name) const {
 
 void CAFStore::Entry::AddDescendent(Entry* entry) {
   _descendents.push_back(entry);
+  if (!_sampler.empty() || entry->_weight != 1.0) {
+    RebuildSampler();
+  }
+}
+
+void CAFStore::Entry::RebuildSampler() {
+  auto uniform = std::all_of(_descendents.begin(), _descendents.end(),
+      [] (const Entry* e) { return e->_weight == 1.0; });
+  if (uniform) {
+    _sampler.clear();
+    return;
+  }
+
+  std::vector<double> weights;
+  weights.reserve(_descendents.size());
+  for (auto e : _descendents) {
+    weights.push_back(e->_weight);
+  }
+  _sampler.Build(weights);
 }
 
 CAFStore::CAFStore()
@@ -40,8 +62,26 @@ CAFStore::~CAFStore() = default;
 void CAFStore::Load(const nlohmann::json &json) {
   FunctionIdType funcId = 0;
   for (const auto& funcJson : json) {
-    auto funcName = funcJson.get<std::string>();
-    AddFunction(Function { funcId++, std::move(funcName) });
+    if (funcJson.is_string()) {
+      // Legacy format: an array of function names.
+      AddFunction(Function { funcId++, funcJson.get<std::string>() });
+      continue;
+    }
+
+    Function func { funcId++, funcJson["name"].get<std::string>() };
+    auto arity = funcJson.find("length");
+    if (arity != funcJson.end() && arity->is_number_unsigned()) {
+      func.SetArity(arity->get<size_t>());
+    }
+    auto ctor = funcJson.find("ctor");
+    if (ctor != funcJson.end()) {
+      func.SetConstructor(ctor->get<bool>());
+    }
+    auto native = funcJson.find("native");
+    if (native != funcJson.end()) {
+      func.SetNative(native->get<bool>());
+    }
+    AddFunction(std::move(func));
   }
 }
 
@@ -88,6 +128,48 @@ void CAFStore::AddFunction(Function func) {
   _funcIdToEntry.emplace(id, node);
 }
 
+void CAFStore::SetFunctionWeight(FunctionIdType id, double weight) {
+  assert(weight >= 0 && "weight cannot be negative.");
+  auto entry = _funcIdToEntry.at(id);
+  entry->_weight = weight;
+  for (auto p = entry; p; p = p->_parent) {
+    p->RebuildSampler();
+  }
+}
+
+void CAFStore::LoadWeights(const nlohmann::json& json) {
+  // Apply weights of shallower entries first so that weights of deeper entries override them.
+  std::vector<std::pair<std::string, double>> weights;
+  for (auto i = json.begin(); i != json.end(); ++i) {
+    weights.emplace_back(i.key(), i.value().get<double>());
+  }
+  std::stable_sort(weights.begin(), weights.end(),
+      [] (const std::pair<std::string, double>& lhs, const std::pair<std::string, double>& rhs) {
+        return std::count(lhs.first.begin(), lhs.first.end(), '.') <
+               std::count(rhs.first.begin(), rhs.first.end(), '.');
+      });
+
+  std::unordered_set<Entry *> dirty;
+  for (const auto& w : weights) {
+    auto entry = FindEntry(w.first);
+    if (!entry) {
+      continue;
+    }
+    for (auto d : entry->_descendents) {
+      d->_weight = w.second;
+      for (auto p = d; p; p = p->_parent) {
+        if (!dirty.insert(p).second) {
+          break;
+        }
+      }
+    }
+  }
+
+  for (auto entry : dirty) {
+    entry->RebuildSampler();
+  }
+}
+
 CAFStore::Statistics CAFStore::GetStatistics() const {
   Statistics stat;
   stat.ApiFunctionsCount = GetFunctionsCount();
@@ -100,7 +182,15 @@ nlohmann::json CAFStore::ToJson() const {
     if (!entry->HasFunction()) {
       continue;
     }
-    json.push_back(entry->GetFunction().name());
+    const auto& func = entry->GetFunction();
+    auto funcJson = nlohmann::json::object();
+    funcJson["name"] = func.name();
+    if (func.HasArity()) {
+      funcJson["length"] = func.arity();
+    }
+    funcJson["ctor"] = func.IsConstructor();
+    funcJson["native"] = func.IsNative();
+    json.push_back(std::move(funcJson));
   }
   return json;
 }
@@ -111,4 +201,18 @@ std::unique_ptr<CAFStore::Entry> CAFStore::CreateEntry() {
   return entry;
 }
 
+CAFStore::Entry* CAFStore::FindEntry(const std::string& name) const {
+  auto node = _root.get();
+  size_t start = 0;
+  while (node && start < name.length()) {
+    size_t sep = name.find('.', start);
+    if (sep == std::string::npos) {
+      sep = name.length();
+    }
+    node = node->GetChild(name.substr(start, sep - start));
+    start = sep + 1;
+  }
+  return node;
+}
+
 } // namespace caf
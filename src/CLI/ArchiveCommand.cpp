@@ -0,0 +1,98 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "TestCaseInputs.h"
+#include "Infrastructure/Stream.h"
+#include "Fuzzer/CorpusArchive.h"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace caf {
+
+class ArchiveCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-o", _opts.outputFile, "Path to the output corpus archive file")
+        ->required();
+    app.add_flag("--append", _opts.append,
+                 "Append to the output corpus archive if it exists, skipping test cases it "
+                 "already has");
+    app.add_option("--max-depth", _opts.maxChainDepth,
+                   "Maximum length of the parent chain of an entry")
+        ->default_val(std::to_string(CorpusArchiveWriter::DefaultMaxChainDepth));
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("files", _opts.inputFiles,
+                   "Test case files, directories of test case files or corpus packs to archive")
+        ->check(CLI::ExistingPath)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    TestCaseInputs inputs { };
+    for (const auto& path : _opts.inputFiles) {
+      if (!inputs.Add(path)) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to read \"%s\"", path.c_str());
+      }
+    }
+
+    CorpusArchiveWriter writer { _opts.maxChainDepth };
+
+    // The existing archive is read by the writer until all entries are added.
+    std::unique_ptr<CorpusArchive> archive;
+    struct stat st;
+    auto append = _opts.append && stat(_opts.outputFile.c_str(), &st) == 0;
+    if (append) {
+      archive = CorpusArchive::Open(_opts.outputFile.c_str());
+      if (!archive) {
+        PRINT_ERR_AND_EXIT_FMT("failed to open corpus archive \"%s\"", _opts.outputFile.c_str());
+      }
+      writer.AppendTo(*archive);
+    }
+
+    for (const auto& input : inputs) {
+      // Only keep the file name, which carries the parent ID of AFL queue entries.
+      auto sep = input.Name.rfind('/');
+      auto name = sep == std::string::npos ? input.Name : input.Name.substr(sep + 1);
+      writer.AddEntry(name, input.Data, input.Size);
+    }
+
+    auto mode = std::ios::binary | (append ? std::ios::app : std::ios::trunc);
+    std::ofstream outputFile { _opts.outputFile, mode };
+    if (outputFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to open output file \"%s\"", _opts.outputFile.c_str());
+    }
+    StlOutputStream outputStream { outputFile };
+    writer.Write(outputStream);
+
+    if (!_opts.silence) {
+      std::cout << writer.size() << " test cases archived, "
+                << writer.GetDeltaEntriesCount() << " stored as edits, "
+                << writer.GetSkippedEntriesCount() << " already archived." << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string outputFile; // Path to the output corpus archive file
+    std::vector<std::string> inputFiles; // Paths to the inputs
+    size_t maxChainDepth;   // Maximum length of parent chains
+    bool append;            // Append to an existing archive
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+}; // class ArchiveCommand
+
+static RegisterCommand<ArchiveCommand> X {
+  "archive", "Store test cases as edits against their parents in a corpus archive file" };
+
+} // namespace caf
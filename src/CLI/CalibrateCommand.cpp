@@ -1,11 +1,13 @@
 #include "Command.h"
 #include "Diagnostics.h"
 #include "RegisterCommand.h"
+#include "TestCaseInputs.h"
 
 #include "Infrastructure/Memory.h"
-#include "Infrastructure/Stream.h"
 #include "Basic/CAFStore.h"
+#include "Basic/TestCaseValidator.h"
 #include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
 #include "Fuzzer/TestCaseDeserializer.h"
 #include "Fuzzer/TestCaseSynthesiser.h"
 #include "Fuzzer/SynthesisBuilder.h"
@@ -55,8 +57,9 @@ public:
         ->required()
         ->check(CLI::ExistingFile);
     app.add_option("-X", _opt.ExecutableArgs, "Arguments to the executable file");
-    app.add_option("tc", _opt.TestCaseFiles, "Paths to the test case files")
-        ->check(CLI::ExistingFile);
+    app.add_option("tc", _opt.TestCaseFiles,
+        "Paths to the test case files, corpus packs or directories")
+        ->check(CLI::ExistingPath);
   }
 
   int Execute(CLI::App &app) override {
@@ -71,8 +74,16 @@ public:
     std::strcpy(jsFileName, "/tmp/caf_XXXXXX");
     mkstemp(jsFileName);
 
+    TestCaseInputs inputs { };
+    for (const auto& path : _opt.TestCaseFiles) {
+      if (!inputs.Add(path)) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("cannot open test case file \"%s\"", path.c_str());
+      }
+    }
+
     std::unordered_map<int, int> signalCounter;
-    for (const auto& tcFile : _opt.TestCaseFiles) {
+    for (const auto& input : inputs) {
+      const auto& tcFile = input.Name;
       if (tcFile.find("README.txt") != std::string::npos) {
         continue;
       }
@@ -86,16 +97,15 @@ public:
 
       TestCaseSynthesiser synthesiser { *store, *synthesisBuilder };
 
-      std::ifstream tcFileStream { tcFile };
-      if (!tcFileStream) {
-        PRINT_LAST_OS_ERR("cannot open test case file");
+      pool->clear();
+      TestCaseDeserializer de { *pool, input.Data, input.Size };
+      TestCase tc;
+      if (!de.TryDeserialize(tc)) {
+        PRINT_ERR_FMT("%s: malformed test case: %s", tcFile.c_str(),
+                      GetTestCaseValidationErrorMessage(de.GetError()));
         continue;
       }
 
-      StlInputStream tcFileInputStream { tcFileStream };
-      TestCaseDeserializer de { *pool, tcFileInputStream };
-      auto tc = de.Deserialize();
-
       synthesiser.Synthesis(tc);
       auto code = synthesiser.GetCode();
 
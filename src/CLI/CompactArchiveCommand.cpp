@@ -0,0 +1,82 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "Infrastructure/Stream.h"
+#include "Fuzzer/CorpusArchive.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace caf {
+
+class CompactArchiveCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-o", _opts.outputFile, "Path to the output corpus archive file")
+        ->required();
+    app.add_option("--max-depth", _opts.maxChainDepth,
+                   "Maximum length of the parent chain of an entry")
+        ->default_val(std::to_string(CorpusArchiveWriter::DefaultMaxChainDepth));
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("archive", _opts.inputFile, "Corpus archive file to compact")
+        ->check(CLI::ExistingFile)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    auto archive = CorpusArchive::Open(_opts.inputFile.c_str());
+    if (!archive) {
+      PRINT_ERR_AND_EXIT_FMT("failed to open corpus archive \"%s\"", _opts.inputFile.c_str());
+    }
+
+    // Entries appended later replace earlier entries of the same name.
+    std::unordered_map<std::string, size_t> latest;
+    for (size_t i = 0; i < archive->size(); ++i) {
+      latest[archive->GetName(i).str()] = i;
+    }
+
+    CorpusArchiveWriter writer { _opts.maxChainDepth };
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < archive->size(); ++i) {
+      auto name = archive->GetName(i);
+      if (latest[name.str()] != i) {
+        continue;
+      }
+      archive->Reconstruct(i, data);
+      writer.AddEntry(name, data.data(), data.size());
+    }
+
+    std::ofstream outputFile { _opts.outputFile, std::ios::binary };
+    if (outputFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to create output file \"%s\"", _opts.outputFile.c_str());
+    }
+    StlOutputStream outputStream { outputFile };
+    writer.Write(outputStream);
+
+    if (!_opts.silence) {
+      std::cout << archive->size() << " entries read, " << writer.size() << " entries written, "
+                << writer.GetDeltaEntriesCount() << " stored as edits." << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string inputFile;  // Path to the input corpus archive file
+    std::string outputFile; // Path to the output corpus archive file
+    size_t maxChainDepth;   // Maximum length of parent chains
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+}; // class CompactArchiveCommand
+
+static RegisterCommand<CompactArchiveCommand> X {
+  "compact-archive", "Rewrite a corpus archive, dropping replaced entries and re-encoding edits" };
+
+} // namespace caf
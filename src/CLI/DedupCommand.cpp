@@ -0,0 +1,143 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "TestCaseInputs.h"
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Stream.h"
+#include "Basic/TestCaseValidator.h"
+#include "Fuzzer/CorpusPack.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseCanonicalizer.h"
+#include "Fuzzer/TestCaseDeserializer.h"
+#include "Fuzzer/TestCaseSerializer.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace caf {
+
+class DedupCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-o", _opts.output, "Path to the output directory, or corpus pack with --pack")
+        ->required();
+    app.add_flag("--pack", _opts.pack, "Write the unique test cases into a corpus pack file");
+    app.add_flag("--canonicalize", _opts.canonicalize,
+                 "Write the unique test cases in their canonical form");
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("files", _opts.inputFiles,
+                   "Test case files, directories of test case files or corpus packs to dedup")
+        ->check(CLI::ExistingPath)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    TestCaseInputs inputs { };
+    for (const auto& path : _opts.inputFiles) {
+      if (!inputs.Add(path)) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to read \"%s\"", path.c_str());
+      }
+    }
+
+    if (!_opts.pack && mkdir(_opts.output.c_str(), 0777) != 0 && errno != EEXIST) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to create directory \"%s\"", _opts.output.c_str());
+    }
+
+    auto pool = caf::make_unique<ObjectPool>();
+    TestCaseCanonicalizer canonicalizer { };
+    TestCaseSerializer serializer { };
+    CorpusPackWriter writer { };
+    std::unordered_set<uint64_t> hashes;
+    std::unordered_set<std::string> names;
+    std::vector<uint8_t> canonical;
+    size_t malformedCount = 0;
+
+    for (const auto& input : inputs) {
+      pool->clear();
+      TestCaseDeserializer de { *pool, input.Data, input.Size };
+      TestCase tc;
+      if (!de.TryDeserialize(tc)) {
+        PRINT_ERR_FMT("%s: malformed test case: %s", input.Name.c_str(),
+                      GetTestCaseValidationErrorMessage(de.GetError()));
+        ++malformedCount;
+        continue;
+      }
+
+      if (!hashes.insert(canonicalizer.Hash(tc)).second) {
+        continue;
+      }
+
+      auto data = input.Data;
+      auto size = input.Size;
+      if (_opts.canonicalize) {
+        canonicalizer.Canonicalize(tc, *pool);
+        canonical.clear();
+        serializer.Serialize(tc, canonical);
+        data = canonical.data();
+        size = canonical.size();
+      }
+
+      // Keep the file name of the first occurrence, and disambiguate names that collide.
+      auto sep = input.Name.rfind('/');
+      auto name = sep == std::string::npos ? input.Name : input.Name.substr(sep + 1);
+      if (!names.insert(name).second) {
+        name.append(".").append(std::to_string(hashes.size()));
+        names.insert(name);
+      }
+
+      if (_opts.pack) {
+        writer.AddEntry(name, data, size);
+      } else {
+        WriteFile(_opts.output + "/" + name, data, size);
+      }
+    }
+
+    if (_opts.pack) {
+      std::ofstream outputFile { _opts.output, std::ios::binary };
+      if (outputFile.fail()) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to create output file \"%s\"", _opts.output.c_str());
+      }
+      StlOutputStream outputStream { outputFile };
+      writer.Write(outputStream);
+    }
+
+    if (!_opts.silence) {
+      std::cout << inputs.size() << " test cases, " << hashes.size() << " unique, "
+                << malformedCount << " malformed." << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string output;     // Path to the output directory or corpus pack file
+    std::vector<std::string> inputFiles; // Paths to the inputs
+    bool pack;              // Write a corpus pack file instead of a directory
+    bool canonicalize;      // Write test cases in their canonical form
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+
+  static void WriteFile(const std::string& path, const uint8_t* data, size_t size) {
+    std::ofstream outputFile { path, std::ios::binary };
+    if (outputFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to create output file \"%s\"", path.c_str());
+    }
+    outputFile.write(reinterpret_cast<const char *>(data), size);
+  }
+}; // class DedupCommand
+
+static RegisterCommand<DedupCommand> X {
+  "dedup", "Remove structurally identical test cases from a corpus" };
+
+} // namespace caf
@@ -2,7 +2,14 @@
 #include "RegisterCommand.h"
 #include "Diagnostics.h"
 #include "CAFConfig.h"
+#include "Basic/CAFStore.h"
+#include "Basic/ReturnKindFeedback.h"
+#include "Fuzzer/MutatorStatistics.h"
+#include "Fuzzer/ObjectPool.h"
 
+#include "json/json.hpp"
+
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -11,6 +18,7 @@
 #include <string>
 #include <vector>
 
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <fcntl.h>
@@ -127,6 +135,10 @@ public:
     app.add_option("-s", _opts.StoreFileName, "Path to the cafstore.json file")
         ->required()
         ->check(CLI::ExistingFile);
+    app.add_option("-w,--weights", _opts.WeightsFileName, "Path to the API sampling weights file")
+        ->check(CLI::ExistingFile);
+    app.add_option("--feedback", _opts.FeedbackFileName,
+                   "Path to the return kind feedback file to create and share with the target");
     app.add_option("-d", _opts.SeedDir, "Path to the seed directory")
         ->required()
         ->check(CLI::ExistingDirectory);
@@ -135,6 +147,13 @@ public:
     app.add_option("--afl", _opts.AflExecutable, "Path to the AFLplusplus executable")
         ->check(CLI::ExistingFile);
     app.add_flag("--resume", _opts.Resume, "Enable AFLplusplus auto resume");
+    app.add_flag("--hash-consing", _opts.HashConsing,
+                 "Share structurally identical arrays in mutated test cases");
+    app.add_option("--stats", _opts.StatsDir,
+                   "Path to the directory into which the mutators write their statistics");
+    app.add_option("--pool-budget", _opts.PoolBudget,
+                   "Memory budget of the object pool of each mutator, in megabytes")
+        ->check(CLI::PositiveNumber);
     app.add_option("-n", _opts.Parallelization, "Number of parallel afl-fuzz instances to run")
         ->check(CLI::PositiveNumber)
         ->default_val(1);
@@ -171,6 +190,51 @@ public:
       std::cout << "export CAF_STORE=" << _opts.StoreFileName << std::endl;
     }
 
+    std::string weightsVar;
+    if (!_opts.WeightsFileName.empty()) {
+      weightsVar = "CAF_WEIGHTS=";
+      weightsVar.append(_opts.WeightsFileName);
+      if (_opts.Verbose) {
+        std::cout << "export CAF_WEIGHTS=" << _opts.WeightsFileName << std::endl;
+      }
+    }
+
+    std::string feedbackVar;
+    if (!_opts.FeedbackFileName.empty()) {
+      CreateFeedbackFile();
+      feedbackVar = CAF_FEEDBACK_FILE_ENV "=";
+      feedbackVar.append(_opts.FeedbackFileName);
+      if (_opts.Verbose) {
+        std::cout << "export " CAF_FEEDBACK_FILE_ENV "=" << _opts.FeedbackFileName << std::endl;
+      }
+    }
+
+    if (_opts.HashConsing && _opts.Verbose) {
+      std::cout << "export " CAF_HASH_CONSING_ENV "=1" << std::endl;
+    }
+
+    std::string statsVar;
+    if (!_opts.StatsDir.empty()) {
+      if (mkdir(_opts.StatsDir.c_str(), 0777) != 0 && errno != EEXIST) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+            "failed to create directory \"%s\"", _opts.StatsDir.c_str());
+      }
+      statsVar = CAF_MUTATOR_STATS_DIR_ENV "=";
+      statsVar.append(_opts.StatsDir);
+      if (_opts.Verbose) {
+        std::cout << "export " CAF_MUTATOR_STATS_DIR_ENV "=" << _opts.StatsDir << std::endl;
+      }
+    }
+
+    std::string poolBudgetVar;
+    if (_opts.PoolBudget) {
+      poolBudgetVar = CAF_POOL_BUDGET_ENV "=";
+      poolBudgetVar.append(std::to_string(_opts.PoolBudget));
+      if (_opts.Verbose) {
+        std::cout << "export " CAF_POOL_BUDGET_ENV "=" << _opts.PoolBudget << std::endl;
+      }
+    }
+
     std::string mutatorLibVar = "AFL_CUSTOM_MUTATOR_LIBRARY=";
     mutatorLibVar.append(CAF_LIB_DIR);
     mutatorLibVar.append("/libCAFMutator.so");
@@ -185,6 +249,21 @@ public:
       aflEnv.push_back(*e);
     }
     aflEnv.push_back(DuplicateString(storeVar.c_str()));
+    if (!weightsVar.empty()) {
+      aflEnv.push_back(DuplicateString(weightsVar.c_str()));
+    }
+    if (!feedbackVar.empty()) {
+      aflEnv.push_back(DuplicateString(feedbackVar.c_str()));
+    }
+    if (_opts.HashConsing) {
+      aflEnv.push_back(DuplicateString(CAF_HASH_CONSING_ENV "=1"));
+    }
+    if (!statsVar.empty()) {
+      aflEnv.push_back(DuplicateString(statsVar.c_str()));
+    }
+    if (!poolBudgetVar.empty()) {
+      aflEnv.push_back(DuplicateString(poolBudgetVar.c_str()));
+    }
     aflEnv.push_back(DuplicateString(mutatorLibVar.c_str()));
     aflEnv.push_back(DuplicateString("AFL_CUSTOM_MUTATOR_ONLY=1"));
     if (_opts.Resume) {
@@ -290,11 +369,15 @@ public:
 private:
   struct Opts {
     explicit Opts()
-      : StoreFileName(), SeedDir(), FindingsDir(), AflExecutable(), Target(), AFLArgs(),
-        Parallelization(1), Resume(false), DryRun(false), Verbose(false), Quiet(false)
+      : StoreFileName(), WeightsFileName(), FeedbackFileName(), StatsDir(), SeedDir(), FindingsDir(), AflExecutable(), Target(), AFLArgs(),
+        Parallelization(1), PoolBudget(0), Resume(false), HashConsing(false), DryRun(false), Verbose(false),
+        Quiet(false)
     { }
 
     std::string StoreFileName;
+    std::string WeightsFileName;
+    std::string FeedbackFileName;
+    std::string StatsDir;
     std::string SeedDir;
     std::string FindingsDir;
     std::string AflExecutable;
@@ -302,13 +385,38 @@ private:
     std::string SanitizedTarget;
     std::vector<std::string> AFLArgs;
     int Parallelization;
+    int PoolBudget;
     bool Resume;
+    bool HashConsing;
     bool DryRun;
     bool Verbose;
     bool Quiet;
   }; // struct Opts
 
   Opts _opts;
+
+  void CreateFeedbackFile() const {
+    std::ifstream storeFile { _opts.StoreFileName };
+    if (storeFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT("failed to open store file");
+    }
+
+    nlohmann::json json;
+    storeFile >> json;
+
+    CAFStore store { };
+    store.Load(json);
+
+    if (_opts.DryRun) {
+      return;
+    }
+
+    auto feedback = ReturnKindFeedback::Create(
+        _opts.FeedbackFileName.c_str(), store.GetFunctionsCount());
+    if (!feedback) {
+      PRINT_LAST_OS_ERR_AND_EXIT("failed to create return kind feedback file");
+    }
+  }
 }; // class FuzzCommand
 
 static RegisterCommand<FuzzCommand> X { "fuzz", "Fuzz a target using CAF" };
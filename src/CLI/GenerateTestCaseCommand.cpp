@@ -61,7 +61,11 @@ public:
     app.add_option("-c", _opts.maxCalls, "Maximum number of calls to generate in each test case")
         ->default_val(5)
         ->check(CLI::PositiveNumber);
+    app.add_option("-w,--weights", _opts.weightsFile, "Path to a JSON file of API sampling weights")
+        ->check(CLI::ExistingFile);
     app.add_flag("--full", _opts.full, "Use full mode to generate a complete set of test cases");
+    app.add_flag("--hash-consing", _opts.hashConsing,
+                 "Share structurally identical arrays within each test case");
     app.add_option("--seed", _opts.seed, "Initial seed for the random number generator")
         ->check(CLI::Number);
     app.add_flag("--silence", _opts.silence, "Silent all informative log output");
@@ -89,10 +93,23 @@ public:
     store->Load(json);
 
     storeFile.close();
+
+    if (!_opts.weightsFile.empty()) {
+      std::ifstream weightsFile { _opts.weightsFile };
+      if (weightsFile.fail()) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", _opts.weightsFile.c_str());
+      }
+
+      nlohmann::json weights;
+      weightsFile >> weights;
+      store->LoadWeights(weights);
+    }
+
     ChangeWorkingDirectory(_opts.outputDir.c_str());
 
     // Initialize object pool and random number generator.
     auto pool = caf::make_unique<ObjectPool>();
+    pool->SetHashConsingEnabled(_opts.hashConsing);
     Random<> rnd;
     rnd.seed(_opts.seed);
 
@@ -137,10 +154,12 @@ private:
   struct Opts {
     std::string storeFile;  // Path to the cafstore.json file
     std::string outputDir;  // Path to the output directory
+    std::string weightsFile; // Path to the API sampling weights file
     int n;                  // Number of test cases to generate
     int maxCalls;           // Maximum number of API calls generated in each test case
     int seed;               // Initial seed for the random number generator
     bool full;
+    bool hashConsing;       // Share structurally identical arrays.
     bool silence;           // Silent all informative output.
   }; // struct Opts
 
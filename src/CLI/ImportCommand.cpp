@@ -0,0 +1,130 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Stream.h"
+#include "Basic/CAFStore.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseImporter.h"
+#include "Fuzzer/TestCaseSerializer.h"
+
+#include "json/json.hpp"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace caf {
+
+class ImportCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-s", _opts.storeFile, "Path to the cafstore.json file")
+        ->check(CLI::ExistingFile)
+        ->required();
+    app.add_option("-o", _opts.outputDir, "Path to the output directory")
+        ->required();
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("files", _opts.inputFiles, "JavaScript files to import")
+        ->check(CLI::ExistingFile)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    if (!_opts.silence) {
+      std::cout << "Loading CAF store from file \"" << _opts.storeFile << "\"..." << std::endl;
+    }
+
+    std::ifstream storeFile { _opts.storeFile };
+    if (storeFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", _opts.storeFile.c_str());
+    }
+
+    nlohmann::json json;
+    storeFile >> json;
+    auto store = caf::make_unique<CAFStore>();
+    store->Load(json);
+
+    storeFile.close();
+
+    if (mkdir(_opts.outputDir.c_str(), 0777) != 0 && errno != EEXIST) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to create directory \"%s\"", _opts.outputDir.c_str());
+    }
+
+    auto pool = caf::make_unique<ObjectPool>();
+    TestCaseImporter importer { *store, *pool };
+
+    size_t seedsCount = 0;
+    for (const auto& inputFileName : _opts.inputFiles) {
+      std::ifstream inputFile { inputFileName };
+      if (inputFile.fail()) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", inputFileName.c_str());
+      }
+      std::string code { std::istreambuf_iterator<char>(inputFile),
+                         std::istreambuf_iterator<char>() };
+
+      auto imported = importer.GetImportedCount();
+      auto skipped = importer.GetSkippedCount();
+
+      pool->clear();
+      auto tc = importer.Import(code);
+
+      if (!_opts.silence) {
+        std::cout << inputFileName << ": "
+                  << importer.GetImportedCount() - imported << " calls imported, "
+                  << importer.GetSkippedCount() - skipped << " statements skipped"
+                  << std::endl;
+      }
+
+      if (tc.GetFunctionCallsCount() == 0) {
+        continue;
+      }
+
+      std::string outputFileName = _opts.outputDir;
+      outputFileName.append("/seed");
+      outputFileName.append(std::to_string(seedsCount++));
+      outputFileName.append(".bin");
+
+      std::ofstream outputFile { outputFileName };
+      if (outputFile.fail()) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+            "failed to create output file \"%s\"", outputFileName.c_str());
+      }
+
+      StlOutputStream outputStream { outputFile };
+      TestCaseSerializer ser { outputStream };
+      ser.Serialize(tc);
+    }
+
+    if (!_opts.silence) {
+      std::cout << seedsCount << " seeds written, "
+                << importer.GetImportedCount() << " calls imported, "
+                << importer.GetSkippedCount() << " statements skipped."
+                << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string storeFile;  // Path to the cafstore.json file
+    std::string outputDir;  // Path to the output directory
+    std::vector<std::string> inputFiles; // Paths to the JavaScript files to import
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+}; // class ImportCommand
+
+static RegisterCommand<ImportCommand> X {
+  "import", "Import straight-line JavaScript code as test cases" };
+
+} // namespace caf
@@ -0,0 +1,144 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "TestCaseInputs.h"
+#include "Infrastructure/Memory.h"
+#include "Basic/CAFStore.h"
+#include "Fuzzer/ConcurrentMutator.h"
+
+#include "json/json.hpp"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace caf {
+
+class MutateCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-s", _opts.storeFile, "Path to the cafstore.json file")
+        ->check(CLI::ExistingFile)
+        ->required();
+    app.add_option("-o", _opts.outputDir, "Path to the output directory")
+        ->required();
+    app.add_option("-n", _opts.mutantsCount, "Number of mutants to produce from each test case")
+        ->default_val(1)
+        ->check(CLI::PositiveNumber);
+    app.add_option("-j", _opts.threadsCount,
+                   "Number of worker threads, 0 to use all hardware threads")
+        ->default_val(0)
+        ->check(CLI::NonNegativeNumber);
+    app.add_option("--seed", _opts.seed, "Initial seed for the random number generators")
+        ->check(CLI::Number);
+    app.add_flag("--hash-consing", _opts.hashConsing,
+                 "Share structurally identical arrays within each test case");
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("files", _opts.inputFiles,
+                   "Test case files, corpus packs or directories to mutate")
+        ->check(CLI::ExistingPath)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    if (!app.count("--seed")) {
+      _opts.seed = static_cast<int>(
+          std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    }
+
+    std::ifstream storeFile { _opts.storeFile };
+    if (storeFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", _opts.storeFile.c_str());
+    }
+
+    nlohmann::json json;
+    storeFile >> json;
+    auto store = caf::make_unique<CAFStore>();
+    store->Load(json);
+
+    storeFile.close();
+
+    if (mkdir(_opts.outputDir.c_str(), 0777) != 0 && errno != EEXIST) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to create directory \"%s\"", _opts.outputDir.c_str());
+    }
+
+    TestCaseInputs testCases { };
+    for (const auto& inputFileName : _opts.inputFiles) {
+      if (!testCases.Add(inputFileName)) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", inputFileName.c_str());
+      }
+    }
+
+    // The mutator reads the test cases in place; testCases keeps them alive.
+    std::vector<ConcurrentMutator::Input> inputs;
+    inputs.reserve(testCases.size());
+    for (const auto& tc : testCases) {
+      inputs.push_back(ConcurrentMutator::Input { tc.Data, tc.Size });
+    }
+
+    ConcurrentMutator mutator { *store, static_cast<size_t>(_opts.threadsCount) };
+    mutator.SetHashConsingEnabled(_opts.hashConsing);
+    if (!_opts.silence) {
+      std::cout << "Mutating " << inputs.size() << " test cases on "
+                << mutator.GetThreadsCount() << " threads..." << std::endl;
+    }
+
+    auto mutants = mutator.Mutate(
+        inputs, static_cast<size_t>(_opts.mutantsCount), static_cast<uint64_t>(_opts.seed));
+
+    size_t mutantsCount = 0;
+    for (size_t i = 0; i < mutants.size(); ++i) {
+      if (mutants[i].empty()) {
+        // The input of this mutant is malformed.
+        continue;
+      }
+      ++mutantsCount;
+
+      std::string outputFileName = _opts.outputDir;
+      outputFileName.append("/mutant");
+      outputFileName.append(std::to_string(i));
+      outputFileName.append(".bin");
+
+      std::ofstream outputFile { outputFileName, std::ios::binary };
+      if (outputFile.fail()) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+            "failed to create output file \"%s\"", outputFileName.c_str());
+      }
+      outputFile.write(reinterpret_cast<const char *>(mutants[i].data()), mutants[i].size());
+    }
+
+    if (!_opts.silence) {
+      std::cout << mutantsCount << " mutants written, "
+                << mutants.size() - mutantsCount << " skipped due to malformed inputs."
+                << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string storeFile;  // Path to the cafstore.json file
+    std::string outputDir;  // Path to the output directory
+    std::vector<std::string> inputFiles; // Paths to the test cases to mutate
+    int mutantsCount;       // Number of mutants to produce from each test case
+    int threadsCount;       // Number of worker threads
+    int seed;               // Initial seed for the random number generators
+    bool hashConsing;       // Share structurally identical arrays.
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+}; // class MutateCommand
+
+static RegisterCommand<MutateCommand> X {
+  "mutate", "Mutate test cases on multiple threads" };
+
+} // namespace caf
@@ -0,0 +1,83 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "TestCaseInputs.h"
+#include "Infrastructure/Stream.h"
+#include "Fuzzer/CorpusPack.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace caf {
+
+class PackCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-o", _opts.outputFile, "Path to the output corpus pack file")
+        ->required();
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("files", _opts.inputFiles,
+                   "Test case files, directories of test case files or corpus packs to pack")
+        ->check(CLI::ExistingPath)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    TestCaseInputs inputs { };
+    for (const auto& path : _opts.inputFiles) {
+      if (!inputs.Add(path)) {
+        PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to read \"%s\"", path.c_str());
+      }
+    }
+
+    CorpusPackWriter writer { };
+    std::unordered_set<std::string> names;
+    size_t renamedCount = 0;
+    for (const auto& input : inputs) {
+      // Only keep the file name so that unpacking into a directory restores the original names, and
+      // disambiguate names that collide, e.g. AFL queue entries of different fuzzer instances.
+      auto sep = input.Name.rfind('/');
+      auto name = sep == std::string::npos ? input.Name : input.Name.substr(sep + 1);
+      if (!names.insert(name).second) {
+        auto base = name;
+        for (size_t i = 1; !names.insert(name).second; ++i) {
+          name = base + "." + std::to_string(i);
+        }
+        ++renamedCount;
+      }
+      writer.AddEntry(name, input.Data, input.Size);
+    }
+
+    std::ofstream outputFile { _opts.outputFile, std::ios::binary };
+    if (outputFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to create output file \"%s\"", _opts.outputFile.c_str());
+    }
+    StlOutputStream outputStream { outputFile };
+    writer.Write(outputStream);
+
+    if (!_opts.silence) {
+      std::cout << writer.size() << " test cases packed, "
+                << renamedCount << " renamed due to duplicate names." << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string outputFile; // Path to the output corpus pack file
+    std::vector<std::string> inputFiles; // Paths to the inputs
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+}; // class PackCommand
+
+static RegisterCommand<PackCommand> X {
+  "pack", "Pack test cases into a corpus pack file" };
+
+} // namespace caf
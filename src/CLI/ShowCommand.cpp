@@ -3,8 +3,8 @@
 #include "Diagnostics.h"
 #include "Printer.h"
 #include "TestCaseDumper.h"
+#include "TestCaseInputs.h"
 #include "Infrastructure/Memory.h"
-#include "Infrastructure/Stream.h"
 #include "Basic/CAFStore.h"
 #include "Fuzzer/ObjectPool.h"
 #include "Fuzzer/TestCaseDeserializer.h"
@@ -23,9 +23,9 @@ public:
         ->required()
         ->check(CLI::ExistingFile);
     app.add_flag("--no-color", _opts.NoColor, "Disable coloring output");
-    app.add_option("tc", _opts.TestCaseFileName, "Path to the test case file")
+    app.add_option("tc", _opts.TestCaseFileName, "Path to the test case file, corpus pack or directory")
         ->required()
-        ->check(CLI::ExistingFile);
+        ->check(CLI::ExistingPath);
   }
 
   int Execute(CLI::App &app) override {
@@ -41,21 +41,33 @@ public:
     auto pool = caf::make_unique<ObjectPool>();
     storeFile.close();
 
-    std::ifstream tcFile { _opts.TestCaseFileName };
-    if (tcFile.fail()) {
+    TestCaseInputs inputs { };
+    if (!inputs.Add(_opts.TestCaseFileName)) {
       PRINT_LAST_OS_ERR_AND_EXIT("failed to load test case file");
     }
-    StlInputStream fileStream { tcFile };
-    TestCaseDeserializer de { *pool, fileStream };
-    auto tc = de.Deserialize();
 
     Printer printer { std::cout };
     printer.SetColorOn(!_opts.NoColor);
 
     TestCaseDumper dumper { *store, printer };
-    dumper.Dump(tc);
+    for (const auto& input : inputs) {
+      if (inputs.size() > 1) {
+        printer << input.Name << ":" << Printer::endl;
+      }
+
+      // The inputs outlive the test case, so the test case can refer to them directly.
+      pool->clear();
+      TestCaseDeserializer de { *pool, input.Data, input.Size };
+      TestCase tc;
+      if (!de.TryDeserialize(tc)) {
+        PRINT_ERR_AND_EXIT_FMT("%s: malformed test case: %s", input.Name.c_str(),
+                               GetTestCaseValidationErrorMessage(de.GetError()));
+      }
+
+      dumper.Dump(tc);
+      printer << Printer::endl;
+    }
 
-    printer << Printer::endl;
     return 0;
   }
 
@@ -2,12 +2,15 @@
 #include "Diagnostics.h"
 #include "RegisterCommand.h"
 #include "Basic/CAFStore.h"
+#include "Basic/ValueKind.h"
+#include "Fuzzer/MutatorStatistics.h"
 
 #include "json/json.hpp"
 
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace caf {
 
@@ -19,30 +22,79 @@ void DumpStatistics(const CAFStore::Statistics& stat) {
   std::cout << "========== CAF Store Statistics ==========" << std::endl;
 }
 
+void DumpStatistics(const std::string& fileName, const MutatorStatistics& stat) {
+  const auto& pool = stat.Pool;
+  std::cout << "========== Mutator Statistics ==========" << std::endl;
+  std::cout << "File: " << fileName << std::endl;
+  std::cout << "Number of mutations: " << stat.MutationsCount << std::endl;
+  std::cout << "Number of synthesis: " << stat.SynthesisCount << std::endl;
+  std::cout << "Number of rejected test cases: " << stat.RejectedCount << std::endl;
+  auto attempts = stat.MutationsCount + stat.DuplicatesCount;
+  std::cout << "Number of duplicate mutants: " << stat.DuplicatesCount;
+  if (attempts) {
+    std::cout << " (" << 100.0 * stat.DuplicatesCount / attempts << "% of mutation attempts)";
+  }
+  std::cout << std::endl;
+  std::cout << "Object pool:" << std::endl;
+  for (size_t k = 0; k < ValueKindsCount; ++k) {
+    std::cout << "  " << GetValueKindName(static_cast<ValueKind>(k)) << ": "
+              << pool.ValuesCount[k] << " values, "
+              << pool.ValueBytes[k] << " bytes" << std::endl;
+  }
+  std::cout << "  Bytes allocated: " << pool.BytesAllocated << std::endl;
+  std::cout << "  Bytes reserved: " << pool.BytesReserved << std::endl;
+  std::cout << "  High water mark: " << pool.HighWaterMark << " bytes" << std::endl;
+  if (pool.MemoryBudget) {
+    std::cout << "  Memory budget: " << pool.MemoryBudget << " bytes, reached "
+              << pool.BudgetResetsCount << " times" << std::endl;
+  } else {
+    std::cout << "  Memory budget: none" << std::endl;
+  }
+  std::cout << "  Number of clears: " << pool.ClearsCount << std::endl;
+  std::cout << "========== Mutator Statistics ==========" << std::endl;
+}
+
+nlohmann::json LoadJson(const std::string& fileName) {
+  std::ifstream file { fileName };
+  if (file.fail()) {
+    PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", fileName.c_str());
+  }
+
+  nlohmann::json json;
+  file >> json;
+  return json;
+}
+
 } // namespace <anonymous>
 
 class StatCommand : public Command {
 public:
   void SetupArgs(CLI::App &app) override {
     app.add_option("-s", _opts.storeFile, "Path to the cafstore.json file")
-        ->required()
+        ->check(CLI::ExistingFile);
+    app.add_option("-m,--mutator-stats", _opts.mutatorStatsFiles,
+                   "Path to the statistics files written by the AFL custom mutator")
         ->check(CLI::ExistingFile);
   }
 
   int Execute(CLI::App &app) override {
-    std::ifstream file { _opts.storeFile };
-    if (file.fail()) {
-      PRINT_LAST_OS_ERR_AND_EXIT_FMT("failed to open file \"%s\"", _opts.storeFile.c_str());
+    if (_opts.storeFile.empty() && _opts.mutatorStatsFiles.empty()) {
+      PRINT_ERR_AND_EXIT("either -s or -m should be specified");
     }
 
-    nlohmann::json json;
-    file >> json;
-    auto store = caf::make_unique<CAFStore>();
-    store->Load(json);
-    file.close();
+    if (!_opts.storeFile.empty()) {
+      auto json = LoadJson(_opts.storeFile);
+      auto store = caf::make_unique<CAFStore>();
+      store->Load(json);
 
-    auto stat = store->GetStatistics();
-    DumpStatistics(stat);
+      auto stat = store->GetStatistics();
+      DumpStatistics(stat);
+    }
+
+    for (const auto& fileName : _opts.mutatorStatsFiles) {
+      auto stat = MutatorStatistics::FromJson(LoadJson(fileName));
+      DumpStatistics(fileName, stat);
+    }
 
     return 0;
   }
@@ -50,12 +102,13 @@ public:
 private:
   struct Opts {
     std::string storeFile; // Path to the cafstore.json file.
+    std::vector<std::string> mutatorStatsFiles; // Paths to the mutator statistics files.
   }; // struct Opts
 
   Opts _opts;
 }; // class StatCommand
 
 static RegisterCommand<StatCommand> X {
-    "stat", "Display statistical information about a cafstore.json file" };
+    "stat", "Display statistical information about a cafstore.json file or mutator statistics" };
 
 } // namespace caf
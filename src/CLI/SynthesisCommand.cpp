@@ -1,11 +1,12 @@
 #include "Command.h"
 #include "Diagnostics.h"
 #include "RegisterCommand.h"
+#include "TestCaseInputs.h"
 
-#include "Infrastructure/Stream.h"
 #include "Infrastructure/Memory.h"
 
 #include "Basic/CAFStore.h"
+#include "Basic/TestCaseValidator.h"
 #include "Fuzzer/TestCase.h"
 #include "Fuzzer/ObjectPool.h"
 #include "Fuzzer/TestCaseDeserializer.h"
@@ -65,7 +66,7 @@ public:
     app.add_option("-t,--target", _opts.Target, "Name of the target. Available targets: js, nodejs")
         ->default_val("js");
     app.add_option("-o,--out", _opts.Output, "Path to the output directory or file");
-    app.add_option("tc", _opts.TestCasePaths, "Paths to the test case files")
+    app.add_option("tc", _opts.TestCasePaths, "Paths to the test case files, corpus packs or directories")
         ->required();
   }
 
@@ -87,18 +88,28 @@ public:
     auto pool = caf::make_unique<ObjectPool>();
     storeFile.close();
 
-    if (_opts.TestCasePaths.size() > 1 && !CreateOutputDirectory(_opts.Output.c_str())) {
+    TestCaseInputs inputs { };
+    for (const auto& path : _opts.TestCasePaths) {
+      if (!inputs.Add(path)) {
+        PRINT_LAST_OS_ERR_AND_EXIT("failed to load test case file");
+      }
+    }
+
+    if (inputs.size() > 1 && !_opts.Output.empty() &&
+        !CreateOutputDirectory(_opts.Output.c_str())) {
       PRINT_LAST_OS_ERR_AND_EXIT("cannot create output directory");
     }
 
-    for (const auto& path : _opts.TestCasePaths) {
-      std::ifstream tcFile { path };
-      if (tcFile.fail()) {
-        PRINT_LAST_OS_ERR_AND_EXIT("failed to load test case file");
+    for (const auto& input : inputs) {
+      const auto& path = input.Name;
+      pool->clear();
+      TestCaseDeserializer de { *pool, input.Data, input.Size };
+      TestCase tc;
+      if (!de.TryDeserialize(tc)) {
+        PRINT_ERR_FMT("%s: malformed test case: %s", path.c_str(),
+                      GetTestCaseValidationErrorMessage(de.GetError()));
+        continue;
       }
-      StlInputStream fileStream { tcFile };
-      TestCaseDeserializer de { *pool, fileStream };
-      auto tc = de.Deserialize();
 
       std::unique_ptr<SynthesisBuilder> synthesisBuilder;
       if (_opts.Target == "js") {
@@ -115,7 +126,7 @@ public:
       if (_opts.Output.empty()) {
         std::cout << code << std::endl;
       } else {
-        if (_opts.TestCasePaths.size() == 1) {
+        if (inputs.size() == 1) {
           WriteTextToFile(_opts.Output.c_str(), code.c_str());
         } else {
           auto outputPath = _opts.Output;
@@ -162,7 +162,7 @@ void TestCaseDumper::DumpValue(const Value& value, DumpContext& context) {
     case ValueKind::String:
       _printer.PrintWithColor(ValueTypeColor, "String");
       _printer << " ";
-      DumpStringValue(value.GetStringValue().c_str());
+      DumpStringValue(value.GetStringValue());
       break;
     case ValueKind::Integer:
       _printer.PrintWithColor(ValueTypeColor, "Integer");
@@ -230,10 +230,9 @@ void TestCaseDumper::DumpHex(const void* data, size_t size) {
   _printer << " }";
 }
 
-void TestCaseDumper::DumpStringValue(const char* s) {
+void TestCaseDumper::DumpStringValue(StringView s) {
   _printer << "\"";
-  while (*s) {
-    auto ch = *s++;
+  for (auto ch : s) {
     if (std::isprint(ch)) {
       if (ch == '"') {
         _printer << "\\\"";
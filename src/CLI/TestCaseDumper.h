@@ -2,6 +2,7 @@
 #define CAF_TEST_CASE_DUMPER_H
 
 #include "Printer.h"
+#include "Infrastructure/StringView.h"
 
 #include <cstdint>
 
@@ -87,7 +88,7 @@ private:
    *
    * @param s the string to dump.
    */
-  void DumpStringValue(const char* s);
+  void DumpStringValue(StringView s);
 
   /**
    * @brief Dump the given integer value.
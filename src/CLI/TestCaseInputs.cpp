@@ -0,0 +1,120 @@
+#include "TestCaseInputs.h"
+
+#include "Infrastructure/Memory.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace caf {
+
+TestCaseInputs::TestCaseInputs()
+  : _packs(),
+    _files(),
+    _inputs()
+{ }
+
+bool TestCaseInputs::Add(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) == -1) {
+    return false;
+  }
+
+  if (S_ISDIR(st.st_mode)) {
+    return AddDirectory(path);
+  }
+
+  if (CorpusPack::IsCorpusPack(path.c_str())) {
+    auto pack = CorpusPack::Open(path.c_str());
+    if (!pack) {
+      errno = EINVAL;
+      return false;
+    }
+
+    _inputs.reserve(_inputs.size() + pack->size());
+    for (size_t i = 0; i < pack->size(); ++i) {
+      auto entry = pack->GetEntry(i);
+      _inputs.push_back(TestCaseInput { entry.Name.str(), entry.Data, entry.Size });
+    }
+    _packs.push_back(std::move(pack));
+    return true;
+  }
+
+  if (CorpusArchive::IsCorpusArchive(path.c_str())) {
+    return AddArchive(path);
+  }
+
+  return AddFile(path);
+}
+
+bool TestCaseInputs::AddArchive(const std::string& path) {
+  auto archive = CorpusArchive::Open(path.c_str());
+  if (!archive) {
+    errno = EINVAL;
+    return false;
+  }
+
+  _inputs.reserve(_inputs.size() + archive->size());
+  for (size_t i = 0; i < archive->size(); ++i) {
+    auto data = caf::make_unique<std::vector<uint8_t>>();
+    archive->Reconstruct(i, *data);
+    _inputs.push_back(TestCaseInput { archive->GetName(i).str(), data->data(), data->size() });
+    _files.push_back(std::move(data));
+  }
+  return true;
+}
+
+bool TestCaseInputs::AddFile(const std::string& path) {
+  std::ifstream file { path, std::ios::binary };
+  if (file.fail()) {
+    return false;
+  }
+
+  auto data = caf::make_unique<std::vector<uint8_t>>(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  _inputs.push_back(TestCaseInput { path, data->data(), data->size() });
+  _files.push_back(std::move(data));
+  return true;
+}
+
+bool TestCaseInputs::AddDirectory(const std::string& path) {
+  auto dir = opendir(path.c_str());
+  if (!dir) {
+    return false;
+  }
+
+  std::vector<std::string> names;
+  while (auto ent = readdir(dir)) {
+    if (ent->d_name[0] == '.') {
+      continue;
+    }
+    names.emplace_back(ent->d_name);
+  }
+  closedir(dir);
+
+  std::sort(names.begin(), names.end());
+  for (const auto& name : names) {
+    auto filePath = path;
+    if (filePath.back() != '/') {
+      filePath.push_back('/');
+    }
+    filePath.append(name);
+
+    struct stat st;
+    if (stat(filePath.c_str(), &st) == -1 || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+    if (!Add(filePath)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace caf
@@ -0,0 +1,80 @@
+#ifndef CAF_TEST_CASE_INPUTS_H
+#define CAF_TEST_CASE_INPUTS_H
+
+#include "Fuzzer/CorpusArchive.h"
+#include "Fuzzer/CorpusPack.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace caf {
+
+/**
+ * @brief A serialized test case given on the command line.
+ *
+ */
+struct TestCaseInput {
+  std::string Name; // Path to the test case file, or name of the corpus pack or archive entry.
+  const uint8_t* Data; // Pointer to the serialized test case.
+  size_t Size; // Size of the serialized test case, in bytes.
+}; // struct TestCaseInput
+
+/**
+ * @brief Collect serialized test cases from test case files, corpus packs, corpus archives and
+ * directories given on the command line.
+ *
+ * Corpus packs are memory-mapped and their entries are not copied. The entries of corpus archives
+ * are reconstructed when they are added. The data of all inputs stays valid for the lifetime of the
+ * TestCaseInputs object.
+ *
+ */
+class TestCaseInputs {
+public:
+  using const_iterator = std::vector<TestCaseInput>::const_iterator;
+
+  explicit TestCaseInputs();
+
+  TestCaseInputs(const TestCaseInputs &) = delete;
+  TestCaseInputs(TestCaseInputs &&) noexcept = default;
+
+  /**
+   * @brief Add the test cases at the given path.
+   *
+   * If the path is a corpus pack or a corpus archive, all its entries are added. If the path is a
+   * directory, all regular files in it are added in the order of their names. Otherwise the file is
+   * added as a single test case.
+   *
+   * @param path the path.
+   * @return true if the test cases are added.
+   * @return false if the path cannot be read. `errno` is set accordingly.
+   */
+  bool Add(const std::string& path);
+
+  size_t size() const { return _inputs.size(); }
+
+  bool empty() const { return _inputs.empty(); }
+
+  const TestCaseInput& operator[](size_t index) const { return _inputs[index]; }
+
+  const_iterator begin() const { return _inputs.begin(); }
+
+  const_iterator end() const { return _inputs.end(); }
+
+private:
+  std::vector<std::unique_ptr<CorpusPack>> _packs;
+  std::vector<std::unique_ptr<std::vector<uint8_t>>> _files; // Contents of files and archive entries.
+  std::vector<TestCaseInput> _inputs;
+
+  bool AddFile(const std::string& path);
+
+  bool AddArchive(const std::string& path);
+
+  bool AddDirectory(const std::string& path);
+}; // class TestCaseInputs
+
+} // namespace caf
+
+#endif
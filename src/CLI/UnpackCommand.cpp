@@ -0,0 +1,119 @@
+#include "Command.h"
+#include "Diagnostics.h"
+#include "RegisterCommand.h"
+#include "Fuzzer/CorpusArchive.h"
+#include "Fuzzer/CorpusPack.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace caf {
+
+class UnpackCommand : public Command {
+public:
+  virtual void SetupArgs(CLI::App& app) override {
+    app.add_option("-o", _opts.outputDir, "Path to the output directory")
+        ->required();
+    app.add_flag("--silence", _opts.silence, "Silent all informative log output");
+    app.add_option("packs", _opts.packFiles, "Corpus pack or archive files to unpack")
+        ->check(CLI::ExistingFile)
+        ->required();
+  }
+
+  virtual int Execute(CLI::App& app) override {
+    if (mkdir(_opts.outputDir.c_str(), 0777) != 0 && errno != EEXIST) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to create directory \"%s\"", _opts.outputDir.c_str());
+    }
+
+    size_t entriesCount = 0;
+    for (const auto& packFile : _opts.packFiles) {
+      if (CorpusArchive::IsCorpusArchive(packFile.c_str())) {
+        auto archive = CorpusArchive::Open(packFile.c_str());
+        if (!archive) {
+          PRINT_ERR_AND_EXIT_FMT("failed to open corpus archive \"%s\"", packFile.c_str());
+        }
+
+        // Entries appended later replace earlier entries of the same name.
+        std::unordered_map<std::string, size_t> latest;
+        for (size_t i = 0; i < archive->size(); ++i) {
+          latest[archive->GetName(i).str()] = i;
+        }
+
+        std::vector<uint8_t> data;
+        for (size_t i = 0; i < archive->size(); ++i) {
+          if (latest[archive->GetName(i).str()] != i) {
+            continue;
+          }
+          archive->Reconstruct(i, data);
+          WriteEntry(archive->GetName(i), data.data(), data.size(), entriesCount++);
+        }
+        continue;
+      }
+
+      auto pack = CorpusPack::Open(packFile.c_str());
+      if (!pack) {
+        PRINT_ERR_AND_EXIT_FMT("failed to open corpus pack \"%s\"", packFile.c_str());
+      }
+
+      for (size_t i = 0; i < pack->size(); ++i) {
+        auto entry = pack->GetEntry(i);
+        WriteEntry(entry.Name, entry.Data, entry.Size, entriesCount++);
+      }
+    }
+
+    if (!_opts.silence) {
+      std::cout << entriesCount << " test cases unpacked." << std::endl;
+    }
+
+    return 0;
+  }
+
+private:
+  struct Opts {
+    std::string outputDir;  // Path to the output directory
+    std::vector<std::string> packFiles; // Paths to the corpus pack or archive files
+    bool silence;           // Silent all informative output.
+  }; // struct Opts
+
+  Opts _opts;
+
+  std::unordered_set<std::string> _names; // Names of the files written so far.
+
+  void WriteEntry(StringView entryName, const uint8_t* data, size_t size, size_t index) {
+    auto name = entryName.str();
+    if (name.empty() || name.find('/') != std::string::npos || name == "." || name == "..") {
+      name = "entry" + std::to_string(index);
+    }
+    // Do not overwrite entries of the same name unpacked earlier.
+    if (!_names.insert(name).second) {
+      auto base = name;
+      for (size_t i = 1; !_names.insert(name).second; ++i) {
+        name = base + "." + std::to_string(i);
+      }
+    }
+
+    std::string outputFileName = _opts.outputDir;
+    outputFileName.push_back('/');
+    outputFileName.append(name);
+
+    std::ofstream outputFile { outputFileName, std::ios::binary };
+    if (outputFile.fail()) {
+      PRINT_LAST_OS_ERR_AND_EXIT_FMT(
+          "failed to create output file \"%s\"", outputFileName.c_str());
+    }
+    outputFile.write(reinterpret_cast<const char *>(data), size);
+  }
+}; // class UnpackCommand
+
+static RegisterCommand<UnpackCommand> X {
+  "unpack", "Extract test cases from corpus pack or archive files" };
+
+} // namespace caf
@@ -1,8 +1,11 @@
+#include "Infrastructure/BloomFilter.h"
 #include "Infrastructure/Memory.h"
 #include "Infrastructure/Random.h"
-#include "Infrastructure/Stream.h"
 #include "Basic/CAFStore.h"
+#include "Basic/ReturnKindFeedback.h"
+#include "Fuzzer/MutatorStatistics.h"
 #include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCaseCanonicalizer.h"
 #include "Fuzzer/TestCaseMutator.h"
 #include "Fuzzer/TestCaseSerializer.h"
 #include "Fuzzer/TestCaseDeserializer.h"
@@ -12,20 +15,58 @@
 
 #include "json/json.hpp"
 
-#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <utility>
 
 namespace {
 
 std::unique_ptr<caf::CAFStore> Store;
+std::unique_ptr<caf::ReturnKindFeedback> Feedback;
+std::unique_ptr<caf::ObjectPool> Pool;
 std::vector<uint8_t> Buffer;
+caf::TestCaseSerializer Serializer;
+caf::MutatorStatistics Stats;
+std::string StatsFilePath;
+
+// Structural hashes of recently emitted test cases.
+caf::TestCaseCanonicalizer Canonicalizer;
+caf::BloomFilter RecentHashes { 1 << 20, 4, 64 * 1024 };
+size_t DuplicateRetries = 4;
+
+// Write the statistics file every this many calls.
+constexpr static const size_t STATS_WRITE_INTERVAL = 1000;
+
+void WriteStatistics() {
+  Stats.Pool = Pool->GetStatistics();
+
+  // Write to a temporary file first so that readers never see a partially written file.
+  auto tempFilePath = StatsFilePath + ".tmp";
+  {
+    std::ofstream file { tempFilePath };
+    if (file.fail()) {
+      return;
+    }
+    file << Stats.ToJson().dump(2) << std::endl;
+  }
+  std::rename(tempFilePath.c_str(), StatsFilePath.c_str());
+}
+
+void UpdateStatistics() {
+  if (StatsFilePath.empty()) {
+    return;
+  }
+  if ((Stats.MutationsCount + Stats.SynthesisCount) % STATS_WRITE_INTERVAL == 1) {
+    WriteStatistics();
+  }
+}
 
 void LoadCAFStore() {
   if (Store) {
@@ -54,6 +95,64 @@ void LoadCAFStore() {
 
   Store = caf::make_unique<caf::CAFStore>();
   Store->Load(json);
+
+  // The pool is reused across calls; clearing it releases all values but keeps the arena memory.
+  Pool = caf::make_unique<caf::ObjectPool>();
+  auto hashConsing = std::getenv(CAF_HASH_CONSING_ENV);
+  if (hashConsing && std::strcmp(hashConsing, "0") != 0) {
+    std::cout << "Hash-consing of arrays is enabled." << std::endl;
+    Pool->SetHashConsingEnabled(true);
+  }
+
+  auto budget = std::getenv(CAF_POOL_BUDGET_ENV);
+  if (budget) {
+    auto budgetMB = std::strtoull(budget, nullptr, 10);
+    std::cout << "Object pool memory budget is " << budgetMB << " MB." << std::endl;
+    Pool->SetMemoryBudget(static_cast<size_t>(budgetMB) * 1024 * 1024);
+  }
+
+  auto retries = std::getenv(CAF_DUPLICATE_RETRIES_ENV);
+  if (retries) {
+    DuplicateRetries = static_cast<size_t>(std::strtoull(retries, nullptr, 10));
+    std::cout << "Duplicate mutants are retried up to " << DuplicateRetries << " times."
+              << std::endl;
+  }
+
+  auto statsDir = std::getenv(CAF_MUTATOR_STATS_DIR_ENV);
+  if (statsDir) {
+    StatsFilePath = caf::MutatorStatistics::GetStatisticsFilePath(statsDir);
+    std::cout << "Writing mutator statistics to file \"" << StatsFilePath << "\"..." << std::endl;
+  }
+
+  auto weightsFilePath = std::getenv("CAF_WEIGHTS");
+  if (weightsFilePath) {
+    std::cout << "Loading API sampling weights from file \"" << weightsFilePath << "\"..."
+              << std::endl;
+
+    std::ifstream weightsFile { weightsFilePath };
+    if (weightsFile.fail()) {
+      auto code = errno;
+      std::cerr << "error: failed to open " << weightsFilePath << ": "
+                << std::strerror(code) << " (" << code << ")"
+                << std::endl;
+      std::exit(1);
+    }
+
+    nlohmann::json weights;
+    weightsFile >> weights;
+    Store->LoadWeights(weights);
+  }
+
+  auto feedbackFilePath = std::getenv(CAF_FEEDBACK_FILE_ENV);
+  if (feedbackFilePath) {
+    std::cout << "Opening return kind feedback file \"" << feedbackFilePath << "\"..."
+              << std::endl;
+    Feedback = caf::ReturnKindFeedback::Open(feedbackFilePath);
+    if (!Feedback) {
+      std::cerr << "warning: failed to open return kind feedback file " << feedbackFilePath
+                << ", feedback is disabled." << std::endl;
+    }
+  }
 }
 
 } // namespace <anonymous>
@@ -71,26 +170,56 @@ size_t afl_custom_mutator(
     LoadCAFStore();
   }
 
-  caf::ObjectPool pool { };
-  caf::MemoryInputStream primaryBufStream { data, size };
-  caf::TestCaseDeserializer de { pool, primaryBufStream };
-  auto primaryTestCase = de.Deserialize();
+  auto& pool = *Pool;
+  pool.clear();
+  // AFL keeps the input buffer alive until this function returns.
+  caf::TestCaseDeserializer de { pool, data, size };
+  caf::TestCase primaryTestCase;
+  if (!de.TryDeserialize(primaryTestCase)) {
+    // Returning 0 makes AFL discard this mutation instead of running the target on it.
+    ++Stats.RejectedCount;
+    return 0;
+  }
 
   caf::Random<> rng { };
   rng.seed(seed);
   caf::TestCaseMutator mutator { *Store, pool, rng };
-  caf::TestCase addTestCase;
+  mutator.SetFeedback(Feedback.get());
 
-  mutator.Mutate(primaryTestCase);
+  if (DuplicateRetries) {
+    RecentHashes.Insert(Canonicalizer.Hash(primaryTestCase));
+  }
+
+  for (size_t retry = 0; ; ++retry) {
+    mutator.Mutate(primaryTestCase);
+    if (!DuplicateRetries) {
+      break;
+    }
 
-  Buffer.clear();
-  caf::MemoryOutputStream outputStream { Buffer };
-  caf::TestCaseSerializer ser { outputStream };
-  ser.Serialize(primaryTestCase);
+    // Mutate the parent again if the mutant duplicates a recently emitted test case, since running
+    // the target on it again would not find anything new.
+    auto hash = Canonicalizer.Hash(primaryTestCase);
+    if (!RecentHashes.MayContain(hash) || retry == DuplicateRetries) {
+      RecentHashes.Insert(hash);
+      break;
+    }
 
-  auto mutatedSize = Buffer.size();
-  assert(mutatedSize <= max_size && "Mutated size is too large.");
-  std::memcpy(mutated_out, Buffer.data(), mutatedSize);
+    ++Stats.DuplicatesCount;
+    pool.clear();
+    caf::TestCaseDeserializer parentDe { pool, data, size };
+    primaryTestCase = caf::TestCase { };
+    parentDe.TryDeserialize(primaryTestCase);
+  }
+
+  auto mutatedSize = Serializer.GetSerializedSize(primaryTestCase);
+  if (mutatedSize > max_size) {
+    // The mutant does not fit into AFL's output buffer; returning 0 makes AFL discard it.
+    return 0;
+  }
+  Serializer.Serialize(primaryTestCase, mutated_out);
+
+  ++Stats.MutationsCount;
+  UpdateStatistics();
 
   return mutatedSize;
 }
@@ -100,10 +229,16 @@ size_t afl_pre_save_handler(uint8_t* data, size_t size, uint8_t** new_data) {
     LoadCAFStore();
   }
 
-  caf::ObjectPool pool { };
-  caf::MemoryInputStream stream { data, size };
-  caf::TestCaseDeserializer de { pool, stream };
-  auto tc = de.Deserialize();
+  auto& pool = *Pool;
+  pool.clear();
+  caf::TestCaseDeserializer de { pool, data, size };
+  caf::TestCase tc;
+  if (!de.TryDeserialize(tc)) {
+    ++Stats.RejectedCount;
+    Buffer.clear();
+    *new_data = Buffer.data();
+    return 0;
+  }
 
   caf::NodejsSynthesisBuilder synthesisBuilder { *Store };
   caf::TestCaseSynthesiser synthesiser { *Store, synthesisBuilder };
@@ -115,6 +250,10 @@ size_t afl_pre_save_handler(uint8_t* data, size_t size, uint8_t** new_data) {
   std::memcpy(Buffer.data(), code.data(), codeSize);
 
   *new_data = Buffer.data();
+
+  ++Stats.SynthesisCount;
+  UpdateStatistics();
+
   return codeSize;
 }
 
@@ -0,0 +1,140 @@
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Random.h"
+#include "Basic/CAFStore.h"
+#include "Fuzzer/ConcurrentMutator.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseDeserializer.h"
+#include "Fuzzer/TestCaseSerializer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace caf {
+
+class ConcurrentMutator::Worker {
+public:
+  explicit Worker(const CAFStore& store)
+    : _pool(),
+      _rnd(),
+      _mutator { store, _pool, _rnd },
+      _serializer()
+  { }
+
+  Worker(const Worker &) = delete;
+  Worker(Worker &&) = delete;
+
+  ObjectPool& pool() { return _pool; }
+
+  TestCaseMutator& mutator() { return _mutator; }
+
+  /**
+   * @brief Mutate the given serialized test case.
+   *
+   * @param input the serialized test case.
+   * @param seed seed of the random number generator.
+   * @param output the output buffer to which the serialized mutant is written. It is left empty if
+   * the input is malformed.
+   */
+  void Mutate(const Input& input, uint64_t seed, std::vector<uint8_t>& output) {
+    _pool.clear();
+    _rnd.seed(seed);
+
+    TestCaseDeserializer de { _pool, input.Data, input.Size };
+    TestCase tc;
+    if (!de.TryDeserialize(tc)) {
+      return;
+    }
+
+    _mutator.Mutate(tc);
+
+    _serializer.Serialize(tc, output);
+  }
+
+private:
+  ObjectPool _pool;
+  Random<> _rnd;
+  TestCaseMutator _mutator;
+  TestCaseSerializer _serializer;
+}; // class ConcurrentMutator::Worker
+
+ConcurrentMutator::ConcurrentMutator(const CAFStore& store, size_t threadsCount)
+  : _opt(),
+    _workers()
+{
+  if (threadsCount == 0) {
+    threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  _workers.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i) {
+    _workers.push_back(caf::make_unique<Worker>(store));
+  }
+}
+
+ConcurrentMutator::~ConcurrentMutator() = default;
+
+void ConcurrentMutator::SetFeedback(const ReturnKindFeedback* feedback) {
+  for (auto& worker : _workers) {
+    worker->mutator().SetFeedback(feedback);
+  }
+}
+
+void ConcurrentMutator::SetHashConsingEnabled(bool enabled) {
+  for (auto& worker : _workers) {
+    worker->pool().SetHashConsingEnabled(enabled);
+  }
+}
+
+void ConcurrentMutator::SetPoolMemoryBudget(size_t budget) {
+  for (auto& worker : _workers) {
+    worker->pool().SetMemoryBudget(budget);
+  }
+}
+
+std::vector<std::vector<uint8_t>> ConcurrentMutator::Mutate(
+    const std::vector<Input>& inputs, size_t mutantsCount, uint64_t seed) {
+  auto jobsCount = inputs.size() * mutantsCount;
+  std::vector<std::vector<uint8_t>> mutants(jobsCount);
+  std::atomic<size_t> nextJob { 0 };
+
+  auto run = [&] (Worker& worker) {
+    worker.mutator().options() = _opt;
+    while (true) {
+      auto job = nextJob.fetch_add(1, std::memory_order_relaxed);
+      if (job >= jobsCount) {
+        break;
+      }
+      worker.Mutate(inputs[job / mutantsCount], seed + job, mutants[job]);
+    }
+  };
+
+  // The calling thread runs the first worker.
+  std::vector<std::thread> threads;
+  threads.reserve(_workers.size() - 1);
+  for (size_t i = 1; i < _workers.size(); ++i) {
+    threads.emplace_back(run, std::ref(*_workers[i]));
+  }
+  run(*_workers[0]);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return mutants;
+}
+
+std::vector<std::vector<uint8_t>> ConcurrentMutator::Mutate(
+    const std::vector<std::vector<uint8_t>>& inputs, size_t mutantsCount, uint64_t seed) {
+  std::vector<Input> views;
+  views.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    views.push_back(Input { input.data(), input.size() });
+  }
+  return Mutate(views, mutantsCount, seed);
+}
+
+} // namespace caf
@@ -0,0 +1,413 @@
+#include "Infrastructure/BufferReader.h"
+#include "Infrastructure/Stream.h"
+#include "Infrastructure/Varint.h"
+#include "Fuzzer/CorpusArchive.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace caf {
+
+namespace {
+
+/**
+ * @brief Get the AFL queue ID from a file name of the form `id:NNNNNN,...`.
+ *
+ * @param name the file name.
+ * @return std::string the queue ID, or an empty string if the name does not follow AFL's convention.
+ */
+std::string GetAFLQueueId(StringView name) {
+  auto s = name.str();
+  if (s.compare(0, 3, "id:") != 0) {
+    return std::string { };
+  }
+  auto end = s.find(',', 3);
+  return s.substr(3, end == std::string::npos ? std::string::npos : end - 3);
+}
+
+/**
+ * @brief Get the AFL queue ID of the parent from a file name of the form `id:NNNNNN,src:MMMMMM,...`.
+ * Only the first parent of spliced test cases is returned.
+ *
+ * @param name the file name.
+ * @return std::string the queue ID of the parent, or an empty string if there is none.
+ */
+std::string GetAFLParentId(StringView name) {
+  auto s = name.str();
+  auto start = s.find("src:");
+  if (start == std::string::npos) {
+    return std::string { };
+  }
+  start += 4;
+  auto end = start;
+  while (end < s.length() && s[end] >= '0' && s[end] <= '9') {
+    ++end;
+  }
+  return s.substr(start, end - start);
+}
+
+void AppendVarint(std::vector<uint8_t>& out, uint64_t value) {
+  uint8_t buffer[MaxVarintSize];
+  auto size = EncodeVarint(value, buffer);
+  out.insert(out.end(), buffer, buffer + size);
+}
+
+} // namespace <anonymous>
+
+CorpusArchive::CorpusArchive(std::vector<uint8_t> data)
+  : _data(std::move(data)),
+    _entries()
+{ }
+
+std::unique_ptr<CorpusArchive> CorpusArchive::Open(const char* path) {
+  std::ifstream file { path, std::ios::binary };
+  if (file.fail()) {
+    return nullptr;
+  }
+
+  std::vector<uint8_t> data { std::istreambuf_iterator<char>(file),
+                              std::istreambuf_iterator<char>() };
+  if (file.bad()) {
+    return nullptr;
+  }
+
+  std::unique_ptr<CorpusArchive> archive { new CorpusArchive(std::move(data)) };
+  if (!archive->Parse()) {
+    return nullptr;
+  }
+  return archive;
+}
+
+bool CorpusArchive::IsCorpusArchive(const char* path) {
+  std::ifstream file { path, std::ios::binary };
+  uint32_t magic = 0;
+  file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  return file.gcount() == sizeof(magic) && magic == Magic;
+}
+
+bool CorpusArchive::Parse() {
+  if (_data.size() < HeaderSize) {
+    return false;
+  }
+
+  uint32_t magic;
+  uint32_t version;
+  std::memcpy(&magic, _data.data(), sizeof(magic));
+  std::memcpy(&version, _data.data() + sizeof(magic), sizeof(version));
+  if (magic != Magic || version != Version) {
+    return false;
+  }
+
+  BufferReader reader { _data.data() + HeaderSize, _data.size() - HeaderSize };
+  while (reader.remaining()) {
+    Entry entry;
+    auto nameSize = ReadVarint(reader);
+    auto name = reader.ReadBytes(nameSize);
+    entry.Name = StringView { reinterpret_cast<const char *>(name), reader.GetLastReadSize() };
+
+    auto parent = ReadVarint(reader);
+    entry.Parent = parent ? parent - 1 : NoParent;
+    entry.Size = ReadVarint(reader);
+    if (parent) {
+      entry.OpsCount = ReadVarint(reader);
+      entry.PayloadSize = ReadVarint(reader);
+    } else {
+      entry.OpsCount = 0;
+      entry.PayloadSize = entry.Size;
+    }
+    entry.Payload = reader.ReadBytes(entry.PayloadSize);
+
+    if (reader.fail()) {
+      return false;
+    }
+    if (parent && (entry.Parent >= _entries.size() || !ValidateEditScript(entry))) {
+      return false;
+    }
+
+    _entries.push_back(entry);
+  }
+
+  return true;
+}
+
+bool CorpusArchive::ValidateEditScript(const Entry& entry) const {
+  auto parentSize = _entries[entry.Parent].Size;
+  BufferReader reader { entry.Payload, entry.PayloadSize };
+  size_t size = 0;
+  for (size_t i = 0; i < entry.OpsCount; ++i) {
+    auto op = reader.ReadByte();
+    if (op == CopyOp) {
+      auto offset = ReadVarint(reader);
+      auto length = ReadVarint(reader);
+      if (offset > parentSize || length > parentSize - offset) {
+        return false;
+      }
+      size += length;
+    } else if (op == InsertOp) {
+      auto length = ReadVarint(reader);
+      reader.ReadBytes(length);
+      size += reader.GetLastReadSize();
+    } else {
+      return false;
+    }
+
+    if (reader.fail() || size > entry.Size) {
+      return false;
+    }
+  }
+
+  return !reader.remaining() && size == entry.Size;
+}
+
+void CorpusArchive::ApplyEditScript(const Entry& entry, const std::vector<uint8_t>& parent,
+                                    std::vector<uint8_t>& out) {
+  out.clear();
+  out.reserve(entry.Size);
+
+  BufferReader reader { entry.Payload, entry.PayloadSize };
+  for (size_t i = 0; i < entry.OpsCount; ++i) {
+    if (reader.ReadByte() == CopyOp) {
+      auto offset = ReadVarint(reader);
+      auto length = ReadVarint(reader);
+      out.insert(out.end(), parent.begin() + offset, parent.begin() + offset + length);
+    } else {
+      auto length = ReadVarint(reader);
+      auto bytes = reader.ReadBytes(length);
+      out.insert(out.end(), bytes, bytes + length);
+    }
+  }
+}
+
+void CorpusArchive::Reconstruct(size_t index, std::vector<uint8_t>& out) const {
+  assert(index < _entries.size() && "index is out of range.");
+
+  std::vector<size_t> chain;
+  for (auto i = index; i != NoParent; i = _entries[i].Parent) {
+    chain.push_back(i);
+  }
+
+  const auto& root = _entries[chain.back()];
+  out.assign(root.Payload, root.Payload + root.PayloadSize);
+
+  std::vector<uint8_t> parent;
+  for (auto i = chain.rbegin() + 1; i != chain.rend(); ++i) {
+    std::swap(out, parent);
+    ApplyEditScript(_entries[*i], parent, out);
+  }
+}
+
+CorpusArchiveWriter::CorpusArchiveWriter(size_t maxChainDepth)
+  : _maxChainDepth(maxChainDepth),
+    _entries(),
+    _aflIds(),
+    _baseNames(),
+    _base(nullptr),
+    _baseCount(0),
+    _deltaCount(0),
+    _skippedCount(0),
+    _previousIndex(CorpusArchive::NoParent),
+    _previous(),
+    _output(),
+    _script()
+{ }
+
+void CorpusArchiveWriter::AppendTo(const CorpusArchive& archive) {
+  assert(_entries.empty() && "AppendTo should be called before any entries are added.");
+
+  _entries.reserve(archive.size());
+  for (size_t i = 0; i < archive.size(); ++i) {
+    Entry entry;
+    entry.Parent = archive.GetParent(i);
+    entry.Depth = entry.Parent == CorpusArchive::NoParent ? 0 : _entries[entry.Parent].Depth + 1;
+    entry.Size = archive.GetEntrySize(i);
+    entry.OpsCount = 0;
+    entry.PayloadOffset = 0;
+    entry.PayloadSize = 0;
+    _entries.push_back(entry);
+
+    auto name = archive.GetName(i);
+    auto id = GetAFLQueueId(name);
+    if (!id.empty()) {
+      _aflIds[id] = i;
+    }
+    // Later entries replace earlier entries of the same name.
+    _baseNames[name.str()] = i;
+  }
+
+  _base = &archive;
+  _baseCount = _entries.size();
+}
+
+bool CorpusArchiveWriter::AddEntry(StringView name, const uint8_t* data, size_t size) {
+  if (IsArchived(name, data, size)) {
+    ++_skippedCount;
+    return false;
+  }
+
+  size_t candidates[2] = { CorpusArchive::NoParent, CorpusArchive::NoParent };
+  auto parentId = GetAFLParentId(name);
+  if (!parentId.empty()) {
+    auto parent = _aflIds.find(parentId);
+    if (parent != _aflIds.end()) {
+      candidates[0] = parent->second;
+    }
+  }
+  if (!_entries.empty()) {
+    candidates[1] = _entries.size() - 1;
+  }
+
+  // Pick the parent that gives the smallest encoding.
+  auto bestParent = CorpusArchive::NoParent;
+  size_t bestOpsCount = 0;
+  auto bestSize = size;
+  std::vector<uint8_t> bestScript;
+  std::vector<uint8_t> parentData;
+  for (auto candidate : candidates) {
+    if (candidate == CorpusArchive::NoParent || _entries[candidate].Depth >= _maxChainDepth) {
+      continue;
+    }
+    Reconstruct(candidate, parentData);
+    auto opsCount = EncodeEditScript(parentData, data, size, _script);
+    auto encodedSize = GetVarintSize(opsCount) + GetVarintSize(_script.size()) + _script.size();
+    if (encodedSize < bestSize) {
+      bestParent = candidate;
+      bestOpsCount = opsCount;
+      bestSize = encodedSize;
+      std::swap(bestScript, _script);
+    }
+  }
+
+  AppendVarint(_output, name.length());
+  _output.insert(_output.end(), name.begin(), name.end());
+  AppendVarint(_output, bestParent == CorpusArchive::NoParent ? 0 : bestParent + 1);
+  AppendVarint(_output, size);
+
+  Entry entry;
+  entry.Parent = bestParent;
+  entry.Size = size;
+  if (bestParent == CorpusArchive::NoParent) {
+    entry.Depth = 0;
+    entry.OpsCount = 0;
+    entry.PayloadOffset = _output.size();
+    entry.PayloadSize = size;
+    _output.insert(_output.end(), data, data + size);
+  } else {
+    AppendVarint(_output, bestOpsCount);
+    AppendVarint(_output, bestScript.size());
+    entry.Depth = _entries[bestParent].Depth + 1;
+    entry.OpsCount = bestOpsCount;
+    entry.PayloadOffset = _output.size();
+    entry.PayloadSize = bestScript.size();
+    _output.insert(_output.end(), bestScript.begin(), bestScript.end());
+    ++_deltaCount;
+  }
+
+  auto id = GetAFLQueueId(name);
+  if (!id.empty()) {
+    _aflIds[id] = _entries.size();
+  }
+  _previousIndex = _entries.size();
+  _previous.assign(data, data + size);
+  _entries.push_back(entry);
+  return true;
+}
+
+bool CorpusArchiveWriter::IsArchived(StringView name, const uint8_t* data, size_t size) const {
+  if (!_base) {
+    return false;
+  }
+
+  auto base = _baseNames.find(name.str());
+  if (base == _baseNames.end() || _base->GetEntrySize(base->second) != size) {
+    return false;
+  }
+
+  std::vector<uint8_t> archived;
+  _base->Reconstruct(base->second, archived);
+  return size == 0 || std::memcmp(archived.data(), data, size) == 0;
+}
+
+void CorpusArchiveWriter::Reconstruct(size_t index, std::vector<uint8_t>& out) const {
+  if (index == _previousIndex) {
+    out = _previous;
+    return;
+  }
+  if (index < _baseCount) {
+    _base->Reconstruct(index, out);
+    return;
+  }
+
+  const auto& entry = _entries[index];
+  auto payload = _output.data() + entry.PayloadOffset;
+  if (entry.Parent == CorpusArchive::NoParent) {
+    out.assign(payload, payload + entry.PayloadSize);
+    return;
+  }
+
+  // Parent chains are at most `_maxChainDepth` entries long, so the recursion is bounded.
+  std::vector<uint8_t> parent;
+  Reconstruct(entry.Parent, parent);
+
+  CorpusArchive::Entry script;
+  script.Parent = entry.Parent;
+  script.Size = entry.Size;
+  script.OpsCount = entry.OpsCount;
+  script.Payload = payload;
+  script.PayloadSize = entry.PayloadSize;
+  CorpusArchive::ApplyEditScript(script, parent, out);
+}
+
+void CorpusArchiveWriter::Write(OutputStream& out) const {
+  if (!_base) {
+    auto magic = CorpusArchive::Magic;
+    auto version = CorpusArchive::Version;
+    out.Write(reinterpret_cast<const uint8_t *>(&magic), sizeof(magic));
+    out.Write(reinterpret_cast<const uint8_t *>(&version), sizeof(version));
+  }
+  out.Write(_output.data(), _output.size());
+}
+
+size_t CorpusArchiveWriter::EncodeEditScript(
+    const std::vector<uint8_t>& parent, const uint8_t* data, size_t size,
+    std::vector<uint8_t>& script) const {
+  // Mutations usually change a single region of the serialized test case, so the edit script keeps
+  // the common prefix and suffix of the parent and replaces everything in between.
+  auto maxCommon = std::min(parent.size(), size);
+  size_t prefix = 0;
+  while (prefix < maxCommon && parent[prefix] == data[prefix]) {
+    ++prefix;
+  }
+  size_t suffix = 0;
+  while (suffix < maxCommon - prefix &&
+         parent[parent.size() - 1 - suffix] == data[size - 1 - suffix]) {
+    ++suffix;
+  }
+
+  script.clear();
+  size_t opsCount = 0;
+  if (prefix) {
+    script.push_back(CorpusArchive::CopyOp);
+    AppendVarint(script, 0);
+    AppendVarint(script, prefix);
+    ++opsCount;
+  }
+  if (prefix + suffix < size) {
+    script.push_back(CorpusArchive::InsertOp);
+    AppendVarint(script, size - prefix - suffix);
+    script.insert(script.end(), data + prefix, data + size - suffix);
+    ++opsCount;
+  }
+  if (suffix) {
+    script.push_back(CorpusArchive::CopyOp);
+    AppendVarint(script, parent.size() - suffix);
+    AppendVarint(script, suffix);
+    ++opsCount;
+  }
+  return opsCount;
+}
+
+} // namespace caf
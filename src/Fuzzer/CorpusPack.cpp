@@ -0,0 +1,128 @@
+#include "Infrastructure/Stream.h"
+#include "Fuzzer/CorpusPack.h"
+
+#include <cassert>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace caf {
+
+CorpusPack::CorpusPack(const uint8_t* base, size_t mappedSize)
+  : _base(base),
+    _mappedSize(mappedSize),
+    _index(reinterpret_cast<const IndexEntry *>(base + sizeof(Header))),
+    _entriesCount(reinterpret_cast<const Header *>(base)->EntriesCount)
+{ }
+
+CorpusPack::~CorpusPack() {
+  munmap(const_cast<uint8_t *>(_base), _mappedSize);
+}
+
+std::unique_ptr<CorpusPack> CorpusPack::Open(const char* path) {
+  auto fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return nullptr;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+
+  auto size = static_cast<size_t>(st.st_size);
+  auto base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+
+  std::unique_ptr<CorpusPack> pack {
+      new CorpusPack(reinterpret_cast<const uint8_t *>(base), size) };
+
+  auto header = reinterpret_cast<const Header *>(base);
+  if (header->Magic != Magic || header->Version != Version ||
+      header->EntriesCount > (size - sizeof(Header)) / sizeof(IndexEntry)) {
+    return nullptr;
+  }
+
+  // Check all entries up front so that GetEntry never points outside of the mapping.
+  for (size_t i = 0; i < pack->_entriesCount; ++i) {
+    const auto& entry = pack->_index[i];
+    if (entry.DataOffset > size || entry.DataSize > size - entry.DataOffset ||
+        entry.NameOffset > size || entry.NameSize > size - entry.NameOffset) {
+      return nullptr;
+    }
+  }
+
+  // The test cases are read sequentially in most cases.
+  madvise(base, size, MADV_SEQUENTIAL);
+
+  return pack;
+}
+
+bool CorpusPack::IsCorpusPack(const char* path) {
+  auto fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+
+  uint32_t magic = 0;
+  auto bytesRead = read(fd, &magic, sizeof(magic));
+  close(fd);
+  return bytesRead == sizeof(magic) && magic == Magic;
+}
+
+CorpusPack::Entry CorpusPack::GetEntry(size_t index) const {
+  assert(index < _entriesCount && "index is out of range.");
+  const auto& entry = _index[index];
+  return Entry {
+    StringView { reinterpret_cast<const char *>(_base + entry.NameOffset),
+                 static_cast<size_t>(entry.NameSize) },
+    _base + entry.DataOffset,
+    static_cast<size_t>(entry.DataSize)
+  };
+}
+
+CorpusPackWriter::CorpusPackWriter()
+  : _entries(),
+    _names(),
+    _data()
+{ }
+
+void CorpusPackWriter::AddEntry(StringView name, const uint8_t* data, size_t size) {
+  CorpusPack::IndexEntry entry;
+  entry.DataOffset = _data.size();
+  entry.DataSize = size;
+  entry.NameOffset = _names.size();
+  entry.NameSize = name.length();
+  _entries.push_back(entry);
+
+  _names.append(name.data(), name.length());
+  _data.insert(_data.end(), data, data + size);
+}
+
+void CorpusPackWriter::Write(OutputStream& out) const {
+  CorpusPack::Header header;
+  header.Magic = CorpusPack::Magic;
+  header.Version = CorpusPack::Version;
+  header.EntriesCount = _entries.size();
+  out.Write(&header, sizeof(header));
+
+  auto namesOffset = sizeof(CorpusPack::Header) + _entries.size() * sizeof(CorpusPack::IndexEntry);
+  auto dataOffset = namesOffset + _names.size();
+  for (auto entry : _entries) {
+    entry.NameOffset += namesOffset;
+    entry.DataOffset += dataOffset;
+    out.Write(&entry, sizeof(entry));
+  }
+
+  out.Write(_names.data(), _names.size());
+  out.Write(_data.data(), _data.size());
+}
+
+} // namespace caf
@@ -135,7 +135,7 @@ void JavaScriptSynthesisBuilder::WriteFunctionCallStatement(
   output << " } catch (e) { }";
 }
 
-std::string JavaScriptSynthesisBuilder::EscapeString(const std::string& s) const {
+std::string JavaScriptSynthesisBuilder::EscapeString(StringView s) const {
   std::string ret;
   ret.reserve(s.size());
 
@@ -0,0 +1,85 @@
+#include "Fuzzer/MutatorStatistics.h"
+
+#include <unistd.h>
+
+namespace caf {
+
+MutatorStatistics::MutatorStatistics()
+  : MutationsCount(0),
+    SynthesisCount(0),
+    RejectedCount(0),
+    DuplicatesCount(0),
+    Pool()
+{ }
+
+nlohmann::json MutatorStatistics::ToJson() const {
+  auto values = nlohmann::json::object();
+  for (size_t k = 0; k < ValueKindsCount; ++k) {
+    auto name = GetValueKindName(static_cast<ValueKind>(k));
+    values[name] = nlohmann::json::object({
+      { "count", Pool.ValuesCount[k] },
+      { "bytes", Pool.ValueBytes[k] }
+    });
+  }
+
+  auto pool = nlohmann::json::object({
+    { "values", std::move(values) },
+    { "bytesAllocated", Pool.BytesAllocated },
+    { "bytesReserved", Pool.BytesReserved },
+    { "highWaterMark", Pool.HighWaterMark },
+    { "budget", Pool.MemoryBudget },
+    { "clears", Pool.ClearsCount },
+    { "budgetResets", Pool.BudgetResetsCount }
+  });
+
+  return nlohmann::json::object({
+    { "mutations", MutationsCount },
+    { "synthesis", SynthesisCount },
+    { "rejected", RejectedCount },
+    { "duplicates", DuplicatesCount },
+    { "pool", std::move(pool) }
+  });
+}
+
+MutatorStatistics MutatorStatistics::FromJson(const nlohmann::json& json) {
+  MutatorStatistics stat;
+  stat.MutationsCount = json.value("mutations", static_cast<size_t>(0));
+  stat.SynthesisCount = json.value("synthesis", static_cast<size_t>(0));
+  stat.RejectedCount = json.value("rejected", static_cast<size_t>(0));
+  stat.DuplicatesCount = json.value("duplicates", static_cast<size_t>(0));
+
+  if (!json.contains("pool")) {
+    return stat;
+  }
+  const auto& pool = json["pool"];
+  stat.Pool.BytesAllocated = pool.value("bytesAllocated", static_cast<size_t>(0));
+  stat.Pool.BytesReserved = pool.value("bytesReserved", static_cast<size_t>(0));
+  stat.Pool.HighWaterMark = pool.value("highWaterMark", static_cast<size_t>(0));
+  stat.Pool.MemoryBudget = pool.value("budget", static_cast<size_t>(0));
+  stat.Pool.ClearsCount = pool.value("clears", static_cast<size_t>(0));
+  stat.Pool.BudgetResetsCount = pool.value("budgetResets", static_cast<size_t>(0));
+
+  if (pool.contains("values")) {
+    const auto& values = pool["values"];
+    for (size_t k = 0; k < ValueKindsCount; ++k) {
+      auto name = GetValueKindName(static_cast<ValueKind>(k));
+      if (!values.contains(name)) {
+        continue;
+      }
+      stat.Pool.ValuesCount[k] = values[name].value("count", static_cast<size_t>(0));
+      stat.Pool.ValueBytes[k] = values[name].value("bytes", static_cast<size_t>(0));
+    }
+  }
+
+  return stat;
+}
+
+std::string MutatorStatistics::GetStatisticsFilePath(const std::string& dir) {
+  std::string path = dir;
+  path.append("/mutator-");
+  path.append(std::to_string(getpid()));
+  path.append(".json");
+  return path;
+}
+
+} // namespace caf
@@ -1,7 +1,11 @@
+#include "Infrastructure/Hash.h"
 #include "Infrastructure/Memory.h"
 #include "Fuzzer/ObjectPool.h"
 
+#include <cassert>
 #include <cmath>
+#include <cstring>
+#include <functional>
 #include <limits>
 #include <utility>
 #include <algorithm>
@@ -10,69 +14,165 @@ namespace caf {
 
 namespace {
 
-template <typename T, typename ...Args>
-T* get_or_create(std::unique_ptr<T>& ptr, Args&&... args) {
-  if (!ptr) {
-    ptr = caf::make_unique<T>(std::forward<Args>(args)...);
+/**
+ * @brief Determine whether two elements of frozen arrays are structurally identical.
+ *
+ * Strings and singletons are interned by the pool and elements that are arrays have been hash-consed
+ * when they were frozen, so comparing pointers is sufficient for all values except integers and
+ * floats, which are compared bitwise.
+ *
+ */
+bool AreElementsIdentical(const Value* lhs, const Value* rhs) {
+  if (lhs == rhs) {
+    return true;
+  }
+  if (lhs->kind() != rhs->kind()) {
+    return false;
+  }
+  switch (lhs->kind()) {
+    case ValueKind::Integer:
+      return lhs->GetIntegerValue() == rhs->GetIntegerValue();
+    case ValueKind::Float: {
+      auto lhsValue = lhs->GetFloatValue();
+      auto rhsValue = rhs->GetFloatValue();
+      return std::memcmp(&lhsValue, &rhsValue, sizeof(double)) == 0;
+    }
+    default:
+      return false;
+  }
+}
+
+size_t HashElement(const Value* value) {
+  switch (value->kind()) {
+    case ValueKind::Integer:
+      return std::hash<int32_t> { }(value->GetIntegerValue());
+    case ValueKind::Float: {
+      auto floatValue = value->GetFloatValue();
+      uint64_t bits;
+      std::memcpy(&bits, &floatValue, sizeof(bits));
+      return std::hash<uint64_t> { }(bits);
+    }
+    default:
+      return std::hash<const Value *> { }(value);
   }
-  return ptr.get();
 }
 
 } // namespace <anonymous>
 
 constexpr const static size_t INTEGER_TABLE_SIZE = 500;
 constexpr const static int32_t INTEGER_BIAS = 100;
-constexpr const static size_t MAX_STRING_LEN_IN_TABLE = 10;
+constexpr const static size_t STRING_TABLE_INIT_SIZE = 64; // Must be a power of 2.
 constexpr const static size_t PLACEHOLDER_TABLE_INIT_SIZE = 10;
+constexpr const static size_t SINGLETON_ARENA_CHUNK_SIZE = 4096;
 
 ObjectPool::ObjectPool()
-  : _values(),
+  : _arena(),
+    _singletonArena(SINGLETON_ARENA_CHUNK_SIZE),
+    _stringArena(),
+    _values(),
     _undef(nullptr),
     _null(nullptr),
     _funcValues(),
     _bool { nullptr, nullptr },
-    _strToValue(),
+    _strTable(STRING_TABLE_INIT_SIZE),
+    _strSlots(),
+    _strCount(0),
     _intTable(caf::make_unique<IntegerValue* []>(INTEGER_TABLE_SIZE)),
     _nan(nullptr),
     _inf(nullptr),
     _negInf(nullptr),
-    _arrayValues(),
-    _placeholderValues(PLACEHOLDER_TABLE_INIT_SIZE)
+    _placeholderValues(PLACEHOLDER_TABLE_INIT_SIZE),
+    _hashConsing(false),
+    _arrayTable(),
+    _counts(),
+    _bytes(),
+    _singletonCounts(),
+    _singletonBytes(),
+    _highWaterMark(0),
+    _budget(0),
+    _clearsCount(0),
+    _budgetResetsCount(0)
+{ }
+
+ObjectPool::Statistics::Statistics()
+  : ValuesCount(),
+    ValueBytes(),
+    BytesAllocated(0),
+    BytesReserved(0),
+    HighWaterMark(0),
+    MemoryBudget(0),
+    ClearsCount(0),
+    BudgetResetsCount(0)
 { }
 
 Value* ObjectPool::GetUndefinedValue() {
-  return get_or_create(_undef, ValueKind::Undefined);
+  return GetOrCreateSingleton(_undef, ValueKind::Undefined);
 }
 
 Value* ObjectPool::GetNullValue() {
-  return get_or_create(_null, ValueKind::Null);
+  return GetOrCreateSingleton(_null, ValueKind::Null);
 }
 
 FunctionValue* ObjectPool::GetFunctionValue(FunctionIdType funcId) {
-  auto i = _funcValues.find(funcId);
-  if (i == _funcValues.end()) {
-    return _funcValues.emplace(funcId, caf::make_unique<FunctionValue>(funcId)).first->second.get();
-  } else {
-    return i->second.get();
-  }
+  auto& value = _funcValues[funcId];
+  return GetOrCreateSingleton(value, funcId);
 }
 
 BooleanValue* ObjectPool::GetBooleanValue(bool value) {
-  return get_or_create(_bool[static_cast<int>(value)], value);
+  return GetOrCreateSingleton(_bool[static_cast<int>(value)], value);
 }
 
-StringValue* ObjectPool::GetOrCreateStringValue(std::string s) {
-  if (s.length() <= MAX_STRING_LEN_IN_TABLE) {
-    auto i = _strToValue.find(s);
-    if (i != _strToValue.end()) {
-      return i->second;
-    }
+StringValue* ObjectPool::GetOrCreateStringValue(StringView s) {
+  return InternString(s, true);
+}
 
-    auto value = CreateValue<StringValue>(s);
-    _strToValue.emplace(std::move(s), value);
-    return value;
+StringValue* ObjectPool::GetOrCreateStringValueView(StringView s) {
+  return InternString(s, false);
+}
+
+StringValue* ObjectPool::InternString(StringView s, bool copy) {
+  auto hash = Hasher<StringView> { }(s);
+  auto& slot = FindStringSlot(s, hash);
+  if (slot) {
+    return slot;
+  }
+
+  StringValue* value;
+  if (copy) {
+    auto data = _stringArena.CopyString(s.data(), s.length());
+    value = CreateValue<StringValue>(data, s.length());
+    _bytes[static_cast<size_t>(ValueKind::String)] += s.length() + 1;
   } else {
-    return CreateValue<StringValue>(std::move(s));
+    value = CreateValue<StringValue>(s.data(), s.length());
+  }
+  slot = value;
+  _strSlots.push_back(static_cast<size_t>(&slot - _strTable.data()));
+
+  // Keep the load factor of the string table below 1/2.
+  if (++_strCount * 2 > _strTable.size()) {
+    GrowStringTable();
+  }
+  return value;
+}
+
+StringValue*& ObjectPool::FindStringSlot(StringView s, size_t hash) {
+  auto mask = _strTable.size() - 1;
+  auto index = hash & mask;
+  while (_strTable[index] && _strTable[index]->value() != s) {
+    index = (index + 1) & mask;
+  }
+  return _strTable[index];
+}
+
+void ObjectPool::GrowStringTable() {
+  std::vector<StringValue *> oldTable(_strTable.size() * 2);
+  oldTable.swap(_strTable);
+  for (auto& index : _strSlots) {
+    auto value = oldTable[index];
+    auto s = value->value();
+    auto& slot = FindStringSlot(s, Hasher<StringView> { }(s));
+    slot = value;
+    index = static_cast<size_t>(&slot - _strTable.data());
   }
 }
 
@@ -99,19 +199,15 @@ IntegerValue* ObjectPool::GetOrCreateIntegerValue(int32_t value) {
 
 FloatValue* ObjectPool::GetOrCreateFloatValue(double value) {
   switch (std::fpclassify(value)) {
-    case FP_NAN: {
-      if (!_nan) {
-        _nan = caf::make_unique<FloatValue>(std::numeric_limits<double>::quiet_NaN());
-      }
-      return _nan.get();
-    }
+    case FP_NAN:
+      return GetOrCreateSingleton(_nan, std::numeric_limits<double>::quiet_NaN());
     case FP_INFINITE: {
       if (value > 0) {
         // value is positive infinity.
-        return get_or_create(_inf, std::numeric_limits<double>::infinity());
+        return GetOrCreateSingleton(_inf, std::numeric_limits<double>::infinity());
       } else {
         // value is negative infinity.
-        return get_or_create(_inf, -std::numeric_limits<double>::infinity());
+        return GetOrCreateSingleton(_negInf, -std::numeric_limits<double>::infinity());
       }
     }
     default:
@@ -119,11 +215,36 @@ FloatValue* ObjectPool::GetOrCreateFloatValue(double value) {
   }
 }
 
-ArrayValue* ObjectPool::CreateArrayValue() {
-  auto value = caf::make_unique<ArrayValue>();
-  auto ret = value.get();
-  _arrayValues.push_back(std::move(value));
-  return ret;
+ArrayValue* ObjectPool::CreateArrayValue(size_t size) {
+  auto elements = _arena.AllocateArray<Value *>(size);
+  std::fill(elements, elements + size, nullptr);
+  CountValue(ValueKind::Array, sizeof(ArrayValue) + size * sizeof(Value *), false);
+  return _arena.Create<ArrayValue>(elements, size);
+}
+
+ArrayValue* ObjectPool::FreezeArray(ArrayValue* array) {
+  assert(!array->frozen() && "The array has been frozen.");
+  array->Freeze();
+  if (!_hashConsing) {
+    return array;
+  }
+
+  auto hash = std::hash<size_t> { }(array->size());
+  for (auto element : *array) {
+    hash = CombineHash(hash, HashElement(element));
+  }
+
+  auto candidates = _arrayTable.equal_range(hash);
+  for (auto i = candidates.first; i != candidates.second; ++i) {
+    auto candidate = i->second;
+    if (candidate->size() == array->size() &&
+        std::equal(candidate->begin(), candidate->end(), array->begin(), AreElementsIdentical)) {
+      return candidate;
+    }
+  }
+
+  _arrayTable.emplace(hash, array);
+  return array;
 }
 
 PlaceholderValue* ObjectPool::GetPlaceholderValue(size_t index) {
@@ -131,17 +252,94 @@ PlaceholderValue* ObjectPool::GetPlaceholderValue(size_t index) {
     _placeholderValues.resize(index + 1);
   }
 
-  auto& ptr = _placeholderValues.at(index);
-  if (!ptr) {
-    ptr = caf::make_unique<PlaceholderValue>(index);
-  }
-  return ptr.get();
+  return GetOrCreateSingleton(_placeholderValues.at(index), index);
 }
 
-void ObjectPool::clear() {
+void ObjectPool::clear(bool keepSingletons) {
+  _highWaterMark = std::max(_highWaterMark, GetBytesAllocated());
+  ++_clearsCount;
+  std::fill(_counts, _counts + ValueKindsCount, 0);
+  std::fill(_bytes, _bytes + ValueKindsCount, 0);
+
   _values.clear();
-  _strToValue.clear();
+  // Only touch the occupied slots, so clearing does not depend on how large the table has grown.
+  for (auto index : _strSlots) {
+    _strTable[index] = nullptr;
+  }
+  _strSlots.clear();
+  _strCount = 0;
+  _arrayTable.clear();
   std::fill(_intTable.get(), _intTable.get() + INTEGER_TABLE_SIZE, nullptr);
+  _arena.reset();
+  _stringArena.reset();
+
+  if (!keepSingletons) {
+    ClearSingletons();
+    _singletonArena.reset();
+  }
+
+  ApplyMemoryBudget();
+}
+
+void ObjectPool::ClearSingletons() {
+  _undef = nullptr;
+  _null = nullptr;
+  _funcValues.clear();
+  _bool[0] = _bool[1] = nullptr;
+  _nan = nullptr;
+  _inf = nullptr;
+  _negInf = nullptr;
+  std::fill(_placeholderValues.begin(), _placeholderValues.end(), nullptr);
+  std::fill(_singletonCounts, _singletonCounts + ValueKindsCount, 0);
+  std::fill(_singletonBytes, _singletonBytes + ValueKindsCount, 0);
+}
+
+void ObjectPool::ApplyMemoryBudget() {
+  if (!_budget || GetBytesReserved() <= _budget) {
+    return;
+  }
+
+  ++_budgetResetsCount;
+  _arena.release();
+  _stringArena.release();
+  std::vector<Value *>().swap(_values);
+  std::vector<StringValue *>(STRING_TABLE_INIT_SIZE).swap(_strTable);
+  std::vector<size_t>().swap(_strSlots);
+  _arrayTable.rehash(0);
+
+  if (GetBytesReserved() > _budget) {
+    // The singletons alone exceed the budget.
+    ClearSingletons();
+    _singletonArena.release();
+    std::unordered_map<FunctionIdType, FunctionValue *>().swap(_funcValues);
+    std::vector<PlaceholderValue *>(PLACEHOLDER_TABLE_INIT_SIZE).swap(_placeholderValues);
+  }
+}
+
+size_t ObjectPool::GetBytesReserved() const {
+  return _arena.GetBytesReserved() +
+         _singletonArena.GetBytesReserved() +
+         _stringArena.GetBytesReserved() +
+         _values.capacity() * sizeof(Value *) +
+         _strTable.capacity() * sizeof(StringValue *) +
+         _strSlots.capacity() * sizeof(size_t) +
+         _placeholderValues.capacity() * sizeof(PlaceholderValue *) +
+         INTEGER_TABLE_SIZE * sizeof(IntegerValue *);
+}
+
+ObjectPool::Statistics ObjectPool::GetStatistics() const {
+  Statistics stat;
+  for (size_t k = 0; k < ValueKindsCount; ++k) {
+    stat.ValuesCount[k] = _counts[k] + _singletonCounts[k];
+    stat.ValueBytes[k] = _bytes[k] + _singletonBytes[k];
+  }
+  stat.BytesAllocated = GetBytesAllocated();
+  stat.BytesReserved = GetBytesReserved();
+  stat.HighWaterMark = std::max(_highWaterMark, stat.BytesAllocated);
+  stat.MemoryBudget = _budget;
+  stat.ClearsCount = _clearsCount;
+  stat.BudgetResetsCount = _budgetResetsCount;
+  return stat;
 }
 
 } // namespace caf
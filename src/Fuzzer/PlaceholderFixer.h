@@ -0,0 +1,89 @@
+#ifndef CAF_PLACEHOLDER_FIXER_H
+#define CAF_PLACEHOLDER_FIXER_H
+
+#include "Infrastructure/Casting.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/FunctionCall.h"
+#include "Fuzzer/Value.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace caf {
+
+/**
+ * @brief Rewrite the placeholder values in the function calls of a test case.
+ *
+ * Unfrozen arrays are rewritten in place. Frozen arrays may be shared and are copied on write.
+ *
+ */
+class PlaceholderFixer {
+public:
+  explicit PlaceholderFixer(ObjectPool& pool)
+    : _pool(pool),
+      _fixedValues()
+  { }
+
+  template <typename Fixer>
+  void Fix(TestCase& testCase, size_t startCallIndex, Fixer fixer) {
+    _fixedValues.clear();
+    for (size_t i = startCallIndex; i < testCase.GetFunctionCallsCount(); ++i) {
+      auto& call = testCase.GetFunctionCall(i);
+      if (call.HasThis()) {
+        call.SetThis(FixValue(call.GetThis(), i, fixer));
+      }
+      for (size_t ai = 0; ai < call.GetArgsCount(); ++ai) {
+        call.SetArg(ai, FixValue(call.GetArg(ai), i, fixer));
+      }
+    }
+  }
+
+private:
+  ObjectPool& _pool;
+  std::unordered_map<Value *, Value *> _fixedValues; // Old arrays to fixed arrays.
+
+  template <typename Fixer>
+  Value* FixValue(Value* oldValue, size_t callIndex, Fixer& fixer) {
+    if (oldValue->IsPlaceholder()) {
+      return fixer(callIndex, oldValue->GetPlaceholderIndex());
+    } else if (oldValue->IsArray()) {
+      auto fixed = _fixedValues.find(oldValue);
+      if (fixed != _fixedValues.end()) {
+        return fixed->second;
+      }
+
+      auto oldArrayValue = caf::dyn_cast<ArrayValue>(oldValue);
+      if (!oldArrayValue->frozen()) {
+        _fixedValues.emplace(oldValue, oldValue);
+        for (size_t i = 0; i < oldArrayValue->size(); ++i) {
+          oldArrayValue->SetElement(i, FixValue(oldArrayValue->GetElement(i), callIndex, fixer));
+        }
+        return oldValue;
+      }
+
+      // Frozen arrays may be shared, copy them on write.
+      ArrayValue* newArrayValue = nullptr;
+      for (size_t i = 0; i < oldArrayValue->size(); ++i) {
+        auto oldElement = oldArrayValue->GetElement(i);
+        auto newElement = FixValue(oldElement, callIndex, fixer);
+        if (newElement != oldElement && !newArrayValue) {
+          newArrayValue = _pool.CreateArrayValue(oldArrayValue->size());
+          std::copy(oldArrayValue->begin(), oldArrayValue->end(), newArrayValue->begin());
+        }
+        if (newArrayValue) {
+          newArrayValue->SetElement(i, newElement);
+        }
+      }
+
+      Value* newValue = newArrayValue ? _pool.FreezeArray(newArrayValue) : oldValue;
+      _fixedValues.emplace(oldValue, newValue);
+      return newValue;
+    }
+    return oldValue;
+  }
+}; // class PlaceholderFixer
+
+} // namespace caf
+
+#endif
@@ -0,0 +1,256 @@
+#include "Infrastructure/Casting.h"
+#include "Infrastructure/Intrinsic.h"
+#include "Fuzzer/TestCaseCanonicalizer.h"
+#include "Fuzzer/FunctionCall.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/Value.h"
+#include "PlaceholderFixer.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace caf {
+
+namespace {
+
+/**
+ * @brief Scramble the bits of the given 64-bit value. This is the finalizer of MurmurHash3.
+ *
+ * @param x the value.
+ * @return uint64_t the scrambled value.
+ */
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb3fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/**
+ * @brief Combine a 64-bit hash value with another 64-bit value. The combination is order-dependent.
+ *
+ * @param hash the hash value.
+ * @param value the value to combine.
+ * @return uint64_t the combined hash value.
+ */
+uint64_t Combine(uint64_t hash, uint64_t value) {
+  return Mix(hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2)));
+}
+
+constexpr static const uint64_t CallHashSeed = 0x63616663616c6c00ULL;
+constexpr static const uint64_t TestCaseHashSeed = 0x6361667465737400ULL;
+
+// Memoized hash of arrays whose elements are being hashed. A well-formed test case never contains an
+// array that contains itself, but cyclic arrays must not make the hasher recurse forever.
+constexpr static const uint64_t ArrayInProgress = 0;
+
+} // namespace <anonymous>
+
+TestCaseCanonicalizer::TestCaseCanonicalizer()
+  : _callHashes(),
+    _arrayHashes(),
+    _dependents(),
+    _dependenciesCount(),
+    _dependencies(),
+    _visitedArrays()
+{ }
+
+uint64_t TestCaseCanonicalizer::Hash(const TestCase& testCase) {
+  HashCalls(testCase);
+
+  // Sum up the hashes of all function calls so that the result does not depend on their order.
+  uint64_t callsHash = 0;
+  for (auto callHash : _callHashes) {
+    callsHash += Mix(callHash);
+  }
+
+  auto hash = Combine(TestCaseHashSeed, testCase.storeRootEntryIndex());
+  hash = Combine(hash, testCase.GetFunctionCallsCount());
+  return Combine(hash, callsHash);
+}
+
+void TestCaseCanonicalizer::Canonicalize(TestCase& testCase, ObjectPool& pool) {
+  HashCalls(testCase);
+  CollectDependencies(testCase);
+
+  // Kahn's algorithm. Among all function calls that are ready, the one with the smallest hash is
+  // placed first; ties are broken by the original order.
+  using ReadyCall = std::pair<uint64_t, size_t>;
+  std::priority_queue<ReadyCall, std::vector<ReadyCall>, std::greater<ReadyCall>> ready;
+  for (size_t i = 0; i < testCase.GetFunctionCallsCount(); ++i) {
+    if (_dependenciesCount[i] == 0) {
+      ready.emplace(_callHashes[i], i);
+    }
+  }
+
+  std::vector<size_t> newIndexes(testCase.GetFunctionCallsCount());
+  std::vector<FunctionCall> calls;
+  calls.reserve(testCase.GetFunctionCallsCount());
+  auto reordered = false;
+  while (!ready.empty()) {
+    auto index = ready.top().second;
+    ready.pop();
+
+    reordered |= (index != calls.size());
+    newIndexes[index] = calls.size();
+    calls.push_back(std::move(testCase.GetFunctionCall(index)));
+
+    for (auto dependent : _dependents[index]) {
+      if (--_dependenciesCount[dependent] == 0) {
+        ready.emplace(_callHashes[dependent], dependent);
+      }
+    }
+  }
+  assert(calls.size() == testCase.GetFunctionCallsCount() &&
+         "Placeholder values should only refer to previous function calls.");
+
+  testCase.RemoveTailCalls(0);
+  testCase.AppendFunctionCalls(std::move(calls));
+  if (!reordered) {
+    return;
+  }
+
+  PlaceholderFixer fixer { pool };
+  fixer.Fix(testCase, 0,
+      [&newIndexes, &pool] (size_t, size_t placeholderIndex) -> Value * {
+        return pool.GetPlaceholderValue(newIndexes[placeholderIndex]);
+      });
+}
+
+void TestCaseCanonicalizer::HashCalls(const TestCase& testCase) {
+  _callHashes.clear();
+  _callHashes.reserve(testCase.GetFunctionCallsCount());
+  _arrayHashes.clear();
+  for (size_t i = 0; i < testCase.GetFunctionCallsCount(); ++i) {
+    _callHashes.push_back(HashCall(testCase.GetFunctionCall(i), i));
+  }
+}
+
+uint64_t TestCaseCanonicalizer::HashCall(const FunctionCall& call, size_t callIndex) {
+  auto hash = Combine(CallHashSeed, call.funcId());
+  hash = Combine(hash, static_cast<uint64_t>(call.IsConstructorCall()));
+
+  if (call.HasThis()) {
+    hash = Combine(hash, HashValue(call.GetThis(), callIndex));
+  } else {
+    // A missing `this` value is serialized as undefined.
+    auto undefined = Value::CreateUndefinedValue();
+    hash = Combine(hash, HashValue(&undefined, callIndex));
+  }
+
+  hash = Combine(hash, call.GetArgsCount());
+  for (auto arg : call) {
+    hash = Combine(hash, HashValue(arg, callIndex));
+  }
+
+  return hash;
+}
+
+uint64_t TestCaseCanonicalizer::HashValue(const Value* value, size_t callIndex) {
+  assert(value && "value cannot be null.");
+
+  auto kind = value->kind();
+  auto hash = Mix(static_cast<uint64_t>(kind) + 1);
+  switch (kind) {
+    case ValueKind::Undefined:
+    case ValueKind::Null:
+      return hash;
+    case ValueKind::Function:
+      return Combine(hash, value->GetFunctionId());
+    case ValueKind::Boolean:
+      return Combine(hash, static_cast<uint64_t>(value->GetBooleanValue()));
+    case ValueKind::String: {
+      auto str = value->GetStringValue();
+      return Combine(hash, GetHashCode(str));
+    }
+    case ValueKind::Integer:
+      return Combine(hash, static_cast<uint32_t>(value->GetIntegerValue()));
+    case ValueKind::Float: {
+      auto floatValue = value->GetFloatValue();
+      uint64_t bits;
+      if (std::isnan(floatValue)) {
+        // All NaNs are the same NaN in JavaScript.
+        bits = 0x7ff8000000000000ULL;
+      } else {
+        std::memcpy(&bits, &floatValue, sizeof(bits));
+      }
+      return Combine(hash, bits);
+    }
+    case ValueKind::Array: {
+      auto memoized = _arrayHashes.emplace(value, ArrayInProgress);
+      if (!memoized.second) {
+        // A cyclic reference hashes as the kind of the array only.
+        return memoized.first->second == ArrayInProgress ? hash : memoized.first->second;
+      }
+
+      auto arrayValue = caf::dyn_cast<ArrayValue>(value);
+      hash = Combine(hash, arrayValue->size());
+      for (auto element : *arrayValue) {
+        hash = Combine(hash, HashValue(element, callIndex));
+      }
+      if (hash == ArrayInProgress) {
+        hash = ~ArrayInProgress;
+      }
+      // Recursive calls may have rehashed the map.
+      _arrayHashes[value] = hash;
+      return hash;
+    }
+    case ValueKind::Placeholder: {
+      auto index = value->GetPlaceholderIndex();
+      assert(index < callIndex && "Placeholder values should only refer to previous function calls.");
+      // Identify the referenced function call by its content rather than by its position.
+      return Combine(hash, index < callIndex ? _callHashes[index] : index);
+    }
+    default:
+      CAF_UNREACHABLE;
+  }
+}
+
+void TestCaseCanonicalizer::CollectDependencies(const TestCase& testCase) {
+  auto callsCount = testCase.GetFunctionCallsCount();
+  _dependents.resize(callsCount);
+  for (size_t i = 0; i < callsCount; ++i) {
+    _dependents[i].clear();
+  }
+  _dependenciesCount.assign(callsCount, 0);
+
+  for (size_t i = 0; i < callsCount; ++i) {
+    const auto& call = testCase.GetFunctionCall(i);
+    _dependencies.clear();
+    _visitedArrays.clear();
+    if (call.HasThis()) {
+      CollectDependencies(call.GetThis());
+    }
+    for (auto arg : call) {
+      CollectDependencies(arg);
+    }
+
+    for (auto dependency : _dependencies) {
+      assert(dependency < i && "Placeholder values should only refer to previous function calls.");
+      _dependents[dependency].push_back(i);
+    }
+    _dependenciesCount[i] = _dependencies.size();
+  }
+}
+
+void TestCaseCanonicalizer::CollectDependencies(const Value* value) {
+  if (value->IsPlaceholder()) {
+    _dependencies.insert(value->GetPlaceholderIndex());
+  } else if (value->IsArray()) {
+    if (!_visitedArrays.insert(value).second) {
+      return;
+    }
+    for (auto element : *caf::dyn_cast<ArrayValue>(value)) {
+      CollectDependencies(element);
+    }
+  }
+}
+
+} // namespace caf
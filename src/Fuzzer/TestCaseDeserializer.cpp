@@ -1,34 +1,84 @@
 #include "Infrastructure/Intrinsic.h"
 #include "Infrastructure/Stream.h"
+#include "Infrastructure/StringView.h"
+#include "Infrastructure/Varint.h"
 #include "Basic/Function.h"
+#include "Basic/TestCaseFormat.h"
 #include "Fuzzer/TestCaseDeserializer.h"
 #include "Fuzzer/ObjectPool.h"
 #include "Fuzzer/FunctionCall.h"
 
+#include <cassert>
 #include <utility>
+#include <cstring>
 #include <cstdint>
 #include <string>
 #include <vector>
-#include <unordered_map>
 
 namespace caf {
 
 namespace {
 
-template <size_t Size, typename T>
-T ReadInt(InputStream& in) {
-  uint8_t data[Size];
-  in.Read(data, Size);
-  return static_cast<T>(
-    *reinterpret_cast<typename caf::MakeIntegralType<Size, std::is_signed<T>::value>::Type *>(data)
-  );
-}
+/**
+ * @brief Read fields from an input stream. String values are copied into the object pool.
+ *
+ */
+class StreamReader {
+public:
+  explicit StreamReader(InputStream& in)
+    : _in(in), _string()
+  { }
 
-double ReadFloat(InputStream& in) {
-  double value;
-  in.Read(&value, sizeof(value));
-  return value;
-}
+  uint8_t ReadByte() { return _in.ReadByte(); }
+
+  void Read(void* buffer, size_t size) { _in.Read(buffer, size); }
+
+  template <typename T>
+  T ReadUnaligned() {
+    T value;
+    _in.Read(&value, sizeof(T));
+    return value;
+  }
+
+  StringValue* ReadString(ObjectPool& pool, size_t length) {
+    _string.resize(length);
+    if (length) {
+      _in.Read(&_string[0], length);
+    }
+    return pool.GetOrCreateStringValue(_string);
+  }
+
+private:
+  InputStream& _in;
+  std::string _string; // Buffer of the string being read, reused across strings.
+}; // class StreamReader
+
+/**
+ * @brief Read fields from a memory buffer. String values refer to the characters in the buffer.
+ *
+ */
+class ZeroCopyReader {
+public:
+  explicit ZeroCopyReader(BufferReader& reader)
+    : _reader(reader)
+  { }
+
+  uint8_t ReadByte() { return _reader.ReadByte(); }
+
+  void Read(void* buffer, size_t size) { _reader.Read(buffer, size); }
+
+  template <typename T>
+  T ReadUnaligned() { return _reader.ReadUnaligned<T>(); }
+
+  StringValue* ReadString(ObjectPool& pool, size_t length) {
+    auto data = _reader.ReadBytes(length);
+    return pool.GetOrCreateStringValueView(
+        StringView { reinterpret_cast<const char *>(data), _reader.GetLastReadSize() });
+  }
+
+private:
+  BufferReader& _reader;
+}; // class ZeroCopyReader
 
 } // namespace <anonymous>
 
@@ -42,14 +92,20 @@ public:
   DeserializationContext& operator=(const DeserializationContext &) = default;
   DeserializationContext& operator=(DeserializationContext &&) = default;
 
-  void SetNextValue(Value* value) {
+  size_t SetNextValue(Value* value) {
+    size_t index = _pool.size();
     _pool.push_back(value);
+    _retValueIndex.push_back(NotReturnValue);
+    return index;
+  }
+
+  void SetValue(size_t index, Value* value) {
+    _pool.at(index) = value;
   }
 
   void SetNextValueAsReturnValue(size_t funcIndex) {
-    size_t index = _pool.size();
     _pool.push_back(nullptr);
-    _retValueIndex[index] = funcIndex;
+    _retValueIndex.push_back(funcIndex);
   }
 
   Value* GetValue(size_t index) const {
@@ -57,113 +113,200 @@ public:
   }
 
   size_t GetReturnValueIndex(size_t index) const {
-    return _retValueIndex.at(index);
+    assert(IsReturnValueIndex(index) && "index is not the index of a return value.");
+    return _retValueIndex[index];
   }
 
   bool IsReturnValueIndex(size_t index) const {
-    return _retValueIndex.find(index) != _retValueIndex.end();
+    return index < _retValueIndex.size() && _retValueIndex[index] != NotReturnValue;
   }
 
 private:
+  constexpr static const size_t NotReturnValue = static_cast<size_t>(-1);
+
   std::vector<Value *> _pool;
-  std::unordered_map<size_t, size_t> _retValueIndex;
+  std::vector<size_t> _retValueIndex; // Call indexes of return values, indexed by value index.
 }; // class TestCaseDeserializer::DeserializationContext
 
-TestCase TestCaseDeserializer::Deserialize() {
-  DeserializationContext context { };
-
-  TestCase tc { };
-  auto storeRootEntryIndex = ReadInt<4, size_t>(_in);
-  tc.SetStoreRootEntryIndex(storeRootEntryIndex);
-
-  auto callsCount = ReadInt<4, size_t>(_in);
-  tc.ReserveFunctionCalls(callsCount);
-  for (size_t i = 0; i < callsCount; ++i) {
-    auto call = DeserializeFunctionCall(context);
-    tc.PushFunctionCall(std::move(call));
-    context.SetNextValueAsReturnValue(i);
-  }
+constexpr const size_t TestCaseDeserializer::DeserializationContext::NotReturnValue;
 
-  return tc;
-}
+/**
+ * @brief Decode test cases from a reader.
+ *
+ * @tparam Reader type of the reader.
+ */
+template <typename Reader>
+class TestCaseDeserializer::Decoder {
+public:
+  explicit Decoder(ObjectPool& pool, Reader& reader)
+    : _pool(pool),
+      _reader(reader),
+      _version(LatestTestCaseFormatVersion),
+      _context()
+  { }
+
+  Decoder(const Decoder &) = delete;
+  Decoder(Decoder &&) noexcept = default;
 
-FunctionCall TestCaseDeserializer::DeserializeFunctionCall(DeserializationContext& context) {
-  auto funcId = ReadInt<4, FunctionIdType>(_in);
+  /**
+   * @brief Decode a test case.
+   *
+   * @return TestCase the decoded test case.
+   */
+  TestCase Decode() {
+    TestCase tc { };
 
-  FunctionCall call { funcId };
-  auto thisValue = DeserializeValue(context);
-  call.SetThis(thisValue);
+    uint8_t header[TestCaseHeaderSize];
+    _reader.Read(header, sizeof(header));
+    _version = DetectTestCaseFormat(header);
 
-  auto isCtor = ReadInt<1, uint8_t>(_in);
-  call.SetConstructorCall(isCtor);
+    uint64_t storeRootEntryIndex;
+    if (_version == TestCaseFormatVersion::V1) {
+      // The header is the root entry index in the v1 format.
+      uint32_t index;
+      std::memcpy(&index, header, sizeof(index));
+      storeRootEntryIndex = index;
+    } else {
+      storeRootEntryIndex = ReadUInt();
+    }
+    tc.SetStoreRootEntryIndex(static_cast<size_t>(storeRootEntryIndex));
 
-  auto argsCount = ReadInt<4, size_t>(_in);
-  call.ReserveArgs(argsCount);
+    auto callsCount = static_cast<size_t>(ReadUInt());
+    tc.ReserveFunctionCalls(callsCount);
+    for (size_t i = 0; i < callsCount; ++i) {
+      auto call = DecodeFunctionCall();
+      tc.PushFunctionCall(std::move(call));
+      _context.SetNextValueAsReturnValue(i);
+    }
 
-  for (size_t i = 0; i < argsCount; ++i) {
-    auto arg = DeserializeValue(context);
-    call.PushArg(arg);
+    return tc;
   }
 
-  return call;
-}
+private:
+  ObjectPool& _pool;
+  Reader& _reader;
+  TestCaseFormatVersion _version; // Format version of the test case being decoded.
+  DeserializationContext _context;
 
-Value* TestCaseDeserializer::DeserializeValue(DeserializationContext& context) {
-  auto kind = static_cast<ValueKind>(ReadInt<1, uint8_t>(_in));
-  switch (kind) {
-    case ValueKind::Undefined:
-      return _pool.GetUndefinedValue();
-    case ValueKind::Null:
-      return _pool.GetNullValue();
-    case ValueKind::Function: {
-      auto funcId = ReadInt<4, FunctionIdType>(_in);
-      return _pool.GetFunctionValue(funcId);
-    }
-    case ValueKind::Boolean: {
-      auto value = static_cast<bool>(ReadInt<1, uint8_t>(_in));
-      return _pool.GetBooleanValue(value);
+  FunctionCall DecodeFunctionCall() {
+    auto funcId = static_cast<FunctionIdType>(ReadUInt());
+
+    FunctionCall call { funcId };
+    auto thisValue = DecodeValue();
+    call.SetThis(thisValue);
+
+    auto isCtor = _reader.ReadByte();
+    call.SetConstructorCall(isCtor);
+
+    auto argsCount = static_cast<size_t>(ReadUInt());
+    call.ReserveArgs(argsCount);
+
+    for (size_t i = 0; i < argsCount; ++i) {
+      auto arg = DecodeValue();
+      call.PushArg(arg);
     }
-    case ValueKind::String: {
-      auto len = ReadInt<4, size_t>(_in);
-      std::string s;
-      s.reserve(len);
-      for (size_t i = 0; i < len; ++i) {
-        s.push_back(static_cast<char>(_in.ReadByte()));
+
+    return call;
+  }
+
+  Value* DecodeValue() {
+    auto tag = _reader.ReadByte();
+    if (_version != TestCaseFormatVersion::V1) {
+      if (GetValueTagKind(tag) == static_cast<uint8_t>(ValueKind::Boolean)) {
+        return _pool.GetBooleanValue(GetValueTagPayload(tag) != 0);
       }
-      return _pool.GetOrCreateStringValue(std::move(s));
-    }
-    case ValueKind::Integer: {
-      auto value = ReadInt<4, int32_t>(_in);
-      return _pool.GetOrCreateIntegerValue(value);
+      tag = GetValueTagKind(tag);
     }
-    case ValueKind::Float: {
-      auto value = ReadFloat(_in);
-      return _pool.GetOrCreateFloatValue(value);
-    }
-    case ValueKind::Array: {
-      auto arrayValue = _pool.CreateArrayValue();
-      context.SetNextValue(arrayValue);
-      auto size = ReadInt<4, size_t>(_in);
-      arrayValue->reserve(size);
-      for (size_t i = 0; i < size; ++i) {
-        auto element = DeserializeValue(context);
-        arrayValue->Push(element);
+
+    auto kind = static_cast<ValueKind>(tag);
+    switch (kind) {
+      case ValueKind::Undefined:
+        return _pool.GetUndefinedValue();
+      case ValueKind::Null:
+        return _pool.GetNullValue();
+      case ValueKind::Function: {
+        auto funcId = static_cast<FunctionIdType>(ReadUInt());
+        return _pool.GetFunctionValue(funcId);
       }
-      return arrayValue;
-    }
-    case ValueKind::Placeholder: {
-      auto index = ReadInt<4, size_t>(_in);
-      if (context.IsReturnValueIndex(index)) {
-        index = context.GetReturnValueIndex(index);
-        return _pool.GetPlaceholderValue(index);
-      } else {
-        return context.GetValue(index);
+      case ValueKind::Boolean: {
+        auto value = static_cast<bool>(_reader.ReadByte());
+        return _pool.GetBooleanValue(value);
+      }
+      case ValueKind::String: {
+        auto len = static_cast<size_t>(ReadUInt());
+        return _reader.ReadString(_pool, len);
       }
+      case ValueKind::Integer: {
+        int32_t value;
+        if (_version == TestCaseFormatVersion::V1) {
+          value = _reader.template ReadUnaligned<int32_t>();
+        } else {
+          value = static_cast<int32_t>(ZigZagDecode(ReadVarint(_reader)));
+        }
+        return _pool.GetOrCreateIntegerValue(value);
+      }
+      case ValueKind::Float: {
+        auto value = _reader.template ReadUnaligned<double>();
+        return _pool.GetOrCreateFloatValue(value);
+      }
+      case ValueKind::Array: {
+        auto size = static_cast<size_t>(ReadUInt());
+        auto arrayValue = _pool.CreateArrayValue(size);
+        auto index = _context.SetNextValue(arrayValue);
+        for (size_t i = 0; i < size; ++i) {
+          auto element = DecodeValue();
+          arrayValue->SetElement(i, element);
+        }
+        // Later back references should see the shared array if the array is hash-consed.
+        auto frozenArrayValue = _pool.FreezeArray(arrayValue);
+        _context.SetValue(index, frozenArrayValue);
+        return frozenArrayValue;
+      }
+      case ValueKind::Placeholder: {
+        auto index = static_cast<size_t>(ReadUInt());
+        if (_context.IsReturnValueIndex(index)) {
+          index = _context.GetReturnValueIndex(index);
+          return _pool.GetPlaceholderValue(index);
+        } else {
+          return _context.GetValue(index);
+        }
+      }
+      default:
+        CAF_UNREACHABLE;
     }
-    default:
-      CAF_UNREACHABLE;
+    return nullptr; // Make the compiler happy.
   }
-  return nullptr; // Make the compiler happy.
+
+  uint64_t ReadUInt() {
+    if (_version == TestCaseFormatVersion::V1) {
+      return _reader.template ReadUnaligned<uint32_t>();
+    }
+    return ReadVarint(_reader);
+  }
+}; // class TestCaseDeserializer::Decoder
+
+TestCase TestCaseDeserializer::Deserialize() {
+  if (_in) {
+    StreamReader reader { *_in };
+    Decoder<StreamReader> decoder { _pool, reader };
+    return decoder.Decode();
+  }
+
+  ZeroCopyReader reader { _reader };
+  Decoder<ZeroCopyReader> decoder { _pool, reader };
+  return decoder.Decode();
+}
+
+bool TestCaseDeserializer::TryDeserialize(TestCase& testCase) {
+  assert(!_in && "Validation is only available in zero-copy mode.");
+  if (!_validator.Validate(_reader.position(), _reader.remaining())) {
+    _error = _validator.GetError();
+    return false;
+  }
+
+  _error = TestCaseValidationError::None;
+  testCase = Deserialize();
+  return true;
 }
 
 } // namespace caf
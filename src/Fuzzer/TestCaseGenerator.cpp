@@ -1,17 +1,23 @@
 #include "Infrastructure/Memory.h"
 #include "Infrastructure/Intrinsic.h"
 #include "Basic/CAFStore.h"
+#include "Basic/ReturnKindFeedback.h"
 #include "Fuzzer/TestCaseGenerator.h"
 #include "Fuzzer/ObjectPool.h"
 #include "Fuzzer/TestCase.h"
 #include "Fuzzer/FunctionCall.h"
 #include "Fuzzer/Value.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 
 constexpr static const double GENERATE_THIS_PROB = 0.5;
 constexpr static const double GENERATE_CTOR_PROB = 0.2;
+constexpr static const double GENERATE_KNOWN_CTOR_PROB = 0.7;
+constexpr static const double GENERATE_EXACT_ARITY_PROB = 0.6;
+constexpr static const double GENERATE_NEAR_ARITY_PROB = 0.3;
+constexpr static const double GENERATE_FEWER_ARGS_PROB = 0.25;
 constexpr static const double GENERATE_DICT_INT_PROB = 0.6;
 constexpr static const double CHOOSE_EXISTING_PROB = 0.2;
 constexpr static const double GENERATE_DICT_FLOAT_PROB = 0.2;
@@ -55,35 +61,37 @@ TestCase TestCaseGenerator::GenerateTestCase(size_t rootEntryIndex) {
   auto callsCount = _rnd.Next<size_t>(1, _opt.MaxCalls);
   tc.ReserveFunctionCalls(callsCount);
   for (size_t i = 0; i < callsCount; ++i) {
-    tc.PushFunctionCall(GenerateFunctionCall(i, tc.storeRootEntryIndex()));
+    tc.PushFunctionCall(GenerateFunctionCall(i, tc.storeRootEntryIndex(), &tc));
   }
 
   return tc;
 }
 
-FunctionCall TestCaseGenerator::GenerateFunctionCall(size_t index, size_t rootEntryIndex) {
-  auto entry = _store.GetEntry(rootEntryIndex);
-  auto calleeId = entry->SelectDescendent(_rnd)->GetFunction().id();
-  FunctionCall call { calleeId };
+FunctionCall TestCaseGenerator::GenerateFunctionCall(
+    size_t index, size_t rootEntryIndex, const TestCase* testCase) {
+  const auto& callee = SelectFunction(rootEntryIndex);
+  FunctionCall call { callee.id() };
 
   GeneratePlaceholderValueParams params;
   if (index != 0) {
     params.SetCurrentCallIndex(index);
+    params.SetTestCase(testCase);
   }
 
   // Decide whether to generate the `this` object.
   if (_rnd.WithProbability(GENERATE_THIS_PROB)) {
     // Generate `this` object.
-    call.SetThis(GenerateValue(rootEntryIndex, params));
+    call.SetThis(GenerateThisValue(rootEntryIndex, params));
   }
 
   // Decide whether to generate a constructor call.
-  if (_rnd.WithProbability(GENERATE_CTOR_PROB)) {
+  auto ctorProb = callee.IsConstructor() ? GENERATE_KNOWN_CTOR_PROB : GENERATE_CTOR_PROB;
+  if (_rnd.WithProbability(ctorProb)) {
     call.SetConstructorCall(true);
   }
 
   // Decide how many arguments should be generated.
-  auto argsCount = GenerateArgumentsCount();
+  auto argsCount = GenerateArgumentsCount(callee);
   call.ReserveArgs(argsCount);
   for (size_t i = 0; i < argsCount; ++i) {
     call.PushArg(GenerateValue(rootEntryIndex, params));
@@ -92,18 +100,80 @@ FunctionCall TestCaseGenerator::GenerateFunctionCall(size_t index, size_t rootEn
   return call;
 }
 
+Value* TestCaseGenerator::GenerateThisValue(
+    size_t rootEntryIndex, GeneratePlaceholderValueParams params) {
+  auto testCase = params.GetTestCase();
+  if (_feedback && testCase && params.ShouldGenerate()) {
+    // Reference to a previous call's return value with the probability that the most promising
+    // previous call produces an object.
+    double objectRate = 0;
+    for (size_t i = 0; i < params.GetCurrentCallIndex(); ++i) {
+      auto funcId = testCase->GetFunctionCall(i).funcId();
+      objectRate = std::max(objectRate, _feedback->GetObjectRate(funcId));
+    }
+    if (_rnd.WithProbability(objectRate)) {
+      return _pool.GetPlaceholderValue(GeneratePlaceholderIndex(params));
+    }
+  }
+
+  return GenerateValue(rootEntryIndex, params);
+}
+
 FunctionValue* TestCaseGenerator::GenerateFunctionValue(size_t rootEntryIndex) {
-  auto entry = _store.GetEntry(rootEntryIndex);
-  auto funcId = entry->SelectDescendent(_rnd)->GetFunction().id();
-  return _pool.GetFunctionValue(funcId);
+  return _pool.GetFunctionValue(SelectFunction(rootEntryIndex).id());
 }
 
 char TestCaseGenerator::GenerateStringCharacter() {
   return _rnd.Select(CharacterSet);
 }
 
-size_t TestCaseGenerator::GenerateArgumentsCount() {
-  return _rnd.Next(0, 5);
+const Function& TestCaseGenerator::SelectFunction(size_t rootEntryIndex) {
+  auto entry = _store.GetEntry(rootEntryIndex);
+  return entry->SelectDescendent(_rnd)->GetFunction();
+}
+
+size_t TestCaseGenerator::GenerateArgumentsCount(const Function& callee) {
+  if (!callee.HasArity()) {
+    return _rnd.Next<size_t>(0, _opt.MaxArguments);
+  }
+
+  // Calls with too few arguments mostly bail out early in the callee, so concentrate the generated
+  // number around the arity of the callee. The arity is allowed to exceed `MaxArguments`.
+  auto arity = callee.arity();
+  auto max = std::max(arity, _opt.MaxArguments);
+  if (_rnd.WithProbability(GENERATE_EXACT_ARITY_PROB)) {
+    return arity;
+  }
+  if (_rnd.WithProbability(GENERATE_NEAR_ARITY_PROB / (1 - GENERATE_EXACT_ARITY_PROB))) {
+    // Optional parameters are not counted in the arity, so prefer generating more arguments.
+    if (arity > 0 && _rnd.WithProbability(GENERATE_FEWER_ARGS_PROB)) {
+      return arity - 1;
+    }
+    return std::min(arity + 1, max);
+  }
+  return _rnd.Next<size_t>(0, max);
+}
+
+size_t TestCaseGenerator::GeneratePlaceholderIndex(const GeneratePlaceholderValueParams& params) {
+  auto callsCount = params.GetCurrentCallIndex();
+  auto testCase = params.GetTestCase();
+  if (!_feedback || !testCase) {
+    return _rnd.Next<size_t>(0, callsCount - 1);
+  }
+
+  double totalRate = 0;
+  for (size_t i = 0; i < callsCount; ++i) {
+    totalRate += _feedback->GetObjectRate(testCase->GetFunctionCall(i).funcId());
+  }
+
+  auto target = _rnd.Next<double>() * totalRate;
+  for (size_t i = 0; i < callsCount - 1; ++i) {
+    target -= _feedback->GetObjectRate(testCase->GetFunctionCall(i).funcId());
+    if (target < 0) {
+      return i;
+    }
+  }
+  return callsCount - 1;
 }
 
 ValueKind TestCaseGenerator::GenerateValueKind(
@@ -142,11 +212,8 @@ Value* TestCaseGenerator::GenerateValue(
       return pool.GetUndefinedValue();
     case ValueKind::Null:
       return pool.GetNullValue();
-    case ValueKind::Function: {
-      auto entry = _store.GetEntry(rootEntryIndex);
-      auto funcId = entry->SelectDescendent(_rnd)->GetFunction().id();
-      return pool.GetFunctionValue(funcId);
-    }
+    case ValueKind::Function:
+      return GenerateFunctionValue(rootEntryIndex);
     case ValueKind::Boolean: {
       auto value = static_cast<bool>(_rnd.Next<int>(0, 1));
       return pool.GetBooleanValue(value);
@@ -175,16 +242,14 @@ Value* TestCaseGenerator::GenerateValue(
     case ValueKind::Array: {
       // Decide how many elements should be included in this array.
       auto size = _rnd.Next<size_t>(0, _opt.MaxArrayLength);
-      auto value = pool.CreateArrayValue();
-      value->reserve(size);
+      auto value = pool.CreateArrayValue(size);
       for (size_t i = 0; i < size; ++i) {
-        value->Push(GenerateValue(rootEntryIndex, params, depth + 1));
+        value->SetElement(i, GenerateValue(rootEntryIndex, params, depth + 1));
       }
-      return value;
+      return pool.FreezeArray(value);
     }
     case ValueKind::Placeholder: {
-      auto index = _rnd.Next<size_t>(0, params.GetCurrentCallIndex() - 1);
-      return pool.GetPlaceholderValue(index);
+      return pool.GetPlaceholderValue(GeneratePlaceholderIndex(params));
     }
     default: CAF_UNREACHABLE;
   }
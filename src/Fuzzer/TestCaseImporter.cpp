@@ -0,0 +1,704 @@
+#include "Basic/CAFStore.h"
+#include "Fuzzer/FunctionCall.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseImporter.h"
+#include "Fuzzer/Value.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace caf {
+
+namespace {
+
+constexpr static const FunctionIdType AmbiguousFunctionId =
+    std::numeric_limits<FunctionIdType>::max();
+
+constexpr static const char PrototypeSeparator[] = ".prototype.";
+
+enum class TokenKind {
+  Identifier,
+  Number,
+  String,
+  Punctuator,
+  Invalid,
+};
+
+struct Token {
+  explicit Token(TokenKind kind, std::string text, bool newlineBefore)
+    : Kind(kind), Text(std::move(text)), Number(0), IsInteger(false), NewlineBefore(newlineBefore)
+  { }
+
+  TokenKind Kind;
+  std::string Text; // Name of identifiers, value of strings or the punctuator itself.
+  double Number;
+  bool IsInteger;
+  bool NewlineBefore; // Is there a line terminator between this token and the previous one?
+
+  bool Is(TokenKind kind, const char* text) const {
+    return Kind == kind && Text == text;
+  }
+
+  bool IsPunctuator(const char* text) const { return Is(TokenKind::Punctuator, text); }
+
+  bool IsIdentifier(const char* text) const { return Is(TokenKind::Identifier, text); }
+}; // struct Token
+
+/**
+ * @brief Split JavaScript code into tokens. Only tokens used by the supported subset are
+ * recognized precisely; all other characters become single-character punctuators or invalid
+ * tokens, which make the containing statements unsupported.
+ *
+ */
+class Lexer {
+public:
+  explicit Lexer(const std::string& code)
+    : _code(code), _pos(0), _newline(false)
+  { }
+
+  std::vector<Token> Lex() {
+    std::vector<Token> tokens;
+    while (SkipSpacesAndComments()) {
+      tokens.push_back(LexToken());
+      _newline = false;
+    }
+    return tokens;
+  }
+
+private:
+  const std::string& _code;
+  size_t _pos;
+  bool _newline;
+
+  bool SkipSpacesAndComments() {
+    while (_pos < _code.length()) {
+      auto ch = _code[_pos];
+      if (ch == '\n') {
+        _newline = true;
+        ++_pos;
+      } else if (std::isspace(static_cast<unsigned char>(ch))) {
+        ++_pos;
+      } else if (_code.compare(_pos, 2, "//") == 0) {
+        auto end = _code.find('\n', _pos);
+        _pos = (end == std::string::npos) ? _code.length() : end;
+      } else if (_code.compare(_pos, 2, "/*") == 0) {
+        auto end = _code.find("*/", _pos + 2);
+        end = (end == std::string::npos) ? _code.length() : end + 2;
+        if (_code.find('\n', _pos) < end) {
+          _newline = true;
+        }
+        _pos = end;
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool IsIdentifierStart(char ch) {
+    return std::isalpha(static_cast<unsigned char>(ch)) || ch == '_' || ch == '$';
+  }
+
+  static bool IsIdentifierPart(char ch) {
+    return IsIdentifierStart(ch) || std::isdigit(static_cast<unsigned char>(ch));
+  }
+
+  Token LexToken() {
+    auto ch = _code[_pos];
+    if (IsIdentifierStart(ch)) {
+      auto start = _pos;
+      while (_pos < _code.length() && IsIdentifierPart(_code[_pos])) {
+        ++_pos;
+      }
+      return Token { TokenKind::Identifier, _code.substr(start, _pos - start), _newline };
+    }
+
+    if (std::isdigit(static_cast<unsigned char>(ch)) ||
+        (ch == '.' && _pos + 1 < _code.length() &&
+         std::isdigit(static_cast<unsigned char>(_code[_pos + 1])))) {
+      return LexNumber();
+    }
+
+    if (ch == '\'' || ch == '"' || ch == '`') {
+      return LexString();
+    }
+
+    ++_pos;
+    return Token { TokenKind::Punctuator, std::string(1, ch), _newline };
+  }
+
+  Token LexNumber() {
+    auto start = _pos;
+    Token token { TokenKind::Number, "", _newline };
+    auto begin = _code.c_str() + _pos;
+    char* end;
+    if (_code.compare(_pos, 2, "0x") == 0 || _code.compare(_pos, 2, "0X") == 0) {
+      token.Number = static_cast<double>(std::strtoull(begin + 2, &end, 16));
+      token.IsInteger = true;
+    } else {
+      token.Number = std::strtod(begin, &end);
+      const char* literalEnd = end;
+      token.IsInteger = std::find_if(begin, literalEnd,
+          [] (char ch) { return ch == '.' || ch == 'e' || ch == 'E'; }) == literalEnd;
+    }
+    _pos += static_cast<size_t>(end - begin);
+    if (_pos == start || (_pos < _code.length() && IsIdentifierPart(_code[_pos]))) {
+      // Malformed numbers, BigInt literals and numeric separators are not supported.
+      while (_pos < _code.length() && IsIdentifierPart(_code[_pos])) {
+        ++_pos;
+      }
+      token.Kind = TokenKind::Invalid;
+    }
+    return token;
+  }
+
+  Token LexString() {
+    auto quote = _code[_pos++];
+    Token token { TokenKind::String, "", _newline };
+    while (_pos < _code.length() && _code[_pos] != quote) {
+      auto ch = _code[_pos++];
+      if (quote == '`' && ch == '$' && _pos < _code.length() && _code[_pos] == '{') {
+        // Template literals with substitutions are not supported.
+        token.Kind = TokenKind::Invalid;
+      }
+      if (ch != '\\') {
+        token.Text.push_back(ch);
+        continue;
+      }
+      if (_pos >= _code.length()) {
+        break;
+      }
+
+      ch = _code[_pos++];
+      switch (ch) {
+        case 'n': token.Text.push_back('\n'); break;
+        case 'r': token.Text.push_back('\r'); break;
+        case 't': token.Text.push_back('\t'); break;
+        case 'b': token.Text.push_back('\b'); break;
+        case 'f': token.Text.push_back('\f'); break;
+        case 'v': token.Text.push_back('\v'); break;
+        case '0': token.Text.push_back('\0'); break;
+        case '\n': break; // Line continuation.
+        case 'x':
+          AppendCodePoint(token, ReadHex(2));
+          break;
+        case 'u':
+          if (_pos < _code.length() && _code[_pos] == '{') {
+            auto end = _code.find('}', _pos);
+            if (end == std::string::npos) {
+              token.Kind = TokenKind::Invalid;
+              break;
+            }
+            ++_pos;
+            AppendCodePoint(token, ReadHex(end - _pos));
+            ++_pos;
+          } else {
+            AppendCodePoint(token, ReadHex(4));
+          }
+          break;
+        default:
+          token.Text.push_back(ch);
+          break;
+      }
+    }
+
+    if (_pos >= _code.length()) {
+      // Unterminated string literal.
+      token.Kind = TokenKind::Invalid;
+    } else {
+      ++_pos;
+    }
+    return token;
+  }
+
+  uint32_t ReadHex(size_t digits) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < digits && _pos < _code.length(); ++i) {
+      auto ch = _code[_pos];
+      if (!std::isxdigit(static_cast<unsigned char>(ch))) {
+        break;
+      }
+      value = value * 16 + static_cast<uint32_t>(
+          std::isdigit(static_cast<unsigned char>(ch)) ? ch - '0' : std::tolower(ch) - 'a' + 10);
+      ++_pos;
+    }
+    return value;
+  }
+
+  static void AppendCodePoint(Token& token, uint32_t cp) {
+    auto& s = token.Text;
+    if (cp < 0x80) {
+      s.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+      s.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+      s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      s.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+      s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+      s.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+      s.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+      s.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+      s.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+  }
+}; // class Lexer
+
+/**
+ * @brief What a variable in the imported code is bound to.
+ *
+ */
+struct Binding {
+  explicit Binding()
+    : IsCall(false), CallIndex(0), Name()
+  { }
+
+  bool IsCall; // Is the variable bound to the result of a function call?
+  size_t CallIndex; // Index of the function call, if `IsCall` is true.
+  std::string Name; // Name of the callee if `IsCall` is true, otherwise the aliased dotted name.
+}; // struct Binding
+
+using TokenIterator = std::vector<Token>::const_iterator;
+
+/**
+ * @brief Parse a single statement and append the function call it makes to the test case.
+ *
+ */
+class StatementParser {
+public:
+  explicit StatementParser(
+      const std::unordered_map<std::string, FunctionIdType>& funcIds,
+      const std::unordered_map<std::string, FunctionIdType>& methodIds,
+      std::unordered_map<std::string, Binding>& bindings,
+      ObjectPool& pool,
+      TestCase& testCase,
+      TokenIterator begin,
+      TokenIterator end)
+    : _funcIds(funcIds),
+      _methodIds(methodIds),
+      _bindings(bindings),
+      _pool(pool),
+      _testCase(testCase),
+      _curr(begin),
+      _end(end)
+  { }
+
+  /**
+   * @brief Parse the statement.
+   *
+   * @return true if the statement has been imported.
+   * @return false if the statement is not supported.
+   */
+  bool Parse() {
+    std::string declName;
+    if (Peek() && (Peek()->IsIdentifier("const") || Peek()->IsIdentifier("let") ||
+                   Peek()->IsIdentifier("var"))) {
+      ++_curr;
+      if (!Peek() || Peek()->Kind != TokenKind::Identifier) {
+        return false;
+      }
+      declName = (_curr++)->Text;
+      if (!Accept("=")) {
+        return false;
+      }
+    } else if (Peek() && Peek()->Kind == TokenKind::Identifier &&
+               _curr + 1 != _end && (_curr + 1)->IsPunctuator("=")) {
+      declName = _curr->Text;
+      _curr += 2;
+    }
+
+    // `x = require('module')`.
+    if (!declName.empty() && Peek() && Peek()->IsIdentifier("require")) {
+      ++_curr;
+      if (!Accept("(") || !Peek() || Peek()->Kind != TokenKind::String) {
+        return false;
+      }
+      auto moduleName = (_curr++)->Text;
+      if (!Accept(")") || Peek()) {
+        return false;
+      }
+      if (moduleName.compare(0, 5, "node:") == 0) {
+        moduleName.erase(0, 5);
+      }
+      Binding binding;
+      binding.Name = std::move(moduleName);
+      _bindings[declName] = std::move(binding);
+      return true;
+    }
+
+    auto isNew = Peek() && Peek()->IsIdentifier("new");
+    if (isNew) {
+      ++_curr;
+    }
+
+    std::vector<std::string> path;
+    if (!ParseDottedName(path)) {
+      return false;
+    }
+
+    if (!Peek() && !isNew && !declName.empty()) {
+      // `x = dotted.name`.
+      Binding binding;
+      binding.Name = ExpandAlias(path);
+      _bindings[declName] = std::move(binding);
+      return true;
+    }
+
+    if (!Accept("(")) {
+      return false;
+    }
+
+    std::vector<Value *> args;
+    if (!Accept(")")) {
+      do {
+        if (Peek() && Peek()->IsPunctuator(")")) {
+          break; // Trailing comma.
+        }
+        auto arg = ParseValue();
+        if (!arg) {
+          return false;
+        }
+        args.push_back(arg);
+      } while (Accept(","));
+      if (!Accept(")")) {
+        return false;
+      }
+    }
+    if (Peek()) {
+      return false;
+    }
+
+    Value* thisValue = nullptr;
+    FunctionIdType calleeId;
+    std::string calleeName;
+    if (!ResolveCallee(path, calleeId, calleeName, thisValue)) {
+      return false;
+    }
+
+    FunctionCall call { calleeId };
+    call.SetConstructorCall(isNew);
+    if (thisValue) {
+      call.SetThis(thisValue);
+    }
+    call.ReserveArgs(args.size());
+    for (auto arg : args) {
+      call.PushArg(arg);
+    }
+
+    if (!declName.empty()) {
+      Binding binding;
+      binding.IsCall = true;
+      binding.CallIndex = _testCase.GetFunctionCallsCount();
+      binding.Name = std::move(calleeName);
+      _bindings[declName] = std::move(binding);
+    }
+    _testCase.PushFunctionCall(std::move(call));
+    return true;
+  }
+
+private:
+  const std::unordered_map<std::string, FunctionIdType>& _funcIds;
+  const std::unordered_map<std::string, FunctionIdType>& _methodIds;
+  std::unordered_map<std::string, Binding>& _bindings;
+  ObjectPool& _pool;
+  TestCase& _testCase;
+  TokenIterator _curr;
+  TokenIterator _end;
+
+  const Token* Peek() const {
+    return _curr == _end ? nullptr : &*_curr;
+  }
+
+  bool Accept(const char* punctuator) {
+    if (Peek() && Peek()->IsPunctuator(punctuator)) {
+      ++_curr;
+      return true;
+    }
+    return false;
+  }
+
+  bool ParseDottedName(std::vector<std::string>& path) {
+    do {
+      if (!Peek() || Peek()->Kind != TokenKind::Identifier) {
+        return false;
+      }
+      path.push_back((_curr++)->Text);
+    } while (Accept("."));
+    return true;
+  }
+
+  std::string ExpandAlias(const std::vector<std::string>& path) const {
+    std::string name;
+    auto i = _bindings.find(path.front());
+    if (i != _bindings.end() && !i->second.IsCall) {
+      name = i->second.Name;
+    } else {
+      name = path.front();
+    }
+    for (size_t pi = 1; pi < path.size(); ++pi) {
+      name.push_back('.');
+      name.append(path[pi]);
+    }
+    return name;
+  }
+
+  bool LookupFunction(const std::string& name, FunctionIdType& funcId) const {
+    auto i = _funcIds.find(name);
+    if (i == _funcIds.end()) {
+      return false;
+    }
+    funcId = i->second;
+    return true;
+  }
+
+  bool ResolveCallee(
+      const std::vector<std::string>& path,
+      FunctionIdType& calleeId,
+      std::string& calleeName,
+      Value*& thisValue) const {
+    auto i = _bindings.find(path.front());
+    if (i == _bindings.end() || !i->second.IsCall) {
+      calleeName = ExpandAlias(path);
+      return LookupFunction(calleeName, calleeId);
+    }
+
+    // Method call on the result of a previous call.
+    if (path.size() != 2) {
+      return false;
+    }
+    const auto& method = path.back();
+    thisValue = _pool.GetPlaceholderValue(i->second.CallIndex);
+
+    calleeName = i->second.Name;
+    calleeName.append(PrototypeSeparator);
+    calleeName.append(method);
+    if (LookupFunction(calleeName, calleeId)) {
+      return true;
+    }
+
+    auto mi = _methodIds.find(method);
+    if (mi == _methodIds.end() || mi->second == AmbiguousFunctionId) {
+      return false;
+    }
+    calleeId = mi->second;
+    calleeName = method;
+    return true;
+  }
+
+  Value* ParseValue() {
+    auto token = Peek();
+    if (!token) {
+      return nullptr;
+    }
+
+    switch (token->Kind) {
+      case TokenKind::Number:
+        ++_curr;
+        return CreateNumberValue(token->Number, token->IsInteger);
+      case TokenKind::String:
+        ++_curr;
+        return _pool.GetOrCreateStringValue(token->Text);
+      case TokenKind::Punctuator:
+        if (token->IsPunctuator("-") || token->IsPunctuator("+")) {
+          ++_curr;
+          auto negate = token->IsPunctuator("-");
+          auto operand = Peek();
+          if (!operand || operand->Kind != TokenKind::Number) {
+            return nullptr;
+          }
+          ++_curr;
+          return CreateNumberValue(negate ? -operand->Number : operand->Number, operand->IsInteger);
+        }
+        if (token->IsPunctuator("[")) {
+          ++_curr;
+          return ParseArrayValue();
+        }
+        return nullptr;
+      case TokenKind::Identifier:
+        return ParseIdentifierValue();
+      default:
+        return nullptr;
+    }
+  }
+
+  Value* CreateNumberValue(double value, bool isInteger) {
+    if (isInteger &&
+        value >= std::numeric_limits<int32_t>::min() &&
+        value <= std::numeric_limits<int32_t>::max() &&
+        !(value == 0 && std::signbit(value))) {
+      return _pool.GetOrCreateIntegerValue(static_cast<int32_t>(value));
+    }
+    return _pool.GetOrCreateFloatValue(value);
+  }
+
+  Value* ParseArrayValue() {
+    std::vector<Value *> elements;
+    while (!Accept("]")) {
+      auto element = ParseValue();
+      if (!element) {
+        return nullptr;
+      }
+      elements.push_back(element);
+      if (!Accept(",") && !(Peek() && Peek()->IsPunctuator("]"))) {
+        return nullptr;
+      }
+    }
+
+    auto array = _pool.CreateArrayValue(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+      array->SetElement(i, elements[i]);
+    }
+    return _pool.FreezeArray(array);
+  }
+
+  Value* ParseIdentifierValue() {
+    const auto& name = Peek()->Text;
+    if (name == "true" || name == "false") {
+      ++_curr;
+      return _pool.GetBooleanValue(name == "true");
+    }
+    if (name == "null") {
+      ++_curr;
+      return _pool.GetNullValue();
+    }
+    if (name == "undefined") {
+      ++_curr;
+      return _pool.GetUndefinedValue();
+    }
+    if (name == "NaN") {
+      ++_curr;
+      return _pool.GetOrCreateFloatValue(std::numeric_limits<double>::quiet_NaN());
+    }
+    if (name == "Infinity") {
+      ++_curr;
+      return _pool.GetOrCreateFloatValue(std::numeric_limits<double>::infinity());
+    }
+
+    std::vector<std::string> path;
+    if (!ParseDottedName(path)) {
+      return nullptr;
+    }
+
+    auto i = _bindings.find(path.front());
+    if (i != _bindings.end() && i->second.IsCall) {
+      if (path.size() != 1) {
+        return nullptr;
+      }
+      return _pool.GetPlaceholderValue(i->second.CallIndex);
+    }
+
+    FunctionIdType funcId;
+    if (!LookupFunction(ExpandAlias(path), funcId)) {
+      return nullptr;
+    }
+    return _pool.GetFunctionValue(funcId);
+  }
+}; // class StatementParser
+
+/**
+ * @brief Determine whether the given token ends the statement that the previous token belongs to.
+ *
+ * @param prev the previous token.
+ * @param token the token.
+ */
+bool EndsStatement(const Token& prev, const Token& token) {
+  if (!token.NewlineBefore) {
+    return false;
+  }
+  if (token.IsPunctuator(".") || token.IsPunctuator("(")) {
+    return false;
+  }
+  return !(prev.IsPunctuator("=") || prev.IsPunctuator(",") || prev.IsPunctuator(".") ||
+           prev.IsIdentifier("new"));
+}
+
+} // namespace <anonymous>
+
+TestCaseImporter::TestCaseImporter(const CAFStore& store, ObjectPool& pool)
+  : _store(store),
+    _pool(pool),
+    _funcIds(),
+    _methodIds(),
+    _imported(0),
+    _skipped(0)
+{
+  constexpr const size_t SeparatorLength = sizeof(PrototypeSeparator) - 1;
+  for (const auto& func : _store) {
+    const auto& name = func.name();
+    _funcIds.emplace(name, func.id());
+
+    auto pos = name.rfind(PrototypeSeparator);
+    if (pos == std::string::npos ||
+        name.find('.', pos + SeparatorLength) != std::string::npos) {
+      continue;
+    }
+    auto method = name.substr(pos + SeparatorLength);
+    auto inserted = _methodIds.emplace(std::move(method), func.id());
+    if (!inserted.second) {
+      inserted.first->second = AmbiguousFunctionId;
+    }
+  }
+}
+
+TestCase TestCaseImporter::Import(const std::string& code) {
+  auto tokens = Lexer { code }.Lex();
+
+  TestCase tc { };
+  std::unordered_map<std::string, Binding> bindings;
+
+  auto begin = tokens.cbegin();
+  while (begin != tokens.cend()) {
+    // Find the end of the current statement.
+    auto end = begin;
+    int depth = 0;
+    for (; end != tokens.cend(); ++end) {
+      if (end != begin && depth == 0 && EndsStatement(*(end - 1), *end)) {
+        break;
+      }
+      if (end->Kind == TokenKind::Punctuator) {
+        const auto& p = end->Text;
+        if (p == "(" || p == "[" || p == "{") {
+          ++depth;
+        } else if ((p == ")" || p == "]" || p == "}") && depth > 0) {
+          --depth;
+        } else if (p == ";" && depth == 0) {
+          break;
+        }
+      }
+    }
+
+    auto stmtEnd = end;
+    if (end != tokens.cend() && end->IsPunctuator(";")) {
+      ++end;
+    }
+
+    // Ignore empty statements and directives such as `'use strict'`.
+    auto length = stmtEnd - begin;
+    auto isDirective = length == 1 && begin->Kind == TokenKind::String;
+    if (length > 0 && !isDirective) {
+      StatementParser parser { _funcIds, _methodIds, bindings, _pool, tc, begin, stmtEnd };
+      auto callsCount = tc.GetFunctionCallsCount();
+      if (!parser.Parse()) {
+        ++_skipped;
+      } else if (tc.GetFunctionCallsCount() != callsCount) {
+        ++_imported;
+      }
+    }
+
+    begin = end;
+  }
+
+  return tc;
+}
+
+} // namespace caf
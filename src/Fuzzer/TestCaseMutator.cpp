@@ -5,59 +5,15 @@
 #include "Fuzzer/TestCase.h"
 #include "Fuzzer/FunctionCall.h"
 #include "Fuzzer/Value.h"
+#include "PlaceholderFixer.h"
 
 #include <utility>
 #include <iterator>
-#include <unordered_set>
+#include <unordered_map>
 #include <algorithm>
 
 namespace caf {
 
-namespace {
-
-class PlaceholderFixer {
-public:
-  explicit PlaceholderFixer()
-    : _fixedValues()
-  { }
-
-  template <typename Fixer>
-  void Fix(TestCase& testCase, size_t startCallIndex, Fixer fixer) {
-    _fixedValues.clear();
-    for (size_t i = startCallIndex; i < testCase.GetFunctionCallsCount(); ++i) {
-      auto& call = testCase.GetFunctionCall(i);
-      if (call.HasThis()) {
-        call.SetThis(FixValue(call.GetThis(), i, fixer));
-      }
-      for (size_t ai = 0; ai < call.GetArgsCount(); ++ai) {
-        call.SetArg(ai, FixValue(call.GetArg(ai), i, fixer));
-      }
-    }
-  }
-
-private:
-  std::unordered_set<Value *> _fixedValues;
-
-  template <typename Fixer>
-  Value* FixValue(Value* oldValue, size_t callIndex, Fixer& fixer) {
-    if (oldValue->IsPlaceholder()) {
-      return fixer(callIndex, oldValue->GetPlaceholderIndex());
-    } else if (oldValue->IsArray()) {
-      if (_fixedValues.find(oldValue) != _fixedValues.end()) {
-        return oldValue;
-      }
-      _fixedValues.insert(oldValue);
-      auto oldArrayValue = caf::dyn_cast<ArrayValue>(oldValue);
-      for (size_t i = 0; i < oldArrayValue->size(); ++i) {
-        oldArrayValue->SetElement(i, FixValue(oldArrayValue->GetElement(i), callIndex, fixer));
-      }
-    }
-    return oldValue;
-  }
-}; // class PlaceholderFixer
-
-} // namespace <anonymous>
-
 #define SET_LAST_MUTATOR_NAME \
     _lastMutator = __func__
 
@@ -117,19 +73,21 @@ void TestCaseMutator::Mutate(TestCase& testCase) {
 
   assert(head > mutators && "No viable mutator.");
   auto mutator = _rnd.Select(mutators, head);
+  _testCase = &testCase;
   (this->*mutator)(testCase);
+  _testCase = nullptr;
 }
 
 void TestCaseMutator::AddFunctionCall(TestCase& testCase) {
   SET_LAST_MUTATOR_NAME;
 
   auto index = _rnd.Next<size_t>(0, testCase.GetFunctionCallsCount());
-  auto call = _gen.GenerateFunctionCall(index, testCase.storeRootEntryIndex());
+  auto call = _gen.GenerateFunctionCall(index, testCase.storeRootEntryIndex(), &testCase);
   testCase.InsertFunctionCall(index, std::move(call));
 
   // Fix all placeholder values that reference to functions whose index is greater than or equal to
   // the inserted index.
-  PlaceholderFixer fixer;
+  PlaceholderFixer fixer { _pool };
   fixer.Fix(testCase, index + 1,
       [index, this] (size_t, size_t placeholderIndex) -> Value * {
         if (placeholderIndex >= index) {
@@ -147,13 +105,13 @@ void TestCaseMutator::RemoveFunctionCall(TestCase& testCase) {
 
   // Fix all placeholder values that references to functions whose index is greater than or equal to
   // the removed index.
-  PlaceholderFixer fixer;
+  PlaceholderFixer fixer { _pool };
   fixer.Fix(testCase, index,
       [index, &testCase, this] (size_t callIndex, size_t placeholderIndex) -> Value * {
         if (placeholderIndex == index) {
           return _gen.GenerateValue(
               testCase.storeRootEntryIndex(),
-              TestCaseGenerator::GeneratePlaceholderValueParams { callIndex });
+              GetPlaceholderParams(callIndex));
         } else if (placeholderIndex > index) {
           --placeholderIndex;
         }
@@ -169,9 +127,8 @@ void TestCaseMutator::MutateThis(TestCase& testCase) {
     auto thisValue = call.GetThis();
     call.SetThis(Mutate(thisValue, testCase.storeRootEntryIndex(), callIndex, DEPTH_TOP));
   } else {
-    call.SetThis(_gen.GenerateValue(
-        testCase.storeRootEntryIndex(),
-        TestCaseGenerator::GeneratePlaceholderValueParams { callIndex }));
+    call.SetThis(_gen.GenerateThisValue(
+        testCase.storeRootEntryIndex(), GetPlaceholderParams(callIndex)));
   }
 }
 
@@ -201,7 +158,7 @@ void TestCaseMutator::AddArgument(TestCase& testCase) {
   auto& call = testCase.GetFunctionCall(callIndex);
   call.PushArg(_gen.GenerateValue(
     testCase.storeRootEntryIndex(),
-    TestCaseGenerator::GeneratePlaceholderValueParams { callIndex }));
+    GetPlaceholderParams(callIndex)));
 }
 
 void TestCaseMutator::RemoveArgument(TestCase& testCase) {
@@ -244,7 +201,7 @@ void TestCaseMutator::MutateArgument(TestCase& testCase) {
 }
 
 Value* TestCaseMutator::Mutate(Value* value, size_t rootEntryIndex, size_t callIndex, int depth) {
-  TestCaseGenerator::GeneratePlaceholderValueParams params { callIndex };
+  auto params = GetPlaceholderParams(callIndex);
 
   if (depth > options().MaxDepth || _rnd.WithProbability(GENERATE_NEW_VALUE_PROB)) {
     return _gen.GenerateValue(rootEntryIndex, params);
@@ -317,43 +274,49 @@ StringValue* TestCaseMutator::MutateString(StringValue* value) {
   return (this->*mutator)(value);
 }
 
+std::string& TestCaseMutator::LoadStringBuffer(const StringValue* value) {
+  auto s = value->value();
+  _stringBuffer.assign(s.data(), s.length());
+  return _stringBuffer;
+}
+
 StringValue* TestCaseMutator::InsertCharacter(StringValue* value) {
   SET_LAST_MUTATOR_NAME;
 
-  auto s = value->value();
+  auto& s = LoadStringBuffer(value);
   auto pos = _rnd.Next<size_t>(0, s.length());
   auto ch = _gen.GenerateStringCharacter();
   s.insert(pos, 1, ch);
-  return _pool.GetOrCreateStringValue(std::move(s));
+  return _pool.GetOrCreateStringValue(s);
 }
 
 StringValue* TestCaseMutator::RemoveCharacter(StringValue* value) {
   SET_LAST_MUTATOR_NAME;
 
-  auto s = value->value();
+  auto& s = LoadStringBuffer(value);
   auto pos = _rnd.Index(s);
   s.erase(pos, 1);
-  return _pool.GetOrCreateStringValue(std::move(s));
+  return _pool.GetOrCreateStringValue(s);
 }
 
 StringValue* TestCaseMutator::ChangeCharacter(StringValue* value) {
   SET_LAST_MUTATOR_NAME;
 
-  auto s = value->value();
+  auto& s = LoadStringBuffer(value);
   auto pos = _rnd.Index(s);
   auto ch = _gen.GenerateStringCharacter();
   s[pos] = ch;
-  return _pool.GetOrCreateStringValue(std::move(s));
+  return _pool.GetOrCreateStringValue(s);
 }
 
 StringValue* TestCaseMutator::ExchangeCharacters(StringValue* value) {
   SET_LAST_MUTATOR_NAME;
 
-  auto s = value->value();
+  auto& s = LoadStringBuffer(value);
   auto pos1 = _rnd.Next<size_t>(0, s.length() - 2);
   auto pos2 = _rnd.Next<size_t>(pos1 + 1, s.length() - 1);
   std::swap(s[pos1], s[pos2]);
-  return _pool.GetOrCreateStringValue(std::move(s));
+  return _pool.GetOrCreateStringValue(s);
 }
 
 IntegerValue* TestCaseMutator::MutateInteger(IntegerValue* value) {
@@ -458,29 +421,21 @@ ArrayValue* TestCaseMutator::PushElement(ArrayValue* value, size_t rootEntryInde
 
   auto element = _gen.GenerateValue(
       rootEntryIndex,
-      TestCaseGenerator::GeneratePlaceholderValueParams { callIndex });
-  auto newValue = _pool.CreateArrayValue();
-  newValue->reserve(value->size() + 1);
-  for (size_t i = 0; i < value->size(); ++i) {
-    newValue->Push(value->GetElement(i));
-  }
-  newValue->Push(element);
-  return newValue;
+      GetPlaceholderParams(callIndex));
+  auto newValue = _pool.CreateArrayValue(value->size() + 1);
+  std::copy(value->begin(), value->end(), newValue->begin());
+  newValue->SetElement(value->size(), element);
+  return _pool.FreezeArray(newValue);
 }
 
 ArrayValue* TestCaseMutator::RemoveElement(ArrayValue* value, size_t, size_t, int) {
   SET_LAST_MUTATOR_NAME;
 
   auto pos = _rnd.Next<size_t>(0, value->size() - 1);
-  auto newValue = _pool.CreateArrayValue();
-  newValue->reserve(value->size() - 1);
-  for (size_t i = 0; i < pos; ++i) {
-    newValue->Push(value->GetElement(i));
-  }
-  for (size_t i = pos + 1; i < value->size(); ++i) {
-    newValue->Push(value->GetElement(i));
-  }
-  return newValue;
+  auto newValue = _pool.CreateArrayValue(value->size() - 1);
+  auto it = std::copy(value->begin(), value->begin() + pos, newValue->begin());
+  std::copy(value->begin() + pos + 1, value->end(), it);
+  return _pool.FreezeArray(newValue);
 }
 
 ArrayValue* TestCaseMutator::MutateElement(
@@ -489,16 +444,10 @@ ArrayValue* TestCaseMutator::MutateElement(
 
   auto pos = _rnd.Next<size_t>(0, value->size() - 1);
   auto mutatedElement = Mutate(value->GetElement(pos), rootEntryIndex, callIndex, depth + 1);
-  auto newValue = _pool.CreateArrayValue();
-  newValue->reserve(value->size());
-  for (size_t i = 0; i < pos; ++i) {
-    newValue->Push(value->GetElement(i));
-  }
-  newValue->Push(mutatedElement);
-  for (size_t i = pos + 1; i < value->size(); ++i) {
-    newValue->Push(value->GetElement(i));
-  }
-  return newValue;
+  auto newValue = _pool.CreateArrayValue(value->size());
+  std::copy(value->begin(), value->end(), newValue->begin());
+  newValue->SetElement(pos, mutatedElement);
+  return _pool.FreezeArray(newValue);
 }
 
 ArrayValue* TestCaseMutator::ExchangeElements(ArrayValue* value, size_t, size_t, int) {
@@ -506,18 +455,11 @@ ArrayValue* TestCaseMutator::ExchangeElements(ArrayValue* value, size_t, size_t,
 
   auto pos1 = _rnd.Next<size_t>(0, value->size() - 2);
   auto pos2 = _rnd.Next<size_t>(pos1 + 1, value->size() - 1);
-  auto newValue = _pool.CreateArrayValue();
-  newValue->reserve(value->size());
-  for (size_t i = 0; i < value->size(); ++i) {
-    if (i == pos1) {
-      newValue->Push(value->GetElement(pos2));
-    } else if (i == pos2) {
-      newValue->Push(value->GetElement(pos1));
-    } else {
-      newValue->Push(value->GetElement(i));
-    }
-  }
-  return newValue;
+  auto newValue = _pool.CreateArrayValue(value->size());
+  std::copy(value->begin(), value->end(), newValue->begin());
+  newValue->SetElement(pos1, value->GetElement(pos2));
+  newValue->SetElement(pos2, value->GetElement(pos1));
+  return _pool.FreezeArray(newValue);
 }
 
 } // namespace caf
@@ -1,35 +1,98 @@
 #include "Infrastructure/Casting.h"
-#include "Infrastructure/Identity.h"
 #include "Infrastructure/Intrinsic.h"
+#include "Infrastructure/Memory.h"
 #include "Infrastructure/Stream.h"
+#include "Infrastructure/Varint.h"
 #include "Fuzzer/TestCaseSerializer.h"
 #include "Fuzzer/TestCase.h"
 #include "Fuzzer/Value.h"
 
+#include <algorithm>
 #include <cassert>
-#include <unordered_map>
+#include <cstring>
 #include <type_traits>
+#include <utility>
 
 namespace caf {
 
 namespace {
 
-template <size_t Size, typename T>
-void WriteInt(OutputStream& out, T value) {
+/**
+ * @brief A writer that only counts the number of bytes written.
+ *
+ */
+class SizeCounter {
+public:
+  explicit SizeCounter()
+    : _size(0)
+  { }
+
+  void WriteByte(uint8_t) { ++_size; }
+
+  void Write(const void *, size_t size) { _size += size; }
+
+  void WriteVarint(uint64_t value) { _size += GetVarintSize(value); }
+
+  size_t size() const { return _size; }
+
+private:
+  size_t _size;
+}; // class SizeCounter
+
+/**
+ * @brief A writer that writes into a buffer that is large enough to hold all data written.
+ *
+ */
+class BufferWriter {
+public:
+  explicit BufferWriter(uint8_t* buffer)
+    : _begin(buffer), _ptr(buffer)
+  { }
+
+  void WriteByte(uint8_t b) { *_ptr++ = b; }
+
+  void Write(const void* data, size_t size) {
+    if (size) {
+      std::memcpy(_ptr, data, size);
+      _ptr += size;
+    }
+  }
+
+  void WriteVarint(uint64_t value) { _ptr += EncodeVarint(value, _ptr); }
+
+  size_t size() const { return static_cast<size_t>(_ptr - _begin); }
+
+private:
+  uint8_t* _begin;
+  uint8_t* _ptr;
+}; // class BufferWriter
+
+template <size_t Size, typename Writer, typename T>
+void WriteInt(Writer& writer, T value) {
   static_assert(std::is_integral<T>::value, "T is not an integral type.");
   auto actual = caf::int_cast<Size>(value);
-  out.Write(&actual, sizeof(actual));
-}
-
-void WriteFloat(OutputStream& out, double value) {
-  out.Write(&value, sizeof(value));
+  writer.Write(&actual, sizeof(actual));
 }
 
 } // namespace <anonymous>
 
+/**
+ * @brief Indexes of the array values and the return values of a test case being serialized.
+ *
+ * Array values and return values share a single index space, in the order they appear in the
+ * serialized test case. Return value indexes are kept in a dense array indexed by function call
+ * index; array value indexes are kept in an open addressing hash table keyed by the address of the
+ * array value. Both tables keep their memory across test cases.
+ *
+ */
 class TestCaseSerializer::SerializationContext {
 public:
-  explicit SerializationContext() = default;
+  explicit SerializationContext()
+    : _arrayTable(MinArrayTableSize),
+      _arraysCount(0),
+      _retValueIndexes(),
+      _nextIndex(0)
+  { }
 
   SerializationContext(const SerializationContext &) = delete;
   SerializationContext(SerializationContext &&) noexcept = default;
@@ -37,121 +100,284 @@ public:
   SerializationContext& operator=(const SerializationContext &) = delete;
   SerializationContext& operator=(SerializationContext &&) = default;
 
-  bool HasValue(const Value* value) const {
-    return _valueIndexes.find(value) != _valueIndexes.end();
-  }
-
-  size_t GetValueIndex(const Value* value) const {
-    return _valueIndexes.at(value);
+  /**
+   * @brief Clear all indexes.
+   *
+   */
+  void clear() {
+    if (_arraysCount) {
+      std::fill(_arrayTable.begin(), _arrayTable.end(), ArrayEntry { });
+      _arraysCount = 0;
+    }
+    _retValueIndexes.clear();
+    _nextIndex = 0;
   }
 
-  void SetNextValue(const Value* value) {
-    _valueIndexes[value] = _indexAlloc.next();
-  }
+  /**
+   * @brief Get the index of the given array value, or allocate the next index for it if it has not
+   * been indexed yet.
+   *
+   * @param value the array value.
+   * @param index the index of the array value.
+   * @return true if the array value has been indexed before.
+   * @return false if the array value has not been indexed before.
+   */
+  bool GetOrSetArrayIndex(const Value* value, size_t& index) {
+    auto& entry = FindArrayEntry(value);
+    if (entry.Key) {
+      index = entry.Index;
+      return true;
+    }
 
-  void SkipNextValue() {
-    _indexAlloc.next();
+    entry.Key = value;
+    entry.Index = index = _nextIndex++;
+    if (++_arraysCount * 2 > _arrayTable.size()) {
+      GrowArrayTable();
+    }
+    return false;
   }
 
   void SetNextValueAsReturnValue(size_t funcIndex) {
-    _retValueIndexes[funcIndex] = _indexAlloc.next();
+    assert(funcIndex == _retValueIndexes.size() && "Function calls should be indexed in order.");
+    _retValueIndexes.push_back(_nextIndex++);
   }
 
-  size_t GetReturnValueIndex(size_t funcIndex) {
-    return _retValueIndexes.at(funcIndex);
+  size_t GetReturnValueIndex(size_t funcIndex) const {
+    assert(funcIndex < _retValueIndexes.size() && "Function call index is out of range.");
+    return _retValueIndexes[funcIndex];
   }
 
 private:
-  std::unordered_map<const Value *, size_t> _valueIndexes;
-  std::unordered_map<size_t, size_t> _retValueIndexes;
-  IncrementIdAllocator<size_t> _indexAlloc;
-}; // class TestCaseSerializer::SerializationContext
+  constexpr static const size_t MinArrayTableSize = 16;
 
-void TestCaseSerializer::Serialize(const TestCase& testCase) {
-  SerializationContext context { };
-
-  WriteInt<4>(_out, testCase.storeRootEntryIndex());
-  WriteInt<4>(_out, testCase.GetFunctionCallsCount());
-  for (size_t i = 0; i < testCase.GetFunctionCallsCount(); ++i) {
-    const auto& call = testCase.GetFunctionCall(i);
-    Serialize(call, context);
-    context.SetNextValueAsReturnValue(i);
-  }
-}
+  struct ArrayEntry {
+    const Value* Key = nullptr;
+    size_t Index = 0;
+  }; // struct ArrayEntry
 
-void TestCaseSerializer::Serialize(const FunctionCall& call, SerializationContext& context) {
-  WriteInt<4>(_out, call.funcId());
+  std::vector<ArrayEntry> _arrayTable; // Size is always a power of 2.
+  size_t _arraysCount;
+  std::vector<size_t> _retValueIndexes;
+  size_t _nextIndex;
 
-  if (call.HasThis()) {
-    Serialize(call.GetThis(), context);
-  } else {
-    auto undefined = Value::CreateUndefinedValue();
-    Serialize(&undefined, context);
+  ArrayEntry& FindArrayEntry(const Value* value) {
+    auto mask = _arrayTable.size() - 1;
+    // Fibonacci hashing of the address; the low bits are always zero due to alignment.
+    auto slot = static_cast<size_t>(
+        (reinterpret_cast<uintptr_t>(value) >> 4) * static_cast<uintptr_t>(0x9E3779B97F4A7C15ull));
+    while (true) {
+      slot &= mask;
+      auto& entry = _arrayTable[slot];
+      if (!entry.Key || entry.Key == value) {
+        return entry;
+      }
+      ++slot;
+    }
   }
 
-  WriteInt<1>(_out, static_cast<uint8_t>(call.IsConstructorCall()));
-
-  WriteInt<4>(_out, call.GetArgsCount());
-  for (auto arg : call) {
-    Serialize(arg, context);
+  void GrowArrayTable() {
+    std::vector<ArrayEntry> oldTable(_arrayTable.size() * 2);
+    std::swap(oldTable, _arrayTable);
+    for (const auto& entry : oldTable) {
+      if (entry.Key) {
+        FindArrayEntry(entry.Key) = entry;
+      }
+    }
   }
-}
+}; // class TestCaseSerializer::SerializationContext
+
+/**
+ * @brief Encode test cases through a writer. The same encoder logic is used for computing the
+ * serialized size and for writing the serialized data.
+ *
+ * @tparam Writer type of the writer.
+ */
+template <typename Writer>
+class TestCaseSerializer::Encoder {
+public:
+  explicit Encoder(Writer& writer, TestCaseFormatVersion version, SerializationContext& context)
+    : _writer(writer), _version(version), _context(context)
+  { }
 
-void TestCaseSerializer::Serialize(const Value* value, SerializationContext& context) {
-  assert(value && "value cannot be null.");
+  Encoder(const Encoder &) = delete;
+  Encoder(Encoder &&) noexcept = default;
 
-  PlaceholderValue pv { 0 };
-  if (value->IsPlaceholder()) {
-    pv = PlaceholderValue(context.GetReturnValueIndex(value->GetPlaceholderIndex()));
-    value = &pv;
-  }
+  /**
+   * @brief Encode the given test case.
+   *
+   * @param testCase the test case to encode.
+   */
+  void Encode(const TestCase& testCase) {
+    _context.clear();
 
-  if (context.HasValue(value)) {
-    pv = PlaceholderValue(context.GetValueIndex(value));
-    value = &pv;
+    if (_version == TestCaseFormatVersion::V1) {
+      WriteInt<4>(_writer, testCase.storeRootEntryIndex());
+    } else {
+      uint8_t header[TestCaseHeaderSize];
+      MakeTestCaseHeader(_version, header);
+      _writer.Write(header, sizeof(header));
+      WriteUInt(testCase.storeRootEntryIndex());
+    }
+
+    WriteUInt(testCase.GetFunctionCallsCount());
+    for (size_t i = 0; i < testCase.GetFunctionCallsCount(); ++i) {
+      Encode(testCase.GetFunctionCall(i));
+      _context.SetNextValueAsReturnValue(i);
+    }
   }
 
-  if (value->IsArray()) {
-    context.SetNextValue(value);
+private:
+  Writer& _writer;
+  TestCaseFormatVersion _version;
+  SerializationContext& _context;
+
+  void Encode(const FunctionCall& call) {
+    WriteUInt(call.funcId());
+
+    if (call.HasThis()) {
+      Encode(call.GetThis());
+    } else {
+      auto undefined = Value::CreateUndefinedValue();
+      Encode(&undefined);
+    }
+
+    _writer.WriteByte(static_cast<uint8_t>(call.IsConstructorCall()));
+
+    WriteUInt(call.GetArgsCount());
+    for (auto arg : call) {
+      Encode(arg);
+    }
   }
 
-  WriteInt<1>(_out, static_cast<uint8_t>(value->kind()));
-  switch (value->kind()) {
-    case ValueKind::Undefined:
-    case ValueKind::Null:
-      break;
-    case ValueKind::Function:
-      WriteInt<4>(_out, value->GetFunctionId());
-      break;
-    case ValueKind::Boolean:
-      WriteInt<1>(_out, static_cast<uint8_t>(value->GetBooleanValue()));
-      break;
-    case ValueKind::String: {
-      const auto& str = value->GetStringValue();
-      WriteInt<4>(_out, str.length());
-      _out.Write(str.data(), str.length());
-      break;
+  void Encode(const Value* value) {
+    assert(value && "value cannot be null.");
+
+    auto kind = value->kind();
+    if (kind == ValueKind::Placeholder) {
+      WritePlaceholder(_context.GetReturnValueIndex(value->GetPlaceholderIndex()));
+      return;
     }
-    case ValueKind::Integer:
-      WriteInt<4>(_out, value->GetIntegerValue());
-      break;
-    case ValueKind::Float:
-      WriteFloat(_out, value->GetFloatValue());
-      break;
-    case ValueKind::Array: {
-      auto arrayValue = caf::dyn_cast<ArrayValue>(value);
-      WriteInt<4>(_out, arrayValue->size());
-      for (auto element : *arrayValue) {
-        Serialize(element, context);
+
+    if (kind == ValueKind::Array) {
+      size_t index;
+      if (_context.GetOrSetArrayIndex(value, index)) {
+        WritePlaceholder(index);
+        return;
+      }
+    }
+
+    if (_version == TestCaseFormatVersion::V1) {
+      _writer.WriteByte(static_cast<uint8_t>(kind));
+    } else if (kind == ValueKind::Boolean) {
+      // Pack boolean values into the tag byte.
+      _writer.WriteByte(MakeValueTag(
+          static_cast<uint8_t>(kind), static_cast<uint8_t>(value->GetBooleanValue())));
+      return;
+    } else {
+      _writer.WriteByte(MakeValueTag(static_cast<uint8_t>(kind)));
+    }
+
+    switch (kind) {
+      case ValueKind::Undefined:
+      case ValueKind::Null:
+        break;
+      case ValueKind::Function:
+        WriteUInt(value->GetFunctionId());
+        break;
+      case ValueKind::Boolean:
+        _writer.WriteByte(static_cast<uint8_t>(value->GetBooleanValue()));
+        break;
+      case ValueKind::String: {
+        auto str = value->GetStringValue();
+        WriteUInt(str.length());
+        _writer.Write(str.data(), str.length());
+        break;
       }
-      break;
+      case ValueKind::Integer:
+        if (_version == TestCaseFormatVersion::V1) {
+          WriteInt<4>(_writer, value->GetIntegerValue());
+        } else {
+          _writer.WriteVarint(ZigZagEncode(value->GetIntegerValue()));
+        }
+        break;
+      case ValueKind::Float: {
+        auto floatValue = value->GetFloatValue();
+        _writer.Write(&floatValue, sizeof(floatValue));
+        break;
+      }
+      case ValueKind::Array: {
+        auto arrayValue = caf::dyn_cast<ArrayValue>(value);
+        WriteUInt(arrayValue->size());
+        for (auto element : *arrayValue) {
+          Encode(element);
+        }
+        break;
+      }
+      default:
+        CAF_UNREACHABLE;
+    }
+  }
+
+  void WritePlaceholder(size_t index) {
+    auto kind = static_cast<uint8_t>(ValueKind::Placeholder);
+    _writer.WriteByte(_version == TestCaseFormatVersion::V1 ? kind : MakeValueTag(kind));
+    WriteUInt(index);
+  }
+
+  void WriteUInt(uint64_t value) {
+    if (_version == TestCaseFormatVersion::V1) {
+      WriteInt<4>(_writer, value);
+    } else {
+      _writer.WriteVarint(value);
     }
-    case ValueKind::Placeholder:
-      WriteInt<4>(_out, value->GetPlaceholderIndex());
-      break;
-    default:
-      CAF_UNREACHABLE;
   }
+}; // class TestCaseSerializer::Encoder
+
+TestCaseSerializer::TestCaseSerializer(TestCaseFormatVersion version)
+  : _out(nullptr),
+    _version(version),
+    _context(caf::make_unique<SerializationContext>()),
+    _buffer()
+{ }
+
+TestCaseSerializer::TestCaseSerializer(OutputStream& out, TestCaseFormatVersion version)
+  : _out(&out),
+    _version(version),
+    _context(caf::make_unique<SerializationContext>()),
+    _buffer()
+{ }
+
+TestCaseSerializer::TestCaseSerializer(TestCaseSerializer &&) noexcept = default;
+
+TestCaseSerializer::~TestCaseSerializer() = default;
+
+void TestCaseSerializer::Serialize(const TestCase& testCase) {
+  assert(_out && "The serializer has no output stream.");
+  _buffer.clear();
+  Serialize(testCase, _buffer);
+  _out->Write(_buffer.data(), _buffer.size());
+}
+
+void TestCaseSerializer::Serialize(const TestCase& testCase, std::vector<uint8_t>& buffer) {
+  auto offset = buffer.size();
+  buffer.resize(offset + GetSerializedSize(testCase));
+  auto size = Serialize(testCase, buffer.data() + offset);
+  assert(offset + size == buffer.size() && "Serialized size mismatch.");
+  (void)size;
+}
+
+size_t TestCaseSerializer::Serialize(const TestCase& testCase, uint8_t* buffer) {
+  BufferWriter writer { buffer };
+  Encoder<BufferWriter> encoder { writer, _version, *_context };
+  encoder.Encode(testCase);
+  return writer.size();
+}
+
+size_t TestCaseSerializer::GetSerializedSize(const TestCase& testCase) {
+  SizeCounter counter { };
+  Encoder<SizeCounter> encoder { counter, _version, *_context };
+  encoder.Encode(testCase);
+  return counter.size();
 }
 
 } // namespace caf
@@ -20,10 +20,46 @@ class FunctionInfo {
         return this._func;
     }
 
+    get length() {
+        try {
+            const length = this._func.length;
+            return Number.isInteger(length) && length >= 0 ? length : undefined;
+        } catch (e) {
+            return undefined;
+        }
+    }
+
+    get source() {
+        try {
+            return Function.prototype.toString.call(this._func);
+        } catch (e) {
+            return '';
+        }
+    }
+
+    get isConstructor() {
+        // Only constructors and ordinary functions have a `prototype` property. Heuristically treat
+        // ordinary functions whose names start with an uppercase letter as constructors, too.
+        if (!Object.prototype.hasOwnProperty.call(this._func, 'prototype')) {
+            return false;
+        }
+        if (/^class\b/.test(this.source)) {
+            return true;
+        }
+        const lastName = this._name.split('.').pop();
+        return lastName.length > 0 && lastName[0] >= 'A' && lastName[0] <= 'Z';
+    }
+
+    get isNative() {
+        return /\{\s*\[native code\]\s*\}\s*$/.test(this.source);
+    }
+
     canonicalize() {
         return {
-            id: this._id,
             name: this._name,
+            length: this.length,
+            ctor: this.isConstructor,
+            native: this.isNative,
         };
     }
 }
@@ -161,4 +197,4 @@ if (require) {
 }
 
 // Dump the JSON database.
-console.log(JSON.stringify(funcs.map(f => f.name)));
+console.log(JSON.stringify(funcs.map(f => f.canonicalize())));
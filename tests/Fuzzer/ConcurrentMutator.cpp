@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Random.h"
+#include "Infrastructure/Stream.h"
+#include "Basic/CAFStore.h"
+#include "Basic/Function.h"
+#include "Fuzzer/ConcurrentMutator.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseGenerator.h"
+#include "Fuzzer/TestCaseSerializer.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+std::unique_ptr<caf::CAFStore> CreateMockStore() {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+  store->AddFunction(caf::Function { 1, "mod.ctor" });
+  return store;
+}
+
+std::vector<std::vector<uint8_t>> CreateSeeds(const caf::CAFStore& store, size_t count) {
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::Random<> rnd;
+  rnd.seed(1);
+  caf::TestCaseGenerator gen { store, *pool, rnd };
+
+  std::vector<std::vector<uint8_t>> seeds(count);
+  for (auto& seed : seeds) {
+    pool->clear();
+    auto tc = gen.GenerateTestCase();
+    caf::MemoryOutputStream outputStream { seed };
+    caf::TestCaseSerializer ser { outputStream };
+    ser.Serialize(tc);
+  }
+  return seeds;
+}
+
+} // namespace <anonymous>
+
+TEST(ConcurrentMutator, MutantsCount) {
+  auto store = CreateMockStore();
+  auto seeds = CreateSeeds(*store, 8);
+
+  caf::ConcurrentMutator mutator { *store, 4 };
+  ASSERT_EQ(4, mutator.GetThreadsCount());
+
+  auto mutants = mutator.Mutate(seeds, 3, 42);
+  ASSERT_EQ(seeds.size() * 3, mutants.size());
+  for (const auto& mutant : mutants) {
+    ASSERT_FALSE(mutant.empty());
+  }
+}
+
+TEST(ConcurrentMutator, Deterministic) {
+  auto store = CreateMockStore();
+  auto seeds = CreateSeeds(*store, 16);
+
+  caf::ConcurrentMutator single { *store, 1 };
+  caf::ConcurrentMutator multi { *store, 4 };
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    ASSERT_EQ(single.Mutate(seeds, 4, seed), multi.Mutate(seeds, 4, seed));
+  }
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "TemporaryFile.h"
+#include "Infrastructure/Stream.h"
+#include "Fuzzer/CorpusArchive.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CorpusArchiveTest : public ::testing::Test {
+protected:
+  caf::test::TemporaryFile _file { "caf_archive" };
+}; // class CorpusArchiveTest
+
+std::vector<uint8_t> CreateTestCase(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + seed);
+  }
+  return data;
+}
+
+} // namespace <anonymous>
+
+TEST_F(CorpusArchiveTest, RoundTrip) {
+  auto root = CreateTestCase(200, 1);
+  auto child = root;
+  child[100] ^= 0xFF;
+  child.insert(child.begin() + 150, 3, 0x42);
+  auto unrelated = CreateTestCase(50, 99);
+  auto grandChild = child;
+  grandChild.pop_back();
+
+  caf::CorpusArchiveWriter writer { };
+  writer.AddEntry("id:000000,orig:seed", root.data(), root.size());
+  writer.AddEntry("id:000001,orig:other", unrelated.data(), unrelated.size());
+  writer.AddEntry("id:000002,src:000000,op:havoc", child.data(), child.size());
+  writer.AddEntry("id:000003,src:000002,op:havoc", grandChild.data(), grandChild.size());
+  ASSERT_EQ(4, writer.size());
+  ASSERT_EQ(2, writer.GetDeltaEntriesCount());
+
+  std::vector<uint8_t> data;
+  caf::MemoryOutputStream out { data };
+  writer.Write(out);
+  ASSERT_LT(data.size(), root.size() * 2 + unrelated.size());
+  _file.Write(data);
+
+  ASSERT_TRUE(caf::CorpusArchive::IsCorpusArchive(_file.path()));
+  auto archive = caf::CorpusArchive::Open(_file.path());
+  ASSERT_NE(archive, nullptr);
+  ASSERT_EQ(4, archive->size());
+  ASSERT_EQ(0, archive->GetParent(2));
+  ASSERT_EQ(2, archive->GetParent(3));
+
+  std::vector<std::vector<uint8_t>> expected { root, unrelated, child, grandChild };
+  std::vector<uint8_t> reconstructed;
+  for (size_t i = 0; i < expected.size(); ++i) {
+    archive->Reconstruct(i, reconstructed);
+    ASSERT_EQ(expected[i], reconstructed);
+  }
+  ASSERT_EQ("id:000003,src:000002,op:havoc", archive->GetName(3));
+
+  // Append an entry whose parent is in the existing archive.
+  auto appended = root;
+  appended[0] = 0;
+  caf::CorpusArchiveWriter appender { };
+  appender.AppendTo(*archive);
+  appender.AddEntry("id:000004,src:000000,op:flip", appended.data(), appended.size());
+  std::vector<uint8_t> appendedData;
+  caf::MemoryOutputStream appendedOut { appendedData };
+  appender.Write(appendedOut);
+  _file.Write(appendedData, "ab");
+
+  archive = caf::CorpusArchive::Open(_file.path());
+  ASSERT_NE(archive, nullptr);
+  ASSERT_EQ(5, archive->size());
+  ASSERT_EQ(0, archive->GetParent(4));
+  archive->Reconstruct(4, reconstructed);
+  ASSERT_EQ(appended, reconstructed);
+
+  // Appending the same entries again skips the ones already archived.
+  auto changed = child;
+  changed[0] ^= 0xFF;
+  caf::CorpusArchiveWriter reappender { };
+  reappender.AppendTo(*archive);
+  ASSERT_FALSE(reappender.AddEntry("id:000000,orig:seed", root.data(), root.size()));
+  ASSERT_FALSE(reappender.AddEntry("id:000004,src:000000,op:flip", appended.data(),
+                                   appended.size()));
+  ASSERT_TRUE(reappender.AddEntry("id:000002,src:000000,op:havoc", changed.data(),
+                                  changed.size()));
+  ASSERT_TRUE(reappender.AddEntry("id:000005,orig:new", unrelated.data(), unrelated.size()));
+  ASSERT_EQ(2, reappender.size());
+  ASSERT_EQ(2, reappender.GetSkippedEntriesCount());
+  appendedData.clear();
+  reappender.Write(appendedOut);
+  _file.Write(appendedData, "ab");
+
+  archive = caf::CorpusArchive::Open(_file.path());
+  ASSERT_NE(archive, nullptr);
+  ASSERT_EQ(7, archive->size());
+  archive->Reconstruct(5, reconstructed);
+  ASSERT_EQ(changed, reconstructed);
+  archive->Reconstruct(6, reconstructed);
+  ASSERT_EQ(unrelated, reconstructed);
+}
+
+TEST_F(CorpusArchiveTest, MaxChainDepth) {
+  caf::CorpusArchiveWriter writer { 2 };
+  auto data = CreateTestCase(100, 0);
+  for (size_t i = 0; i < 6; ++i) {
+    data[i] = 0xFF;
+    writer.AddEntry("entry", data.data(), data.size());
+  }
+
+  std::vector<uint8_t> archiveData;
+  caf::MemoryOutputStream out { archiveData };
+  writer.Write(out);
+  _file.Write(archiveData);
+
+  auto archive = caf::CorpusArchive::Open(_file.path());
+  ASSERT_NE(archive, nullptr);
+  for (size_t i = 0; i < archive->size(); ++i) {
+    size_t depth = 0;
+    for (auto p = archive->GetParent(i); p != caf::CorpusArchive::NoParent;
+         p = archive->GetParent(p)) {
+      ++depth;
+    }
+    ASSERT_LE(depth, 2);
+  }
+}
+
+TEST_F(CorpusArchiveTest, Malformed) {
+  auto root = CreateTestCase(100, 1);
+  auto child = root;
+  child[50] = 0;
+
+  caf::CorpusArchiveWriter writer { };
+  writer.AddEntry("root", root.data(), root.size());
+  writer.AddEntry("child", child.data(), child.size());
+  std::vector<uint8_t> data;
+  caf::MemoryOutputStream out { data };
+  writer.Write(out);
+
+  _file.Write(std::vector<uint8_t>(data.begin(), data.end() - 1));
+  ASSERT_EQ(caf::CorpusArchive::Open(_file.path()), nullptr);
+
+  _file.Write(root);
+  ASSERT_FALSE(caf::CorpusArchive::IsCorpusArchive(_file.path()));
+  ASSERT_EQ(caf::CorpusArchive::Open(_file.path()), nullptr);
+}
@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+#include "TemporaryFile.h"
+#include "Infrastructure/Stream.h"
+#include "Fuzzer/CorpusPack.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CorpusPackTest : public ::testing::Test {
+protected:
+  caf::test::TemporaryFile _file { "caf_pack" };
+}; // class CorpusPackTest
+
+} // namespace <anonymous>
+
+TEST_F(CorpusPackTest, RoundTrip) {
+  std::vector<uint8_t> first { 1, 2, 3 };
+  std::vector<uint8_t> second { };
+  std::vector<uint8_t> third { 4, 5, 6, 7, 8 };
+
+  caf::CorpusPackWriter writer { };
+  writer.AddEntry("first", first.data(), first.size());
+  writer.AddEntry("second", second.data(), second.size());
+  writer.AddEntry("third", third.data(), third.size());
+  ASSERT_EQ(writer.size(), 3);
+
+  std::vector<uint8_t> data;
+  caf::MemoryOutputStream out { data };
+  writer.Write(out);
+  _file.Write(data);
+
+  ASSERT_TRUE(caf::CorpusPack::IsCorpusPack(_file.path()));
+  auto pack = caf::CorpusPack::Open(_file.path());
+  ASSERT_NE(pack, nullptr);
+  ASSERT_EQ(pack->size(), 3);
+
+  auto entry = pack->GetEntry(0);
+  EXPECT_EQ(entry.Name, "first");
+  EXPECT_EQ(std::vector<uint8_t>(entry.Data, entry.Data + entry.Size), first);
+
+  entry = pack->GetEntry(1);
+  EXPECT_EQ(entry.Name, "second");
+  EXPECT_EQ(entry.Size, 0);
+
+  entry = pack->GetEntry(2);
+  EXPECT_EQ(entry.Name, "third");
+  EXPECT_EQ(std::vector<uint8_t>(entry.Data, entry.Data + entry.Size), third);
+}
+
+TEST_F(CorpusPackTest, Malformed) {
+  std::vector<uint8_t> payload { 1, 2, 3 };
+  caf::CorpusPackWriter writer { };
+  writer.AddEntry("entry", payload.data(), payload.size());
+
+  std::vector<uint8_t> data;
+  caf::MemoryOutputStream out { data };
+  writer.Write(out);
+
+  // Not a corpus pack.
+  _file.Write(payload);
+  EXPECT_FALSE(caf::CorpusPack::IsCorpusPack(_file.path()));
+  EXPECT_EQ(caf::CorpusPack::Open(_file.path()), nullptr);
+
+  // Truncated entry data.
+  _file.Write(std::vector<uint8_t>(data.begin(), data.end() - 1));
+  EXPECT_TRUE(caf::CorpusPack::IsCorpusPack(_file.path()));
+  EXPECT_EQ(caf::CorpusPack::Open(_file.path()), nullptr);
+
+  // Bad version.
+  auto badVersion = data;
+  badVersion[4] = 0xFF;
+  _file.Write(badVersion);
+  EXPECT_EQ(caf::CorpusPack::Open(_file.path()), nullptr);
+}
@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include "Fuzzer/ObjectPool.h"
+
+#include <string>
+#include <vector>
+
+TEST(ObjectPool, InternStrings) {
+  caf::ObjectPool pool;
+
+  std::string longString(100, 'x');
+  auto s1 = pool.GetOrCreateStringValue(longString);
+  auto s2 = pool.GetOrCreateStringValue(std::string(100, 'x'));
+  ASSERT_EQ(s1, s2);
+  ASSERT_EQ(longString, s1->value());
+  ASSERT_NE(s1, pool.GetOrCreateStringValue(std::string(99, 'x')));
+  ASSERT_EQ(pool.GetOrCreateStringValue(""), pool.GetOrCreateStringValue(""));
+
+  // Grow the string table.
+  std::vector<caf::StringValue *> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(pool.GetOrCreateStringValue(std::to_string(i)));
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(values[i], pool.GetOrCreateStringValue(std::to_string(i)));
+    ASSERT_EQ(std::to_string(i), values[i]->value());
+  }
+  ASSERT_EQ(1003, pool.GetInternedStringsCount());
+
+  pool.clear();
+  ASSERT_EQ(0, pool.GetInternedStringsCount());
+  auto s3 = pool.GetOrCreateStringValue(longString);
+  ASSERT_EQ(longString, s3->value());
+  ASSERT_EQ(s3, pool.GetOrCreateStringValue(longString));
+
+  // Every slot of the grown table is emptied, so all strings are interned again.
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(std::to_string(i), pool.GetOrCreateStringValue(std::to_string(i))->value());
+  }
+  ASSERT_EQ(1001, pool.GetInternedStringsCount());
+}
+
+TEST(ObjectPool, HashConsing) {
+  caf::ObjectPool pool;
+
+  auto createArray = [&pool] (int32_t first, double second) {
+    auto array = pool.CreateArrayValue(2);
+    array->SetElement(0, pool.GetOrCreateIntegerValue(first));
+    array->SetElement(1, pool.GetOrCreateFloatValue(second));
+    return pool.FreezeArray(array);
+  };
+
+  // Arrays are not shared unless hash-consing is enabled.
+  auto a1 = createArray(100000, 1.5);
+  ASSERT_TRUE(a1->frozen());
+  ASSERT_NE(a1, createArray(100000, 1.5));
+
+  pool.SetHashConsingEnabled(true);
+  auto a2 = createArray(100000, 1.5);
+  ASSERT_EQ(a2, createArray(100000, 1.5));
+  ASSERT_NE(a2, createArray(100000, 2.5));
+  ASSERT_NE(createArray(1, 0.0), createArray(1, -0.0));
+
+  auto nested1 = pool.CreateArrayValue(1);
+  nested1->SetElement(0, createArray(100000, 1.5));
+  auto nested2 = pool.CreateArrayValue(1);
+  nested2->SetElement(0, createArray(100000, 1.5));
+  ASSERT_EQ(pool.FreezeArray(nested1), pool.FreezeArray(nested2));
+
+  auto empty = pool.FreezeArray(pool.CreateArrayValue(0));
+  ASSERT_EQ(empty, pool.FreezeArray(pool.CreateArrayValue(0)));
+
+  pool.clear();
+  ASSERT_TRUE(pool.IsHashConsingEnabled());
+  ASSERT_EQ(createArray(100000, 1.5), createArray(100000, 1.5));
+}
+
+TEST(ObjectPool, Statistics) {
+  caf::ObjectPool pool;
+  auto stringIndex = static_cast<size_t>(caf::ValueKind::String);
+  auto arrayIndex = static_cast<size_t>(caf::ValueKind::Array);
+  auto undefIndex = static_cast<size_t>(caf::ValueKind::Undefined);
+
+  pool.GetUndefinedValue();
+  pool.GetOrCreateStringValue("abc");
+  pool.GetOrCreateStringValue("abc");
+  pool.GetOrCreateStringValue("abcd");
+  pool.CreateArrayValue(4);
+
+  auto stat = pool.GetStatistics();
+  ASSERT_EQ(1, stat.ValuesCount[undefIndex]);
+  ASSERT_EQ(2, stat.ValuesCount[stringIndex]);
+  ASSERT_EQ(2 * sizeof(caf::Value) + 9, stat.ValueBytes[stringIndex]);
+  ASSERT_EQ(1, stat.ValuesCount[arrayIndex]);
+  ASSERT_EQ(sizeof(caf::Value) + 4 * sizeof(caf::Value *), stat.ValueBytes[arrayIndex]);
+  ASSERT_GT(stat.BytesAllocated, 0);
+  ASSERT_GE(stat.BytesReserved, stat.BytesAllocated);
+  auto highWaterMark = stat.HighWaterMark;
+  ASSERT_EQ(stat.BytesAllocated, highWaterMark);
+
+  pool.clear();
+  stat = pool.GetStatistics();
+  ASSERT_EQ(1, stat.ValuesCount[undefIndex]);
+  ASSERT_EQ(0, stat.ValuesCount[stringIndex]);
+  ASSERT_EQ(0, stat.BytesAllocated);
+  ASSERT_EQ(highWaterMark, stat.HighWaterMark);
+  ASSERT_EQ(1, stat.ClearsCount);
+  ASSERT_EQ(0, stat.BudgetResetsCount);
+
+  // Exceed a small budget, the retained memory is released on the next clear.
+  pool.SetMemoryBudget(1024 * 1024);
+  for (int i = 0; i < 100000; ++i) {
+    pool.GetOrCreateStringValue(std::to_string(i));
+  }
+  ASSERT_GT(pool.GetBytesReserved(), pool.GetMemoryBudget());
+  pool.clear();
+  ASSERT_LE(pool.GetBytesReserved(), pool.GetMemoryBudget());
+  ASSERT_EQ(1, pool.GetStatistics().BudgetResetsCount);
+  ASSERT_EQ("1", pool.GetOrCreateStringValue("1")->value());
+}
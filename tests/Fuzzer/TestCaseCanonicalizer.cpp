@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Random.h"
+#include "Basic/CAFStore.h"
+#include "Basic/Function.h"
+#include "Fuzzer/FunctionCall.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseCanonicalizer.h"
+#include "Fuzzer/TestCaseDeserializer.h"
+#include "Fuzzer/TestCaseGenerator.h"
+#include "Fuzzer/TestCaseSerializer.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+caf::FunctionCall CreateCall(caf::FunctionIdType funcId, std::vector<caf::Value *> args) {
+  caf::FunctionCall call { funcId };
+  for (auto arg : args) {
+    call.PushArg(arg);
+  }
+  return call;
+}
+
+caf::ArrayValue* CreateArray(caf::ObjectPool& pool, std::vector<caf::Value *> elements) {
+  auto array = pool.CreateArrayValue(elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    array->SetElement(i, elements[i]);
+  }
+  return array;
+}
+
+std::vector<uint8_t> Serialize(const caf::TestCase& tc) {
+  std::vector<uint8_t> data;
+  caf::TestCaseSerializer ser { };
+  ser.Serialize(tc, data);
+  return data;
+}
+
+} // namespace <anonymous>
+
+TEST(TestCaseCanonicalizer, Reordering) {
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::TestCaseCanonicalizer canonicalizer { };
+
+  // f(1); g("s"); h($0);
+  caf::TestCase first;
+  first.PushFunctionCall(CreateCall(0, { pool->GetOrCreateIntegerValue(1) }));
+  first.PushFunctionCall(CreateCall(1, { pool->GetOrCreateStringValue("s") }));
+  first.PushFunctionCall(CreateCall(2, { pool->GetPlaceholderValue(0) }));
+
+  // g("s"); f(1); h($1);
+  caf::TestCase second;
+  second.PushFunctionCall(CreateCall(1, { pool->GetOrCreateStringValue("s") }));
+  second.PushFunctionCall(CreateCall(0, { pool->GetOrCreateIntegerValue(1) }));
+  second.PushFunctionCall(CreateCall(2, { pool->GetPlaceholderValue(1) }));
+
+  // g("s"); f(1); h($0);
+  caf::TestCase third;
+  third.PushFunctionCall(CreateCall(1, { pool->GetOrCreateStringValue("s") }));
+  third.PushFunctionCall(CreateCall(0, { pool->GetOrCreateIntegerValue(1) }));
+  third.PushFunctionCall(CreateCall(2, { pool->GetPlaceholderValue(0) }));
+
+  auto hash = canonicalizer.Hash(first);
+  ASSERT_EQ(hash, canonicalizer.Hash(second));
+  ASSERT_NE(hash, canonicalizer.Hash(third));
+
+  canonicalizer.Canonicalize(first, *pool);
+  canonicalizer.Canonicalize(second, *pool);
+  ASSERT_EQ(Serialize(first), Serialize(second));
+  ASSERT_EQ(hash, canonicalizer.Hash(first));
+
+  // The call to h should still come after the call to f it depends on.
+  for (size_t i = 0; i < first.GetFunctionCallsCount(); ++i) {
+    const auto& call = first.GetFunctionCall(i);
+    if (call.funcId() == 2) {
+      auto placeholderIndex = call.GetArg(0)->GetPlaceholderIndex();
+      ASSERT_LT(placeholderIndex, i);
+      ASSERT_EQ(0, first.GetFunctionCall(placeholderIndex).funcId());
+    }
+  }
+}
+
+TEST(TestCaseCanonicalizer, SharedArrays) {
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::TestCaseCanonicalizer canonicalizer { };
+
+  auto shared = CreateArray(*pool, { pool->GetOrCreateIntegerValue(1), pool->GetNullValue() });
+  caf::TestCase first;
+  first.PushFunctionCall(CreateCall(0, { shared, shared }));
+
+  caf::TestCase second;
+  second.PushFunctionCall(CreateCall(0, {
+      CreateArray(*pool, { pool->GetOrCreateIntegerValue(1), pool->GetNullValue() }),
+      CreateArray(*pool, { pool->GetOrCreateIntegerValue(1), pool->GetNullValue() }) }));
+
+  caf::TestCase third;
+  third.PushFunctionCall(CreateCall(0, {
+      CreateArray(*pool, { pool->GetOrCreateIntegerValue(1), pool->GetNullValue() }),
+      CreateArray(*pool, { pool->GetOrCreateIntegerValue(2), pool->GetNullValue() }) }));
+
+  ASSERT_EQ(canonicalizer.Hash(first), canonicalizer.Hash(second));
+  ASSERT_NE(canonicalizer.Hash(first), canonicalizer.Hash(third));
+}
+
+TEST(TestCaseCanonicalizer, CyclicArrays) {
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::TestCaseCanonicalizer canonicalizer { };
+
+  // f(a) where a = [a]. Validated test cases cannot contain such arrays but hashing must terminate.
+  auto array = CreateArray(*pool, { pool->GetUndefinedValue() });
+  array->SetElement(0, array);
+
+  caf::TestCase tc;
+  tc.PushFunctionCall(CreateCall(0, { array }));
+  ASSERT_EQ(canonicalizer.Hash(tc), canonicalizer.Hash(tc));
+
+  canonicalizer.Canonicalize(tc, *pool);
+  ASSERT_EQ(1, tc.GetFunctionCallsCount());
+}
+
+TEST(TestCaseCanonicalizer, CorruptedInputs) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+
+  caf::ObjectPool pool;
+  caf::Random<> rnd;
+  rnd.seed(6);
+  caf::TestCaseGenerator gen { *store, pool, rnd };
+  caf::TestCaseCanonicalizer canonicalizer { };
+
+  // The mutator hashes every queue entry AFL hands in, so anything TryDeserialize accepts must hash
+  // and canonicalize without crashing.
+  caf::ObjectPool decodePool;
+  for (int round = 0; round < 10000; ++round) {
+    pool.clear();
+    decodePool.clear();
+    auto tc = gen.GenerateTestCase();
+    auto data = Serialize(tc);
+
+    auto flips = rnd.Next<int>(1, 4);
+    while (flips--) {
+      data[rnd.Index(data)] ^= static_cast<uint8_t>(rnd.Next<int>(1, 255));
+    }
+
+    caf::TestCaseDeserializer de { decodePool, data.data(), data.size() };
+    caf::TestCase decoded;
+    if (de.TryDeserialize(decoded)) {
+      canonicalizer.Hash(decoded);
+      canonicalizer.Canonicalize(decoded, decodePool);
+    }
+  }
+
+  // A call whose `this` is an array containing a placeholder to the array itself.
+  std::vector<uint8_t> selfRef { 'C', 'A', 'F', 2, 0, 1, 0, 0x07, 1, 0x08, 0, 0, 0 };
+  caf::TestCaseDeserializer de { decodePool, selfRef.data(), selfRef.size() };
+  caf::TestCase decoded;
+  ASSERT_FALSE(de.TryDeserialize(decoded));
+}
@@ -1,8 +1,11 @@
 #include "gtest/gtest.h"
+#include "TemporaryFile.h"
 #include "Infrastructure/Memory.h"
 #include "Infrastructure/Random.h"
 #include "Basic/CAFStore.h"
 #include "Basic/Function.h"
+#include "Basic/ReturnKindFeedback.h"
+#include "Fuzzer/FunctionCall.h"
 #include "Fuzzer/TestCase.h"
 #include "Fuzzer/TestCaseGenerator.h"
 #include "Fuzzer/ObjectPool.h"
@@ -102,3 +105,105 @@ TEST(TestCaseGenerator, GenerateValueNoPlaceholder) {
     AssertNoPlaceholder(value);
   }
 }
+
+TEST(TestCaseGenerator, WeightedFunctionSelection) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "mod.hot" });
+  store->AddFunction(caf::Function { 1, "mod.cold" });
+  store->AddFunction(caf::Function { 2, "other" });
+  store->SetFunctionWeight(1, 0);
+  store->LoadWeights(nlohmann::json { { "other", 0 } });
+
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::Random<> rnd;
+  caf::TestCaseGenerator gen { *store, *pool, rnd };
+  for (int round = 0; round < 10000; ++round) {
+    ASSERT_EQ(0, gen.GenerateFunctionValue(0)->funcId());
+  }
+}
+
+TEST(TestCaseGenerator, ArityAwareArgumentsCount) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->Load(nlohmann::json::parse(R"([{ "name": "f", "length": 8, "ctor": true }])"));
+  ASSERT_EQ(8, store->GetFunction(0).arity());
+  ASSERT_TRUE(store->GetFunction(0).IsConstructor());
+
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::Random<> rnd;
+  caf::TestCaseGenerator gen { *store, *pool, rnd };
+  size_t exact = 0;
+  for (int round = 0; round < 1000; ++round) {
+    auto tc = gen.GenerateTestCase(0);
+    for (const auto& call : tc) {
+      ASSERT_LE(call.GetArgsCount(), 8);
+      if (call.GetArgsCount() == 8) {
+        ++exact;
+      }
+    }
+  }
+  ASSERT_GT(exact, 0);
+}
+
+TEST(TestCaseGenerator, ReturnKindFeedback) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "producer" });
+  store->AddFunction(caf::Function { 1, "consumer" });
+
+  caf::test::TemporaryFile file { "caf-feedback" };
+  auto feedback = caf::ReturnKindFeedback::Create(file.path(), store->GetFunctionsCount());
+  ASSERT_NE(nullptr, feedback);
+  for (int i = 0; i < 1000; ++i) {
+    feedback->Record(0, caf::ReturnKind::Object);
+    feedback->Record(1, caf::ReturnKind::Threw);
+  }
+  feedback->Record(2, caf::ReturnKind::Object);
+
+  auto reader = caf::ReturnKindFeedback::Open(file.path());
+  ASSERT_NE(nullptr, reader);
+  ASSERT_EQ(1000, reader->GetCount(0, caf::ReturnKind::Object));
+  ASSERT_EQ(1000, reader->GetTotalCount(1));
+  ASSERT_GT(reader->GetObjectRate(0), 0.99);
+  ASSERT_LT(reader->GetObjectRate(1), 0.01);
+
+  caf::TestCase tc { };
+  tc.PushFunctionCall(caf::FunctionCall { 1 });
+  tc.PushFunctionCall(caf::FunctionCall { 0 });
+  tc.PushFunctionCall(caf::FunctionCall { 1 });
+
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::Random<> rnd;
+  caf::TestCaseGenerator gen { *store, *pool, rnd };
+  gen.SetFeedback(reader.get());
+
+  size_t hits = 0;
+  constexpr const int Rounds = 1000;
+  for (int round = 0; round < Rounds; ++round) {
+    auto value = gen.GenerateThisValue(
+        0, caf::TestCaseGenerator::GeneratePlaceholderValueParams { 3, &tc });
+    if (value->IsPlaceholder() && value->GetPlaceholderIndex() == 1) {
+      ++hits;
+    }
+  }
+  ASSERT_GT(hits, Rounds * 9 / 10);
+}
+
+TEST(TestCaseGenerator, ClearPool) {
+  auto store = CreateMockStore();
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::Random<> rnd;
+  caf::TestCaseGenerator gen { *store, *pool, rnd };
+
+  auto undef = pool->GetUndefinedValue();
+  auto func = pool->GetFunctionValue(0);
+  for (int round = 0; round < 100; ++round) {
+    pool->clear();
+    gen.GenerateTestCase();
+    ASSERT_EQ(undef, pool->GetUndefinedValue());
+    ASSERT_EQ(func, pool->GetFunctionValue(0));
+  }
+
+  pool->clear(false);
+  ASSERT_TRUE(pool->empty());
+  ASSERT_EQ(0, pool->GetBytesAllocated());
+  ASSERT_TRUE(pool->GetUndefinedValue()->IsUndefined());
+}
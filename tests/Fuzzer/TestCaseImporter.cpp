@@ -0,0 +1,78 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Memory.h"
+#include "Basic/CAFStore.h"
+#include "Basic/Function.h"
+#include "Fuzzer/FunctionCall.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseImporter.h"
+#include "Fuzzer/Value.h"
+
+#include <memory>
+
+namespace {
+
+std::unique_ptr<caf::CAFStore> CreateMockStore() {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "buffer.Buffer" });
+  store->AddFunction(caf::Function { 1, "buffer.Buffer.prototype.write" });
+  store->AddFunction(caf::Function { 2, "fs.readFileSync" });
+  store->AddFunction(caf::Function { 3, "stream.Readable.prototype.read" });
+  return store;
+}
+
+} // namespace <anonymous>
+
+TEST(TestCaseImporter, Import) {
+  auto store = CreateMockStore();
+  auto pool = caf::make_unique<caf::ObjectPool>();
+  caf::TestCaseImporter importer { *store, *pool };
+
+  auto tc = importer.Import(R"(
+    'use strict';
+    const fs = require('fs');
+    const { Buffer } = require('buffer'); // Unsupported.
+    const B = buffer.Buffer;
+    let buf = new B(-16, [1, 'a\x41', null], true);
+    buf.write("x\n", 0x10)
+    fs.readFileSync(buf, fs.readFileSync, undefined, 1.5)
+    if (buf) { buf.write(); }
+    const r = fs.readFileSync();
+    r.read();
+  )");
+
+  ASSERT_EQ(5, tc.GetFunctionCallsCount());
+  ASSERT_EQ(5, importer.GetImportedCount());
+  ASSERT_EQ(2, importer.GetSkippedCount());
+
+  const auto& ctor = tc.GetFunctionCall(0);
+  ASSERT_EQ(0, ctor.funcId());
+  ASSERT_TRUE(ctor.IsConstructorCall());
+  ASSERT_EQ(3, ctor.GetArgsCount());
+  ASSERT_EQ(-16, ctor.GetArg(0)->GetIntegerValue());
+  auto array = caf::dyn_cast<caf::ArrayValue>(ctor.GetArg(1));
+  ASSERT_EQ(3, array->size());
+  ASSERT_EQ("aA", array->GetElement(1)->GetStringValue());
+  ASSERT_TRUE(array->GetElement(2)->IsNull());
+  ASSERT_TRUE(ctor.GetArg(2)->GetBooleanValue());
+
+  const auto& write = tc.GetFunctionCall(1);
+  ASSERT_EQ(1, write.funcId());
+  ASSERT_FALSE(write.IsConstructorCall());
+  ASSERT_TRUE(write.GetThis()->IsPlaceholder());
+  ASSERT_EQ(0, write.GetThis()->GetPlaceholderIndex());
+  ASSERT_EQ("x\n", write.GetArg(0)->GetStringValue());
+  ASSERT_EQ(16, write.GetArg(1)->GetIntegerValue());
+
+  const auto& read = tc.GetFunctionCall(2);
+  ASSERT_EQ(2, read.funcId());
+  ASSERT_EQ(0, read.GetArg(0)->GetPlaceholderIndex());
+  ASSERT_EQ(2, read.GetArg(1)->GetFunctionId());
+  ASSERT_TRUE(read.GetArg(2)->IsUndefined());
+  ASSERT_EQ(1.5, read.GetArg(3)->GetFloatValue());
+
+  // Method resolved by a unique suffix match.
+  const auto& suffix = tc.GetFunctionCall(4);
+  ASSERT_EQ(3, suffix.funcId());
+  ASSERT_EQ(3, suffix.GetThis()->GetPlaceholderIndex());
+}
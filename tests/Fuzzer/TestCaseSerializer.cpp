@@ -0,0 +1,246 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Random.h"
+#include "Infrastructure/Stream.h"
+#include "Basic/CAFStore.h"
+#include "Basic/Function.h"
+#include "Basic/TestCaseFormat.h"
+#include "Basic/TestCaseValidator.h"
+#include "Fuzzer/ObjectPool.h"
+#include "Fuzzer/TestCase.h"
+#include "Fuzzer/TestCaseDeserializer.h"
+#include "Fuzzer/TestCaseGenerator.h"
+#include "Fuzzer/TestCaseSerializer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> Serialize(const caf::TestCase& tc, caf::TestCaseFormatVersion version) {
+  std::vector<uint8_t> data;
+  caf::MemoryOutputStream out { data };
+  caf::TestCaseSerializer ser { out, version };
+  ser.Serialize(tc);
+  return data;
+}
+
+caf::TestCase Deserialize(caf::ObjectPool& pool, const std::vector<uint8_t>& data) {
+  caf::MemoryInputStream in { data.data(), data.size() };
+  caf::TestCaseDeserializer de { pool, in };
+  return de.Deserialize();
+}
+
+} // namespace <anonymous>
+
+TEST(TestCaseSerializer, FormatVersions) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+  store->AddFunction(caf::Function { 1, "mod.ctor" });
+
+  caf::ObjectPool pool;
+  caf::Random<> rnd;
+  rnd.seed(1);
+  caf::TestCaseGenerator gen { *store, pool, rnd };
+
+  size_t v1Size = 0;
+  size_t v2Size = 0;
+  for (int round = 0; round < 1000; ++round) {
+    pool.clear();
+    auto tc = gen.GenerateTestCase();
+
+    auto v1 = Serialize(tc, caf::TestCaseFormatVersion::V1);
+    auto v2 = Serialize(tc, caf::TestCaseFormatVersion::V2);
+    ASSERT_EQ(v2, Serialize(tc, caf::LatestTestCaseFormatVersion));
+    ASSERT_EQ('C', v2[0]);
+    ASSERT_EQ(2, v2[3]);
+
+    // Both versions decode to the same test case.
+    ASSERT_EQ(v1, Serialize(Deserialize(pool, v1), caf::TestCaseFormatVersion::V1));
+    ASSERT_EQ(v1, Serialize(Deserialize(pool, v2), caf::TestCaseFormatVersion::V1));
+    ASSERT_EQ(v2, Serialize(Deserialize(pool, v1), caf::TestCaseFormatVersion::V2));
+
+    v1Size += v1.size();
+    v2Size += v2.size();
+  }
+  ASSERT_LT(v2Size, v1Size);
+}
+
+TEST(TestCaseSerializer, SerializeToBuffer) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+
+  caf::ObjectPool pool;
+  pool.SetHashConsingEnabled(true);
+  caf::Random<> rnd;
+  rnd.seed(2);
+  caf::TestCaseGenerator gen { *store, pool, rnd };
+
+  caf::TestCaseSerializer bufferSer { };
+  std::vector<uint8_t> buffer;
+  for (int round = 0; round < 1000; ++round) {
+    pool.clear();
+    auto tc = gen.GenerateTestCase();
+
+    std::vector<uint8_t> expected;
+    caf::MemoryOutputStream out { expected };
+    caf::TestCaseSerializer streamSer { out };
+    streamSer.Serialize(tc);
+
+    // The serializer is reused across test cases.
+    auto size = bufferSer.GetSerializedSize(tc);
+    ASSERT_EQ(expected.size(), size);
+
+    buffer.assign(3, 0xFF);
+    bufferSer.Serialize(tc, buffer);
+    ASSERT_EQ(size + 3, buffer.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin() + 3));
+
+    std::vector<uint8_t> raw(size);
+    ASSERT_EQ(size, bufferSer.Serialize(tc, raw.data()));
+    ASSERT_EQ(expected, raw);
+  }
+}
+
+TEST(TestCaseDeserializer, ZeroCopy) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+
+  caf::ObjectPool pool;
+  caf::Random<> rnd;
+  rnd.seed(3);
+  caf::TestCaseGenerator gen { *store, pool, rnd };
+
+  caf::ObjectPool decodePool;
+  caf::TestCaseSerializer ser { };
+  for (int round = 0; round < 1000; ++round) {
+    pool.clear();
+    decodePool.clear();
+
+    // Two consecutive test cases in one buffer.
+    std::vector<uint8_t> data;
+    auto tc1 = gen.GenerateTestCase();
+    ser.Serialize(tc1, data);
+    auto tc1Size = data.size();
+    auto tc2 = gen.GenerateTestCase();
+    ser.Serialize(tc2, data);
+
+    caf::TestCaseDeserializer de { decodePool, data.data(), data.size() };
+    auto decoded1 = de.Deserialize();
+    auto decoded2 = de.Deserialize();
+
+    std::vector<uint8_t> redone;
+    ser.Serialize(decoded1, redone);
+    ASSERT_EQ(tc1Size, redone.size());
+    ser.Serialize(decoded2, redone);
+    ASSERT_EQ(data, redone);
+
+    // String values refer to the characters in the buffer.
+    for (const auto& call : decoded1) {
+      for (auto arg : call) {
+        if (arg->IsString() && arg->GetStringValue().length()) {
+          auto p = reinterpret_cast<const uint8_t *>(arg->GetStringValue().data());
+          ASSERT_GE(p, data.data());
+          ASSERT_LT(p, data.data() + data.size());
+        }
+      }
+    }
+  }
+}
+
+TEST(TestCaseValidator, Validate) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+
+  caf::ObjectPool pool;
+  caf::Random<> rnd;
+  rnd.seed(4);
+  caf::TestCaseGenerator gen { *store, pool, rnd };
+
+  caf::TestCaseValidator validator { };
+  for (int round = 0; round < 200; ++round) {
+    pool.clear();
+    auto tc = gen.GenerateTestCase();
+    for (auto version : { caf::TestCaseFormatVersion::V1, caf::TestCaseFormatVersion::V2 }) {
+      auto data = Serialize(tc, version);
+      ASSERT_TRUE(validator.Validate(data.data(), data.size()));
+      ASSERT_EQ(data.size(), validator.GetOffset());
+
+      // Every proper prefix is truncated.
+      for (size_t size = 0; size < data.size(); ++size) {
+        ASSERT_FALSE(validator.Validate(data.data(), size));
+      }
+    }
+  }
+
+  // Unknown value kind in the `this` value of the first call.
+  std::vector<uint8_t> badKind { 'C', 'A', 'F', 2, 0, 1, 0, 0x09, 0, 0 };
+  ASSERT_FALSE(validator.Validate(badKind.data(), badKind.size()));
+  ASSERT_EQ(caf::TestCaseValidationError::BadValueKind, validator.GetError());
+
+  // Placeholder referring to the return value of the call itself.
+  std::vector<uint8_t> badIndex { 'C', 'A', 'F', 2, 0, 1, 0, 0x08, 0, 0, 0 };
+  ASSERT_FALSE(validator.Validate(badIndex.data(), badIndex.size()));
+  ASSERT_EQ(caf::TestCaseValidationError::BadPlaceholderIndex, validator.GetError());
+
+  // Placeholder inside an array referring to the array itself.
+  std::vector<uint8_t> selfRef { 'C', 'A', 'F', 2, 0, 1, 0, 0x07, 1, 0x08, 0, 0, 0 };
+  ASSERT_FALSE(validator.Validate(selfRef.data(), selfRef.size()));
+  ASSERT_EQ(caf::TestCaseValidationError::BadPlaceholderIndex, validator.GetError());
+
+  // Placeholder inside a nested array referring to the outer array.
+  std::vector<uint8_t> outerRef { 'C', 'A', 'F', 2, 0, 1, 0, 0x07, 1, 0x07, 1, 0x08, 0, 0, 0 };
+  ASSERT_FALSE(validator.Validate(outerRef.data(), outerRef.size()));
+  ASSERT_EQ(caf::TestCaseValidationError::BadPlaceholderIndex, validator.GetError());
+
+  // Placeholder inside an array referring to a completed sibling array is fine.
+  std::vector<uint8_t> siblingRef {
+    'C', 'A', 'F', 2, 0, 1, 0, 0x07, 2, 0x07, 0, 0x08, 1, 0, 0 };
+  ASSERT_TRUE(validator.Validate(siblingRef.data(), siblingRef.size()));
+
+  // Arrays nested too deeply.
+  std::vector<uint8_t> deep { 'C', 'A', 'F', 2, 0, 1, 0 };
+  for (size_t i = 0; i <= caf::TestCaseValidator::DefaultMaxDepth; ++i) {
+    deep.push_back(0x07);
+    deep.push_back(1);
+  }
+  deep.push_back(0x00);
+  deep.push_back(0);
+  deep.push_back(0);
+  ASSERT_FALSE(validator.Validate(deep.data(), deep.size()));
+  ASSERT_EQ(caf::TestCaseValidationError::TooDeep, validator.GetError());
+}
+
+TEST(TestCaseValidator, CorruptedInputs) {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+
+  caf::ObjectPool pool;
+  caf::Random<> rnd;
+  rnd.seed(5);
+  caf::TestCaseGenerator gen { *store, pool, rnd };
+
+  caf::ObjectPool decodePool;
+  for (int round = 0; round < 10000; ++round) {
+    pool.clear();
+    decodePool.clear();
+    auto tc = gen.GenerateTestCase();
+    auto data = Serialize(tc, round % 2 ? caf::TestCaseFormatVersion::V1
+                                        : caf::TestCaseFormatVersion::V2);
+
+    auto flips = rnd.Next<int>(1, 4);
+    while (flips--) {
+      data[rnd.Index(data)] ^= static_cast<uint8_t>(rnd.Next<int>(1, 255));
+    }
+
+    // Accepted inputs must deserialize without reading out of bounds.
+    caf::TestCaseDeserializer de { decodePool, data.data(), data.size() };
+    caf::TestCase decoded;
+    if (de.TryDeserialize(decoded)) {
+      ASSERT_EQ(caf::TestCaseValidationError::None, de.GetError());
+    } else {
+      ASSERT_NE(caf::TestCaseValidationError::None, de.GetError());
+    }
+  }
+}
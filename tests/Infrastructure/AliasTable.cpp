@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/AliasTable.h"
+#include "Infrastructure/Random.h"
+
+#include <cstddef>
+#include <vector>
+
+TEST(AliasTable, Empty) {
+  caf::AliasTable table { };
+  ASSERT_TRUE(table.empty());
+  ASSERT_EQ(0, table.size());
+}
+
+TEST(AliasTable, ZeroWeightNeverSampled) {
+  caf::AliasTable table { std::vector<double> { 1, 0, 3, 0 } };
+  ASSERT_EQ(4, table.size());
+
+  caf::Random<> rnd;
+  for (int round = 0; round < 100000; ++round) {
+    auto index = table.Sample(rnd);
+    ASSERT_TRUE(index == 0 || index == 2);
+  }
+}
+
+TEST(AliasTable, AllZeroWeightsSampleUniformly) {
+  caf::AliasTable table { std::vector<double> { 0, 0, 0 } };
+
+  caf::Random<> rnd;
+  std::vector<size_t> counts(3);
+  for (int round = 0; round < 300000; ++round) {
+    ++counts[table.Sample(rnd)];
+  }
+  for (auto c : counts) {
+    ASSERT_NEAR(100000, c, 3000);
+  }
+}
+
+TEST(AliasTable, Distribution) {
+  std::vector<double> weights { 1, 2, 3, 4 };
+  caf::AliasTable table { weights };
+
+  caf::Random<> rnd;
+  std::vector<size_t> counts(weights.size());
+  constexpr const int Rounds = 1000000;
+  for (int round = 0; round < Rounds; ++round) {
+    ++counts[table.Sample(rnd)];
+  }
+  for (size_t i = 0; i < weights.size(); ++i) {
+    ASSERT_NEAR(weights[i] / 10.0, static_cast<double>(counts[i]) / Rounds, 0.005);
+  }
+}
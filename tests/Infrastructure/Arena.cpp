@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+TEST(Arena, Allocate) {
+  caf::Arena arena { 64 };
+  auto p1 = arena.Create<uint64_t>(1);
+  auto p2 = arena.Create<uint64_t>(2);
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(p1) % alignof(uint64_t));
+  ASSERT_EQ(0, reinterpret_cast<uintptr_t>(p2) % alignof(uint64_t));
+  ASSERT_EQ(1, *p1);
+  ASSERT_EQ(2, *p2);
+
+  // Allocations larger than the chunk size.
+  auto big = arena.AllocateArray<uint8_t>(1000);
+  std::memset(big, 0xff, 1000);
+  ASSERT_EQ(1, *p1);
+  ASSERT_EQ(2, *p2);
+
+  auto s = arena.CopyString("abc", 3);
+  ASSERT_STREQ("abc", s);
+}
+
+TEST(Arena, Reset) {
+  caf::Arena arena { 64 };
+  for (int i = 0; i < 1000; ++i) {
+    arena.Create<uint64_t>(i);
+  }
+  ASSERT_GE(arena.GetBytesAllocated(), 1000 * sizeof(uint64_t));
+  auto reserved = arena.GetBytesReserved();
+
+  arena.reset();
+  ASSERT_EQ(0, arena.GetBytesAllocated());
+  ASSERT_LT(arena.GetBytesReserved(), reserved);
+
+  // Repeated cycles of the same workload do not grow the reserved memory without bound.
+  for (int i = 0; i < 1000; ++i) {
+    arena.Create<uint64_t>(i);
+  }
+  arena.reset();
+  reserved = arena.GetBytesReserved();
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      arena.Create<uint64_t>(i);
+    }
+    arena.reset();
+    ASSERT_EQ(reserved, arena.GetBytesReserved());
+  }
+}
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/BloomFilter.h"
+
+#include <cstdint>
+
+namespace {
+
+uint64_t MakeHash(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+} // namespace <anonymous>
+
+TEST(BloomFilter, InsertAndLookup) {
+  caf::BloomFilter filter { 1 << 16, 4, 1000 };
+  for (uint64_t i = 0; i < 1000; ++i) {
+    filter.Insert(MakeHash(i));
+  }
+  for (uint64_t i = 0; i < 1000; ++i) {
+    ASSERT_TRUE(filter.MayContain(MakeHash(i)));
+  }
+
+  size_t falsePositives = 0;
+  for (uint64_t i = 1000; i < 11000; ++i) {
+    falsePositives += filter.MayContain(MakeHash(i));
+  }
+  ASSERT_LT(falsePositives, 100);
+
+  filter.clear();
+  ASSERT_FALSE(filter.MayContain(MakeHash(0)));
+}
+
+TEST(BloomFilter, Generations) {
+  caf::BloomFilter filter { 1 << 16, 4, 100 };
+  for (uint64_t i = 0; i < 300; ++i) {
+    filter.Insert(MakeHash(i));
+  }
+
+  // The last 100 to 200 values are remembered; older generations are forgotten.
+  for (uint64_t i = 200; i < 300; ++i) {
+    ASSERT_TRUE(filter.MayContain(MakeHash(i)));
+  }
+  size_t remembered = 0;
+  for (uint64_t i = 0; i < 100; ++i) {
+    remembered += filter.MayContain(MakeHash(i));
+  }
+  ASSERT_LT(remembered, 5);
+}
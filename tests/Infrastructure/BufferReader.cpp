@@ -0,0 +1,33 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/BufferReader.h"
+
+#include <cstdint>
+#include <vector>
+
+TEST(BufferReader, Read) {
+  std::vector<uint8_t> data { 1, 0x78, 0x56, 0x34, 0x12, 'a', 'b', 'c' };
+  caf::BufferReader reader { data.data(), data.size() };
+
+  ASSERT_EQ(1, reader.ReadByte());
+  ASSERT_EQ(0x12345678, reader.ReadUnaligned<uint32_t>());
+
+  auto s = reader.ReadBytes(3);
+  ASSERT_EQ(data.data() + 5, s);
+  ASSERT_EQ(3, reader.GetLastReadSize());
+  ASSERT_EQ(0, reader.remaining());
+  ASSERT_FALSE(reader.fail());
+}
+
+TEST(BufferReader, ReadPastEnd) {
+  std::vector<uint8_t> data { 1, 2, 3 };
+  caf::BufferReader reader { data.data(), data.size() };
+
+  ASSERT_EQ(0x00030201, reader.ReadUnaligned<uint32_t>());
+  ASSERT_TRUE(reader.fail());
+  ASSERT_EQ(0, reader.ReadByte());
+
+  caf::BufferReader other { data.data(), data.size() };
+  other.ReadBytes(5);
+  ASSERT_EQ(3, other.GetLastReadSize());
+  ASSERT_TRUE(other.fail());
+}
@@ -0,0 +1,43 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Stream.h"
+#include "Infrastructure/Varint.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+TEST(Varint, RoundTrip) {
+  std::vector<uint64_t> values {
+    0, 1, 127, 128, 255, 300, 16383, 16384, 0xFFFFFFFF, std::numeric_limits<uint64_t>::max() };
+
+  std::vector<uint8_t> buffer;
+  caf::MemoryOutputStream out { buffer };
+  size_t expectedSize = 0;
+  for (auto value : values) {
+    caf::WriteVarint(out, value);
+    expectedSize += caf::GetVarintSize(value);
+  }
+  ASSERT_EQ(expectedSize, buffer.size());
+  ASSERT_EQ(1, caf::GetVarintSize(127));
+  ASSERT_EQ(2, caf::GetVarintSize(128));
+  ASSERT_EQ(caf::MaxVarintSize, caf::GetVarintSize(std::numeric_limits<uint64_t>::max()));
+
+  caf::MemoryInputStream in { buffer.data(), buffer.size() };
+  for (auto value : values) {
+    ASSERT_EQ(value, caf::ReadVarint(in));
+  }
+}
+
+TEST(Varint, ZigZag) {
+  ASSERT_EQ(0, caf::ZigZagEncode(0));
+  ASSERT_EQ(1, caf::ZigZagEncode(-1));
+  ASSERT_EQ(2, caf::ZigZagEncode(1));
+  ASSERT_EQ(3, caf::ZigZagEncode(-2));
+
+  std::vector<int64_t> values {
+    0, 1, -1, 63, -64, 64, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max(),
+    std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max() };
+  for (auto value : values) {
+    ASSERT_EQ(value, caf::ZigZagDecode(caf::ZigZagEncode(value)));
+  }
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include "Infrastructure/Memory.h"
+#include "Infrastructure/Optional.h"
+#include "Basic/CAFStore.h"
+#include "Basic/Function.h"
+#include "Targets/Common/FunctionDatabase.h"
+#include "Targets/Common/PropertyResolver.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct MockTraits {
+  using ValueType = int;
+}; // struct MockTraits
+
+/**
+ * @brief Resolve properties from a fixed table and count the resolutions.
+ *
+ */
+class MockResolver : public caf::PropertyResolver<MockTraits> {
+public:
+  constexpr static const int Global = 0;
+
+  explicit MockResolver()
+    : _props {
+        { { Global, "func" }, 1 },
+        { { Global, "mod" }, 2 },
+        { { 2, "f" }, 3 },
+        { { 2, "g" }, 4 },
+      },
+      _resolveCount()
+  { }
+
+  caf::Optional<int> Resolve(int value, const std::string& name) override {
+    ++_resolveCount[name];
+    auto i = _props.find(std::make_pair(value, name));
+    if (i == _props.end()) {
+      return caf::Optional<int> { };
+    }
+    return caf::Optional<int> { i->second };
+  }
+
+  size_t GetResolveCount(const std::string& name) const {
+    auto i = _resolveCount.find(name);
+    return i == _resolveCount.end() ? 0 : i->second;
+  }
+
+private:
+  std::map<std::pair<int, std::string>, int> _props;
+  std::map<std::string, size_t> _resolveCount;
+}; // class MockResolver
+
+constexpr const int MockResolver::Global;
+
+std::unique_ptr<caf::CAFStore> CreateMockStore() {
+  auto store = caf::make_unique<caf::CAFStore>();
+  store->AddFunction(caf::Function { 0, "func" });
+  store->AddFunction(caf::Function { 1, "mod.f" });
+  store->AddFunction(caf::Function { 2, "mod.g" });
+  return store;
+}
+
+} // namespace <anonymous>
+
+TEST(FunctionDatabase, Eager) {
+  auto store = CreateMockStore();
+  MockResolver resolver { };
+  caf::FunctionDatabase<MockTraits> funcs { resolver, MockResolver::Global };
+  funcs.Populate(*store);
+
+  ASSERT_EQ(caf::FunctionResolution::Eager, funcs.resolution());
+  ASSERT_EQ(1, resolver.GetResolveCount("func"));
+  ASSERT_EQ(1, resolver.GetResolveCount("mod"));
+  ASSERT_EQ(1, resolver.GetResolveCount("f"));
+  ASSERT_EQ(1, resolver.GetResolveCount("g"));
+  ASSERT_EQ(1, funcs.GetFunction(0).value());
+  ASSERT_EQ(3, funcs.GetFunction(1).value());
+  ASSERT_EQ(4, funcs.GetFunction(2).value());
+  ASSERT_FALSE(funcs.GetFunction(3).hasValue());
+}
+
+TEST(FunctionDatabase, Lazy) {
+  auto store = CreateMockStore();
+  MockResolver resolver { };
+  caf::FunctionDatabase<MockTraits> funcs { resolver, MockResolver::Global };
+  funcs.Populate(*store, caf::FunctionResolution::Lazy);
+
+  ASSERT_EQ(caf::FunctionResolution::Lazy, funcs.resolution());
+  ASSERT_TRUE(funcs.HasFunction(1));
+  ASSERT_EQ(0, resolver.GetResolveCount("mod"));
+
+  // The first request resolves the function, later requests are memoized.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(3, funcs.GetFunction(1).value());
+  }
+  ASSERT_EQ(1, resolver.GetResolveCount("mod"));
+  ASSERT_EQ(1, resolver.GetResolveCount("f"));
+  ASSERT_EQ(0, resolver.GetResolveCount("g"));
+
+  // The resolution of the common prefix is shared.
+  ASSERT_EQ(4, funcs.GetFunction(2).value());
+  ASSERT_EQ(1, resolver.GetResolveCount("mod"));
+  ASSERT_EQ(1, resolver.GetResolveCount("g"));
+  ASSERT_EQ(0, resolver.GetResolveCount("func"));
+}
+
+TEST(FunctionDatabase, Prefetch) {
+  auto store = CreateMockStore();
+  MockResolver resolver { };
+  caf::FunctionDatabase<MockTraits> funcs { resolver, MockResolver::Global };
+  funcs.Populate(*store, caf::FunctionResolution::Prefetch);
+
+  // Unknown and duplicate IDs are ignored.
+  funcs.Prefetch(std::vector<uint32_t> { 2, 100, 2, 2, UINT32_MAX });
+  ASSERT_EQ(1, resolver.GetResolveCount("g"));
+  ASSERT_EQ(0, resolver.GetResolveCount("f"));
+  ASSERT_EQ(0, resolver.GetResolveCount("func"));
+
+  ASSERT_EQ(4, funcs.GetFunction(2).value());
+  ASSERT_EQ(1, resolver.GetResolveCount("g"));
+}
+
+TEST(FunctionDatabase, HasFunction) {
+  MockResolver resolver { };
+  caf::FunctionDatabase<MockTraits> funcs { resolver, MockResolver::Global };
+  funcs.AddFunction(0, "func");
+  funcs.DeclareFunction(3, "mod.f");
+
+  ASSERT_TRUE(funcs.HasFunction(0));
+  ASSERT_TRUE(funcs.HasFunction(3));
+  // IDs below the largest declared ID that were never declared.
+  ASSERT_FALSE(funcs.HasFunction(1));
+  ASSERT_FALSE(funcs.HasFunction(2));
+  ASSERT_FALSE(funcs.GetFunction(2).hasValue());
+  // IDs beyond the table.
+  ASSERT_FALSE(funcs.HasFunction(4));
+  ASSERT_FALSE(funcs.HasFunction(UINT32_MAX));
+  ASSERT_FALSE(funcs.GetFunction(UINT32_MAX).hasValue());
+}
+
+TEST(FunctionDatabase, Freeze) {
+  auto store = CreateMockStore();
+  MockResolver resolver { };
+  caf::FunctionDatabase<MockTraits> funcs { resolver, MockResolver::Global };
+  funcs.Populate(*store, caf::FunctionResolution::Lazy);
+
+  ASSERT_EQ(1, funcs.GetFunction(0).value());
+  funcs.Freeze();
+
+  // The leftovers are resolved, and the function resolved before is not resolved again.
+  ASSERT_EQ(1, resolver.GetResolveCount("func"));
+  ASSERT_EQ(1, resolver.GetResolveCount("f"));
+  ASSERT_EQ(1, resolver.GetResolveCount("g"));
+  ASSERT_EQ(1, funcs.GetFunction(0).value());
+  ASSERT_EQ(3, funcs.GetFunction(1).value());
+  ASSERT_EQ(4, funcs.GetFunction(2).value());
+  ASSERT_EQ(1, resolver.GetResolveCount("mod"));
+}
@@ -0,0 +1,80 @@
+#ifndef CAF_TESTS_TEMPORARY_FILE_H
+#define CAF_TESTS_TEMPORARY_FILE_H
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace caf {
+
+namespace test {
+
+/**
+ * @brief An empty file under `/tmp` with a unique name, which is removed when the object is
+ * destroyed.
+ *
+ */
+class TemporaryFile {
+public:
+  /**
+   * @brief Create a new temporary file.
+   *
+   * @param prefix prefix of the file name.
+   */
+  explicit TemporaryFile(const char* prefix = "caf")
+    : _path(std::string { "/tmp/" } + prefix + "_XXXXXX")
+  {
+    auto fd = mkstemp(&_path[0]);
+    EXPECT_NE(fd, -1);
+    if (fd != -1) {
+      close(fd);
+    }
+  }
+
+  TemporaryFile(const TemporaryFile &) = delete;
+  TemporaryFile(TemporaryFile &&) = delete;
+
+  TemporaryFile& operator=(const TemporaryFile &) = delete;
+  TemporaryFile& operator=(TemporaryFile &&) = delete;
+
+  ~TemporaryFile() {
+    unlink(_path.c_str());
+  }
+
+  /**
+   * @brief Get the path to the file.
+   *
+   * @return const char* the path.
+   */
+  const char* path() const { return _path.c_str(); }
+
+  /**
+   * @brief Write the given data to the file.
+   *
+   * @param data the data to write.
+   * @param mode the mode passed to `fopen`; use "ab" to append.
+   */
+  void Write(const std::vector<uint8_t>& data, const char* mode = "wb") const {
+    auto file = std::fopen(_path.c_str(), mode);
+    ASSERT_NE(file, nullptr);
+    if (!data.empty()) {
+      std::fwrite(data.data(), 1, data.size(), file);
+    }
+    std::fclose(file);
+  }
+
+private:
+  std::string _path;
+}; // class TemporaryFile
+
+} // namespace test
+
+} // namespace caf
+
+#endif